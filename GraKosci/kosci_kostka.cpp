@@ -0,0 +1,85 @@
+#include "kosci_kostka.h"
+#include <QPainter>
+#include <QPainterPath>
+#include "startup_profile.h"
+
+QHash<quint64, QPixmap>& KosciObrazki::pamiec()
+{
+    static QHash<quint64, QPixmap> p;
+    return p;
+}
+
+const QPixmap& KosciObrazki::scianka(int oczka, bool zablokowana, qreal dpr)
+{
+    if (oczka < 1 || oczka > 6) oczka = 1;
+
+    // Klucz: oczka, blokada i DPR w setnych czesciach.
+    quint64 klucz = (quint64)qRound(dpr * 100) << 8 | (quint64)(zablokowana ? 8 : 0) | (quint64)oczka;
+
+    auto& p = pamiec();
+    auto it = p.find(klucz);
+    if (it == p.end()) it = p.insert(klucz, renderuj(oczka, zablokowana, dpr));
+    return it.value();
+}
+
+QPixmap KosciObrazki::renderuj(int oczka, bool zablokowana, qreal dpr)
+{
+    QPixmap pm(QSize(ROZMIAR, ROZMIAR) * dpr);
+    pm.setDevicePixelRatio(dpr);
+    pm.fill(Qt::transparent);
+
+    QPainter p(&pm);
+    p.setRenderHint(QPainter::Antialiasing);
+    p.setRenderHint(QPainter::SmoothPixmapTransform);
+
+    // Te same kolory co dawny arkusz stylu kostek.
+    const qreal ramka = zablokowana ? 3.0 : 2.0;
+    QRectF r(ramka / 2, ramka / 2, ROZMIAR - ramka, ROZMIAR - ramka);
+    p.setPen(QPen(zablokowana ? QColor("#4CAF50") : QColor("#555"), ramka));
+    p.setBrush(zablokowana ? QColor("#dcedc8") : QColor(Qt::white));
+    p.drawRoundedRect(r, 10, 10);
+
+    StartupStage etap("KosciObrazki: zasoby.qrc");
+    QPixmap obraz(QString(":/kosci/d%1.png").arg(oczka));
+    const QRectF cel((ROZMIAR - 64) / 2.0, (ROZMIAR - 64) / 2.0, 64, 64);
+    if (!obraz.isNull())
+    {
+        p.drawPixmap(cel, obraz, obraz.rect());
+    }
+    else
+    {
+        QFont f = p.font();
+        f.setPixelSize(24);
+        f.setBold(true);
+        p.setFont(f);
+        p.setPen(Qt::black);
+        p.drawText(cel, Qt::AlignCenter, QString::number(oczka));
+    }
+
+    return pm;
+}
+
+KostkaWidget::KostkaWidget(QWidget* parent) : QAbstractButton(parent)
+{
+    setFixedSize(KosciObrazki::ROZMIAR, KosciObrazki::ROZMIAR);
+    setCursor(Qt::PointingHandCursor);
+}
+
+QSize KostkaWidget::sizeHint() const
+{
+    return QSize(KosciObrazki::ROZMIAR, KosciObrazki::ROZMIAR);
+}
+
+void KostkaWidget::ustaw(int oczka, bool zablokowana)
+{
+    if (oczka == m_oczka && zablokowana == m_zablokowana) return;
+    m_oczka = oczka;
+    m_zablokowana = zablokowana;
+    update();
+}
+
+void KostkaWidget::paintEvent(QPaintEvent*)
+{
+    QPainter p(this);
+    p.drawPixmap(0, 0, KosciObrazki::scianka(m_oczka, m_zablokowana, devicePixelRatioF()));
+}
@@ -0,0 +1,45 @@
+#ifndef KOSCI_KOSTKA_H
+#define KOSCI_KOSTKA_H
+
+#pragma once
+#include <QAbstractButton>
+#include <QPixmap>
+#include <QHash>
+
+// Gotowe obrazy scianek (6 oczek x zwykla/zablokowana) dla danego DPR, renderowane raz
+// przy pierwszym uzyciu - zimny start rysuje tylko widoczne scianki.
+class KosciObrazki
+{
+public:
+    static constexpr int ROZMIAR = 86;
+
+    static const QPixmap& scianka(int oczka, bool zablokowana, qreal dpr);
+
+private:
+    static QPixmap renderuj(int oczka, bool zablokowana, qreal dpr);
+    static QHash<quint64, QPixmap>& pamiec();
+};
+
+// Kostka bez arkusza stylu: zmiana wartosci to tylko podmiana gotowego obrazu.
+class KostkaWidget : public QAbstractButton
+{
+    Q_OBJECT
+
+public:
+    explicit KostkaWidget(QWidget* parent = nullptr);
+
+    void ustaw(int oczka, bool zablokowana);
+    int oczka() const { return m_oczka; }
+    bool zablokowana() const { return m_zablokowana; }
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+private:
+    int m_oczka = 1;
+    bool m_zablokowana = false;
+};
+
+#endif // KOSCI_KOSTKA_H
@@ -1,358 +1,526 @@
-#include "kosci_logic.h"
-#include <QRandomGenerator>
-#include <QJsonArray>
-#include <map>
-#include <set>
-#include <algorithm>
-
-KosciLogic::KosciLogic(QObject* parent) : QObject(parent)
-{
-    m_botTimer.setSingleShot(true);
-    connect(&m_botTimer, &QTimer::timeout, this, &KosciLogic::botRuch);
-    connect(&m_siec, &SiecManager::wiadomoscOdebrana, this, &KosciLogic::sieciowyPakiet);
-    connect(&m_siec, &SiecManager::log, this, &KosciLogic::komunikat);
-}
-
-int KosciLogic::obliczPunkty(Kategoria k, const std::array<int,5>& d) const
-{
-    std::map<int,int> m; int sum=0;
-    for(int v:d){ m[v]++; sum+=v; }
-
-    auto has = [&](std::initializer_list<int> s)
-    {
-        std::set<int> set(d.begin(), d.end());
-        for(int x:s) if(!set.count(x)) return false; return true;
-    };
-
-    switch(k)
-    {
-    case Kategoria::Jedynki: return m[1]*1;
-    case Kategoria::Dwojki: return m[2]*2;
-    case Kategoria::Trojki: return m[3]*3;
-    case Kategoria::Czworki: return m[4]*4;
-    case Kategoria::Piatki: return m[5]*5;
-    case Kategoria::Szostki: return m[6]*6;
-    case Kategoria::Trojka: for(auto p:m) if(p.second>=3) return sum; return 0;
-    case Kategoria::Czworka: for(auto p:m) if(p.second>=4) return sum; return 0;
-    case Kategoria::Full: { bool t=0,d=0; for(auto p:m){if(p.second==3)t=1;if(p.second==2)d=1;} return (t&&d)?25:0; }
-    case Kategoria::MalyStrit: return (has({1,2,3,4})||has({2,3,4,5})||has({3,4,5,6}))?30:0;
-    case Kategoria::DuzyStrit: return (has({1,2,3,4,5})||has({2,3,4,5,6}))?40:0;
-    case Kategoria::Yahtzee: for(auto p:m) if(p.second==5) return 50; return 0;
-    case Kategoria::Szansa: return sum;
-    }
-    return 0;
-}
-
-void KosciLogic::startLokalnie(QString g1, QString g2)
-{
-    m_tryb = TrybGry::LOKALNY;
-    m_gracze = {{g1,{},{}}, {g2,{},{}}};
-    m_typy = {TypGracza::CZLOWIEK, TypGracza::CZLOWIEK};
-    m_aktywnyID=0; m_nrRzutu=0;
-    emit zmianaStanu();
-}
-
-void KosciLogic::startBot(QString g1)
-{
-    startLokalnie(g1, "Bot Stefan");
-    m_tryb = TrybGry::SOLO_BOT;
-    m_typy[1] = TypGracza::BOT;
-}
-
-void KosciLogic::startHost(QString g1)
-{
-    m_tryb = TrybGry::HOST;
-    m_siec.startSerwer(PORT_GRY);
-    m_gracze = {{g1,{},{}}};
-    m_typy = {TypGracza::CZLOWIEK};
-    emit komunikat("Serwer OK. Czekam...");
-}
-
-void KosciLogic::startKlient(QString ip, QString g1)
-{
-    m_tryb = TrybGry::KLIENT;
-    m_siec.startKlient(ip, PORT_GRY);
-    m_gracze = {{g1,{},{}}};
-
-    connect(&m_siec, &SiecManager::polaczono, this, [=](){
-        QJsonObject j; j["n"]=g1;
-        QJsonObject p; p[JsonK::TYP]=JsonK::START; p[JsonK::DANE]=j;
-        m_siec.wyslijDoHosta(p);
-    });
-}
-
-void KosciLogic::rzuc()
-{
-    if(czyWszyscySkonczyli()) return;
-    if(!czyMojaTura()) return;
-    if(m_tryb==TrybGry::KLIENT)
-    {
-        QJsonObject p; p[JsonK::TYP]=JsonK::RZUT;
-        m_siec.wyslijDoHosta(p);
-    }
-    else
-    {
-        przetworzAkcje(m_aktywnyID, JsonK::RZUT, {});
-    }
-}
-void KosciLogic::przelaczBlokade(int idx)
-{
-    if(czyWszyscySkonczyli()) return;
-    if(!czyMojaTura() || m_nrRzutu==0) return;
-    QJsonObject d; d["i"]=idx;
-    if(m_tryb==TrybGry::KLIENT)
-    {
-        QJsonObject p; p[JsonK::TYP]=JsonK::BLOKADA; p[JsonK::DANE]=d;
-        m_siec.wyslijDoHosta(p);
-    }
-    else
-    {
-        przetworzAkcje(m_aktywnyID, JsonK::BLOKADA, d);
-    }
-}
-void KosciLogic::wybierz(Kategoria k)
-{
-    if(czyWszyscySkonczyli()) return;
-    if(!czyMojaTura() || m_nrRzutu==0) return;
-    QJsonObject d; d["k"]=(int)k;
-    if(m_tryb==TrybGry::KLIENT)
-    {
-        QJsonObject p; p[JsonK::TYP]=JsonK::WYBOR; p[JsonK::DANE]=d;
-        m_siec.wyslijDoHosta(p);
-    }
-    else
-    {
-        przetworzAkcje(m_aktywnyID, JsonK::WYBOR, d);
-    }
-}
-
-void KosciLogic::przetworzAkcje(int id, QString typ, QJsonObject d)
-{
-    if(id != m_aktywnyID) return;
-
-    if(typ == JsonK::RZUT && m_nrRzutu < MAX_RZUTOW)
-    {
-        wykonajRzutLogika();
-        m_nrRzutu++;
-        emit zmianaStanu();
-        if(m_tryb == TrybGry::HOST) wyslijStan();
-    }
-    else if(typ == JsonK::BLOKADA)
-    {
-        int i = d["i"].toInt();
-        if(i>=0 && i<5) m_blokady[i] = !m_blokady[i];
-        emit zmianaStanu();
-        if(m_tryb == TrybGry::HOST) wyslijStan();
-    }
-    else if(typ == JsonK::WYBOR)
-    {
-        Kategoria k = (Kategoria)d["k"].toInt();
-        if(!m_gracze[id].zajete[k])
-        {
-            m_gracze[id].wynik[k] = obliczPunkty(k, m_oczka);
-            m_gracze[id].zajete[k] = true;
-
-            emit zmianaStanu();
-            if(m_tryb == TrybGry::HOST) wyslijStan();
-
-            if(czyWszyscySkonczyli())
-            {
-                sprawdzKoniecGry();
-            }
-            else
-            {
-                nastepny();
-            }
-        }
-    }
-}
-
-void KosciLogic::wykonajRzutLogika()
-{
-    for(int i=0;i<5;i++) if(!m_blokady[i]) m_oczka[i] = QRandomGenerator::global()->bounded(1,7);
-}
-
-void KosciLogic::nastepny()
-{
-    m_aktywnyID = (m_aktywnyID + 1) % m_gracze.size();
-    m_nrRzutu = 0;
-    m_blokady.fill(false);
-
-    emit zmianaStanu();
-    if(m_tryb == TrybGry::HOST) wyslijStan();
-
-    if(m_typy[m_aktywnyID] == TypGracza::BOT)
-    {
-        m_botTimer.start(1000);
-    }
-}
-
-bool KosciLogic::czyWszyscySkonczyli() const
-{
-    if(m_gracze.empty()) return false;
-    for(const auto& g : m_gracze)
-    {
-        if(!g.koniec()) return false;
-    }
-    return true;
-}
-
-void KosciLogic::sprawdzKoniecGry()
-{
-    m_botTimer.stop();
-    int maxPkt = -1;
-    QString zwyciezca = "";
-
-    for(const auto& g : m_gracze)
-    {
-        int total = g.total();
-        if(total > maxPkt)
-        {
-            maxPkt = total;
-            zwyciezca = g.nazwa;
-        }
-        else if (total == maxPkt)
-        {
-            zwyciezca += " & " + g.nazwa;
-        }
-    }
-    emit graZakonczona(zwyciezca, maxPkt);
-}
-
-void KosciLogic::botRuch()
-{
-    if(m_typy[m_aktywnyID] != TypGracza::BOT)
-    {
-        m_botTimer.stop(); return;
-    }
-    if(czyWszyscySkonczyli()) return;
-
-    if(m_nrRzutu < 3)
-    {
-        for(int i=0;i<5;i++)
-        {
-            if(m_oczka[i] >= 4) m_blokady[i] = true;
-        }
-        przetworzAkcje(m_aktywnyID, JsonK::RZUT, {});
-        m_botTimer.start(800);
-    }
-    else
-    {
-        int maxPkt = -1;
-        Kategoria najlepszaKat = Kategoria::Szansa;
-        bool znaleziono = false;
-
-        for(int k=0; k<=12; k++)
-        {
-            Kategoria kat = (Kategoria)k;
-            if(!m_gracze[m_aktywnyID].zajete[kat])
-            {
-                int pkt = obliczPunkty(kat, m_oczka);
-                if (pkt > 0 && (kat == Kategoria::Yahtzee || kat == Kategoria::DuzyStrit))
-                {
-                    pkt += 50;
-                }
-                if(pkt > maxPkt)
-                {
-                    maxPkt = pkt;
-                    najlepszaKat = kat;
-                    znaleziono = true;
-                }
-            }
-        }
-
-        if(!znaleziono || maxPkt == 0)
-        {
-            for(int k=0; k<=12; k++) {
-                if(!m_gracze[m_aktywnyID].zajete[(Kategoria)k])
-                {
-                    najlepszaKat = (Kategoria)k;
-                    break;
-                }
-            }
-        }
-        QJsonObject d; d["k"]=(int)najlepszaKat;
-        przetworzAkcje(m_aktywnyID, JsonK::WYBOR, d);
-    }
-}
-
-bool KosciLogic::czyMojaTura() const
-{
-    if(czyWszyscySkonczyli()) return false;
-    if(m_tryb==TrybGry::LOKALNY || m_tryb==TrybGry::SOLO_BOT) return m_typy[m_aktywnyID]==TypGracza::CZLOWIEK;
-    if(m_tryb==TrybGry::HOST) return m_aktywnyID==0;
-    if(m_tryb==TrybGry::KLIENT) return m_aktywnyID==1;
-    return false;
-}
-
-void KosciLogic::wyslijStan()
-{
-    QJsonObject stan;
-    stan["id"] = m_aktywnyID;
-    stan["nr"] = m_nrRzutu;
-    QJsonArray k; for(int v:m_oczka) k.append(v); stan["k"]=k;
-    QJsonArray b; for(bool v:m_blokady) b.append(v); stan["b"]=b;
-
-    QJsonArray gArr;
-    for(const auto& g : m_gracze)
-    {
-        QJsonObject gObj; gObj["n"]=g.nazwa;
-        QJsonObject res;
-        for(auto key : g.wynik.keys()) res[QString::number((int)key)] = g.wynik[key];
-        gObj["res"]=res;
-        gArr.append(gObj);
-    }
-    stan["g"]=gArr;
-
-    QJsonObject p; p[JsonK::TYP]=JsonK::STAN; p[JsonK::DANE]=stan;
-    m_siec.wyslijDoKlienta(p);
-}
-
-void KosciLogic::sieciowyPakiet(QJsonObject json)
-{
-    QString t = json[JsonK::TYP].toString();
-    QJsonObject d = json[JsonK::DANE].toObject();
-
-    if(m_tryb == TrybGry::HOST)
-    {
-        if(t == JsonK::START)
-        {
-            m_gracze.push_back({d["n"].toString(),{},{}});
-            m_typy.push_back(TypGracza::SIECIOWY);
-            wyslijStan();
-            emit zmianaStanu();
-        }
-        else
-        {
-            przetworzAkcje(1, t, d);
-        }
-    }
-    else if(m_tryb == TrybGry::KLIENT && t == JsonK::STAN)
-    {
-        m_aktywnyID = d["id"].toInt();
-        m_nrRzutu = d["nr"].toInt();
-        QJsonArray k=d["k"].toArray(); for(int i=0;i<5;i++) m_oczka[i]=k[i].toInt();
-        QJsonArray b=d["b"].toArray(); for(int i=0;i<5;i++) m_blokady[i]=b[i].toBool();
-
-        QJsonArray gArr = d["g"].toArray();
-        if(m_gracze.size() != gArr.size())
-        {
-            m_gracze.clear();
-            for(auto _ : gArr) m_gracze.push_back({"",{},{}});
-        }
-        for(int i=0; i<gArr.size(); ++i)
-        {
-            QJsonObject gObj = gArr[i].toObject();
-            m_gracze[i].nazwa = gObj["n"].toString();
-            QJsonObject res = gObj["res"].toObject();
-            for(auto key : res.keys())
-            {
-                Kategoria kat = (Kategoria)key.toInt();
-                m_gracze[i].wynik[kat] = res[key].toInt();
-                m_gracze[i].zajete[kat] = true;
-            }
-        }
-        emit zmianaStanu();
-        if(czyWszyscySkonczyli()) sprawdzKoniecGry();
-    }
-}
+#include "kosci_logic.h"
+#include "game_trace.h"
+#include "game_save.h"
+#include "kosci_optymalizator.h"
+#include <QJsonArray>
+#include <QDataStream>
+#include <algorithm>
+
+KosciLogic::KosciLogic(QObject* parent) : QObject(parent)
+{
+    m_botTimer.setSingleShot(true);
+    connect(&m_botTimer, &QTimer::timeout, this, &KosciLogic::botRuch);
+    connect(&m_siec, &SiecManager::wiadomoscOdebrana, this, &KosciLogic::sieciowyPakiet);
+    connect(&m_siec, &SiecManager::log, this, &KosciLogic::komunikat);
+}
+
+KosciLogic::~KosciLogic()
+{
+    if(m_snapshot && GameSnapshots::instance()) GameSnapshots::instance()->remove(m_snapshot);
+}
+
+int KosciLogic::obliczPunkty(Kategoria k, const std::array<int,5>& d) const
+{
+    const OptymalizatorKosci& opt = OptymalizatorKosci::instancja();
+    int r = opt.indeksRzutu(d);
+    return r < 0 ? 0 : opt.punkty(k, r);
+}
+
+// Bot premiuje Yahtzee i duzego strita - ta sama ocena przy wyborze kategorii i przy planowaniu rzutow.
+static int ocenaBota(Kategoria kat, int pkt)
+{
+    if (pkt > 0 && (kat == Kategoria::Yahtzee || kat == Kategoria::DuzyStrit))
+        return pkt + 50;
+    return pkt;
+}
+
+void KosciLogic::startLokalnie(QString g1, QString g2)
+{
+    m_tryb = TrybGry::LOKALNY;
+    m_rng.reseed(GameRng::randomSeed());
+    m_gracze = {{g1,{},{}}, {g2,{},{}}};
+    m_typy = {TypGracza::CZLOWIEK, TypGracza::CZLOWIEK};
+    m_aktywnyID=0; m_nrRzutu=0;
+    emit zmianaStanu();
+}
+
+void KosciLogic::startBot(QString g1)
+{
+    startLokalnie(g1, "Bot Stefan");
+    m_tryb = TrybGry::SOLO_BOT;
+    m_typy[1] = TypGracza::BOT;
+}
+
+void KosciLogic::startHost(QString g1)
+{
+    m_tryb = TrybGry::HOST;
+    m_rng.reseed(GameRng::randomSeed());
+    m_siec.startSerwer(PORT_GRY);
+    m_gracze = {{g1,{},{}}};
+    m_typy = {TypGracza::CZLOWIEK};
+
+    if(GameSnapshots* snapshoty = GameSnapshots::instance())
+    {
+        m_snapshot = snapshoty->add(QString("kosci_%1").arg(PORT_GRY), [this](){
+            if(m_gracze.size() < 2 || czyWszyscySkonczyli()) return QByteArray();
+            return GameSave::pack(GameType::Kosci, WERSJA_STANU, stanBinarny());
+        });
+    }
+    emit komunikat("Serwer OK. Czekam...");
+}
+
+void KosciLogic::startKlient(QString ip, QString g1)
+{
+    m_tryb = TrybGry::KLIENT;
+    m_siec.startKlient(ip, PORT_GRY);
+    m_gracze = {{g1,{},{}}};
+
+    connect(&m_siec, &SiecManager::polaczono, this, [=](){
+        QJsonObject j; j["n"]=g1;
+        QJsonObject p; p[JsonK::TYP]=JsonK::START; p[JsonK::DANE]=j;
+        m_siec.wyslijDoHosta(p);
+    });
+}
+
+void KosciLogic::rzuc()
+{
+    if(czyWszyscySkonczyli()) return;
+    if(!czyMojaTura()) return;
+    if(m_tryb==TrybGry::KLIENT)
+    {
+        QJsonObject p; p[JsonK::TYP]=JsonK::RZUT;
+        m_siec.wyslijDoHosta(p);
+    }
+    else
+    {
+        przetworzAkcje(m_aktywnyID, JsonK::RZUT, {});
+    }
+}
+void KosciLogic::przelaczBlokade(int idx)
+{
+    if(czyWszyscySkonczyli()) return;
+    if(!czyMojaTura() || m_nrRzutu==0) return;
+    QJsonObject d; d["i"]=idx;
+    if(m_tryb==TrybGry::KLIENT)
+    {
+        QJsonObject p; p[JsonK::TYP]=JsonK::BLOKADA; p[JsonK::DANE]=d;
+        m_siec.wyslijDoHosta(p);
+    }
+    else
+    {
+        przetworzAkcje(m_aktywnyID, JsonK::BLOKADA, d);
+    }
+}
+void KosciLogic::wybierz(Kategoria k)
+{
+    if(czyWszyscySkonczyli()) return;
+    if(!czyMojaTura() || m_nrRzutu==0) return;
+    QJsonObject d; d["k"]=(int)k;
+    if(m_tryb==TrybGry::KLIENT)
+    {
+        QJsonObject p; p[JsonK::TYP]=JsonK::WYBOR; p[JsonK::DANE]=d;
+        m_siec.wyslijDoHosta(p);
+    }
+    else
+    {
+        przetworzAkcje(m_aktywnyID, JsonK::WYBOR, d);
+    }
+}
+
+void KosciLogic::przetworzAkcje(int id, QString typ, QJsonObject d)
+{
+    if(id != m_aktywnyID) return;
+
+    static Histogram& czasTury = MetricsRegistry::instance().histogram(
+        "game_turn_seconds", MetricsRegistry::labels({ { "game", "kosci" } }), "Czas przetworzenia akcji gracza na hoscie.");
+    ScopedTimer pomiar(czasTury);
+
+    if(typ == JsonK::RZUT && m_nrRzutu < MAX_RZUTOW)
+    {
+        wykonajRzutLogika();
+        m_nrRzutu++;
+        emit zmianaStanu();
+        if(m_tryb == TrybGry::HOST) wyslijStan();
+    }
+    else if(typ == JsonK::BLOKADA)
+    {
+        int i = d["i"].toInt();
+        if(i>=0 && i<5) m_blokady[i] = !m_blokady[i];
+        emit zmianaStanu();
+        if(m_tryb == TrybGry::HOST) wyslijStan();
+    }
+    else if(typ == JsonK::WYBOR)
+    {
+        Kategoria k = (Kategoria)d["k"].toInt();
+        if(!m_gracze[id].zajete[k])
+        {
+            m_gracze[id].wynik[k] = obliczPunkty(k, m_oczka);
+            m_gracze[id].zajete[k] = true;
+
+            emit zmianaStanu();
+            if(m_tryb == TrybGry::HOST) wyslijStan();
+
+            if(czyWszyscySkonczyli())
+            {
+                sprawdzKoniecGry();
+            }
+            else
+            {
+                nastepny();
+            }
+        }
+    }
+}
+
+void KosciLogic::wykonajRzutLogika()
+{
+    for(int i=0;i<5;i++) if(!m_blokady[i]) m_oczka[i] = m_rng.bounded(1,7);
+}
+
+void KosciLogic::nastepny()
+{
+    m_aktywnyID = (m_aktywnyID + 1) % m_gracze.size();
+    m_nrRzutu = 0;
+    m_blokady.fill(false);
+
+    emit zmianaStanu();
+    if(m_tryb == TrybGry::HOST) wyslijStan();
+
+    if(m_typy[m_aktywnyID] == TypGracza::BOT)
+    {
+        m_botTimer.start(1000);
+    }
+}
+
+bool KosciLogic::czyWszyscySkonczyli() const
+{
+    if(m_gracze.empty()) return false;
+    for(const auto& g : m_gracze)
+    {
+        if(!g.koniec()) return false;
+    }
+    return true;
+}
+
+void KosciLogic::sprawdzKoniecGry()
+{
+    m_botTimer.stop();
+    int maxPkt = -1;
+    QString zwyciezca = "";
+
+    for(const auto& g : m_gracze)
+    {
+        int total = g.total();
+        if(total > maxPkt)
+        {
+            maxPkt = total;
+            zwyciezca = g.nazwa;
+        }
+        else if (total == maxPkt)
+        {
+            zwyciezca += " & " + g.nazwa;
+        }
+    }
+
+    if(m_tryb == TrybGry::HOST)
+    {
+        QJsonObject d; d["s"] = QString::number(m_rng.seed());
+        QJsonObject p; p[JsonK::TYP]=JsonK::ZIARNO; p[JsonK::DANE]=d;
+        m_siec.wyslijDoKlienta(p);
+    }
+
+    emit graZakonczona(zwyciezca, maxPkt);
+}
+
+void KosciLogic::zweryfikujRzuty(quint64 ziarno)
+{
+    if(m_zobowiazanie.isEmpty()) return;
+
+    bool zgodne = QString::fromLatin1(GameRng::commitment(ziarno)) == m_zobowiazanie;
+
+    GameRng rng(ziarno);
+    for(int v : m_obserwowaneOczka)
+    {
+        if(!zgodne) break;
+        if(rng.bounded(1,7) != v) zgodne = false;
+    }
+
+    emit komunikat(zgodne ? "Rzuty hosta zweryfikowane." : "UWAGA: rzuty hosta nie zgadzaja sie z ziarnem!");
+    m_zobowiazanie.clear();
+    m_obserwowaneOczka.clear();
+}
+
+void KosciLogic::botRuch()
+{
+    if(m_typy[m_aktywnyID] != TypGracza::BOT)
+    {
+        m_botTimer.stop(); return;
+    }
+    if(czyWszyscySkonczyli()) return;
+
+    if(m_nrRzutu < MAX_RZUTOW)
+    {
+        // Pierwszy rzut w turze nie ma czego zatrzymywac; potem maska z indukcji wstecznej.
+        int maska = 0;
+        if(m_nrRzutu > 0)
+        {
+            const OptymalizatorKosci& opt = OptymalizatorKosci::instancja();
+            std::array<bool, 13> wolna;
+            for(int k=0; k<=12; k++) wolna[k] = !m_gracze[m_aktywnyID].zajete[(Kategoria)k];
+
+            std::array<double, OptymalizatorKosci::LICZBA_RZUTOW> ocena;
+            for(int r=0; r<OptymalizatorKosci::LICZBA_RZUTOW; r++)
+            {
+                int best = 0;
+                for(int k=0; k<=12; k++)
+                    if(wolna[k]) best = std::max(best, ocenaBota((Kategoria)k, opt.punkty((Kategoria)k, r)));
+                ocena[r] = best;
+            }
+            maska = opt.najlepszaMaska(m_oczka, MAX_RZUTOW - m_nrRzutu, ocena.data());
+        }
+
+        if(maska != OptymalizatorKosci::LICZBA_MASEK - 1)
+        {
+            for(int i=0;i<5;i++) m_blokady[i] = (maska & (1 << i)) != 0;
+            przetworzAkcje(m_aktywnyID, JsonK::RZUT, {});
+            m_botTimer.start(800);
+            return;
+        }
+    }
+
+    int maxPkt = -1;
+    Kategoria najlepszaKat = Kategoria::Szansa;
+    bool znaleziono = false;
+
+    for(int k=0; k<=12; k++)
+    {
+        Kategoria kat = (Kategoria)k;
+        if(!m_gracze[m_aktywnyID].zajete[kat])
+        {
+            int pkt = ocenaBota(kat, obliczPunkty(kat, m_oczka));
+            if(pkt > maxPkt)
+            {
+                maxPkt = pkt;
+                najlepszaKat = kat;
+                znaleziono = true;
+            }
+        }
+    }
+
+    if(!znaleziono || maxPkt == 0)
+    {
+        for(int k=0; k<=12; k++) {
+            if(!m_gracze[m_aktywnyID].zajete[(Kategoria)k])
+            {
+                najlepszaKat = (Kategoria)k;
+                break;
+            }
+        }
+    }
+    QJsonObject d; d["k"]=(int)najlepszaKat;
+    przetworzAkcje(m_aktywnyID, JsonK::WYBOR, d);
+}
+
+bool KosciLogic::czyMojaTura() const
+{
+    if(czyWszyscySkonczyli()) return false;
+    if(m_tryb==TrybGry::LOKALNY || m_tryb==TrybGry::SOLO_BOT) return m_typy[m_aktywnyID]==TypGracza::CZLOWIEK;
+    if(m_tryb==TrybGry::HOST) return m_aktywnyID==0;
+    if(m_tryb==TrybGry::KLIENT) return m_aktywnyID==1;
+    return false;
+}
+
+void KosciLogic::wyslijStan()
+{
+    QJsonObject stan;
+    stan["id"] = m_aktywnyID;
+    stan["nr"] = m_nrRzutu;
+    QJsonArray k; for(int v:m_oczka) k.append(v); stan["k"]=k;
+    QJsonArray b; for(bool v:m_blokady) b.append(v); stan["b"]=b;
+
+    QJsonArray gArr;
+    for(const auto& g : m_gracze)
+    {
+        QJsonObject gObj; gObj["n"]=g.nazwa;
+        QJsonObject res;
+        for(auto key : g.wynik.keys()) res[QString::number((int)key)] = g.wynik[key];
+        gObj["res"]=res;
+        gArr.append(gObj);
+    }
+    stan["g"]=gArr;
+
+    QJsonObject p; p[JsonK::TYP]=JsonK::STAN; p[JsonK::DANE]=stan;
+    m_siec.wyslijDoKlienta(p);
+}
+
+// Maski kategorii zamiast QMap: klucze i wartosci zajete osobno, zeby odtworzyc mape dokladnie.
+QByteArray KosciLogic::stanBinarny() const
+{
+    QByteArray dane;
+    QDataStream out(&dane, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+
+    quint8 blokady = 0;
+    for(int i=0;i<5;i++) if(m_blokady[i]) blokady |= (1 << i);
+
+    out << (quint8)m_tryb << (quint8)m_gracze.size() << (quint8)m_aktywnyID << (quint8)m_nrRzutu << blokady
+        << (quint64)m_rng.seed() << (quint64)m_rng.state();
+    for(int v : m_oczka) out << (quint8)v;
+
+    for(size_t i=0; i<m_gracze.size(); i++)
+    {
+        const StanGracza& g = m_gracze[i];
+        quint16 klucze = 0, zajete = 0, punktowane = 0;
+        for(auto it = g.zajete.cbegin(); it != g.zajete.cend(); ++it)
+        {
+            klucze |= (1 << (int)it.key());
+            if(it.value()) zajete |= (1 << (int)it.key());
+        }
+        for(auto it = g.wynik.cbegin(); it != g.wynik.cend(); ++it) punktowane |= (1 << (int)it.key());
+
+        out << (quint8)m_typy[i] << g.nazwa.toUtf8() << klucze << zajete << punktowane;
+        for(auto it = g.wynik.cbegin(); it != g.wynik.cend(); ++it) out << (quint8)it.value();
+    }
+    return dane;
+}
+
+bool KosciLogic::ustawStanBinarny(const QByteArray& dane)
+{
+    QDataStream in(dane);
+    in.setByteOrder(QDataStream::LittleEndian);
+
+    quint8 tryb = 0, liczba = 0, aktywny = 0, nrRzutu = 0, blokady = 0;
+    quint64 ziarno = 0, stanRng = 0;
+    in >> tryb >> liczba >> aktywny >> nrRzutu >> blokady >> ziarno >> stanRng;
+    if(in.status() != QDataStream::Ok) return false;
+    if(tryb > (quint8)TrybGry::KLIENT) return false;
+    if(liczba < 1 || liczba > 4 || aktywny >= liczba || nrRzutu > MAX_RZUTOW) return false;
+
+    std::array<int, 5> oczka;
+    for(int i=0;i<5;i++)
+    {
+        quint8 v = 0; in >> v;
+        if(v < 1 || v > 6) return false;
+        oczka[i] = v;
+    }
+
+    std::vector<StanGracza> gracze;
+    std::vector<TypGracza> typy;
+    for(int i=0; i<liczba; i++)
+    {
+        quint8 typ = 0;
+        QByteArray nazwa;
+        quint16 klucze = 0, zajete = 0, punktowane = 0;
+        in >> typ >> nazwa >> klucze >> zajete >> punktowane;
+        if(in.status() != QDataStream::Ok || typ > (quint8)TypGracza::BOT || (klucze | punktowane) >= (1 << 13))
+            return false;
+
+        StanGracza g{QString::fromUtf8(nazwa), {}, {}};
+        for(int k=0; k<=12; k++)
+        {
+            if(klucze & (1 << k)) g.zajete[(Kategoria)k] = (zajete & (1 << k)) != 0;
+            if(punktowane & (1 << k))
+            {
+                quint8 pkt = 0; in >> pkt;
+                g.wynik[(Kategoria)k] = pkt;
+            }
+        }
+        gracze.push_back(g);
+        typy.push_back((TypGracza)typ == TypGracza::SIECIOWY ? TypGracza::CZLOWIEK : (TypGracza)typ);
+    }
+    if(in.status() != QDataStream::Ok) return false;
+
+    m_botTimer.stop();
+    m_tryb = (TrybGry)tryb == TrybGry::SOLO_BOT ? TrybGry::SOLO_BOT : TrybGry::LOKALNY;
+    m_gracze = gracze;
+    m_typy = typy;
+    m_aktywnyID = aktywny;
+    m_nrRzutu = nrRzutu;
+    m_oczka = oczka;
+    for(int i=0;i<5;i++) m_blokady[i] = (blokady & (1 << i)) != 0;
+    m_rng.restore(ziarno, stanRng);
+
+    emit zmianaStanu();
+    if(!czyWszyscySkonczyli() && m_typy[m_aktywnyID] == TypGracza::BOT) m_botTimer.start(1000);
+    return true;
+}
+
+void KosciLogic::sieciowyPakiet(QJsonObject json)
+{
+    GAME_TRACE("KosciLogic::sieciowyPakiet", "gra");
+    QString t = json[JsonK::TYP].toString();
+    QJsonObject d = json[JsonK::DANE].toObject();
+
+    if(m_tryb == TrybGry::HOST)
+    {
+        if(t == JsonK::START)
+        {
+            m_gracze.push_back({d["n"].toString(),{},{}});
+            m_typy.push_back(TypGracza::SIECIOWY);
+
+            // Od dolaczenia rywala rzuty ida z nowego ziarna, ktorego hash dostaje z gory.
+            m_rng.reseed(GameRng::randomSeed());
+            QJsonObject z; z["c"] = QString::fromLatin1(GameRng::commitment(m_rng.seed()));
+            QJsonObject p; p[JsonK::TYP]=JsonK::ZIARNO; p[JsonK::DANE]=z;
+            m_siec.wyslijDoKlienta(p);
+
+            wyslijStan();
+            emit zmianaStanu();
+        }
+        else
+        {
+            przetworzAkcje(1, t, d);
+        }
+    }
+    else if(m_tryb == TrybGry::KLIENT && t == JsonK::ZIARNO)
+    {
+        if(d.contains("c"))
+        {
+            m_zobowiazanie = d["c"].toString();
+            m_obserwowaneOczka.clear();
+            m_czekamNaStanBazowy = true;
+        }
+        else if(d.contains("s"))
+        {
+            zweryfikujRzuty(d["s"].toString().toULongLong());
+        }
+    }
+    else if(m_tryb == TrybGry::KLIENT && t == JsonK::STAN)
+    {
+        int id = d["id"].toInt();
+        int nr = d["nr"].toInt();
+        bool nowyRzut = nr > 0 && (nr > m_nrRzutu || id != m_aktywnyID);
+        if(m_czekamNaStanBazowy) { nowyRzut = false; m_czekamNaStanBazowy = false; }
+
+        m_aktywnyID = id;
+        m_nrRzutu = nr;
+        QJsonArray k=d["k"].toArray(); for(int i=0;i<5;i++) m_oczka[i]=k[i].toInt();
+        QJsonArray b=d["b"].toArray(); for(int i=0;i<5;i++) m_blokady[i]=b[i].toBool();
+
+        if(nowyRzut && !m_zobowiazanie.isEmpty())
+        {
+            for(int i=0;i<5;i++) if(!m_blokady[i]) m_obserwowaneOczka.push_back(m_oczka[i]);
+        }
+
+        QJsonArray gArr = d["g"].toArray();
+        if(m_gracze.size() != gArr.size())
+        {
+            m_gracze.clear();
+            for(auto _ : gArr) m_gracze.push_back({"",{},{}});
+        }
+        for(int i=0; i<gArr.size(); ++i)
+        {
+            QJsonObject gObj = gArr[i].toObject();
+            m_gracze[i].nazwa = gObj["n"].toString();
+            QJsonObject res = gObj["res"].toObject();
+            for(auto key : res.keys())
+            {
+                Kategoria kat = (Kategoria)key.toInt();
+                m_gracze[i].wynik[kat] = res[key].toInt();
+                m_gracze[i].zajete[kat] = true;
+            }
+        }
+        emit zmianaStanu();
+        if(czyWszyscySkonczyli()) sprawdzKoniecGry();
+    }
+}
@@ -1,70 +1,100 @@
-#include "kosci_network.h"
-#include <QJsonDocument>
-
-SiecManager::SiecManager(QObject* parent) : QObject(parent)
-{
-    connect(&m_server, &QTcpServer::newConnection, this, &SiecManager::naNowePolaczenie);
-    connect(&m_socketKlienta, &QTcpSocket::connected, this, &SiecManager::polaczono);
-    connect(&m_socketKlienta, &QTcpSocket::readyRead, this, &SiecManager::naDane);
-    connect(&m_socketKlienta, &QTcpSocket::errorOccurred, this, &SiecManager::naBlad);
-}
-
-bool SiecManager::startSerwer(quint16 port)
-{
-    m_jestemHostem = true;
-    return m_server.listen(QHostAddress::Any, port);
-}
-
-void SiecManager::startKlient(QString ip, quint16 port)
-{
-    m_jestemHostem = false;
-    m_socketKlienta.connectToHost(ip, port);
-}
-
-void SiecManager::wyslij(QTcpSocket* s, QJsonObject json)
-{
-    if(s && s->state() == QAbstractSocket::ConnectedState)
-    {
-        s->write(QJsonDocument(json).toJson(QJsonDocument::Compact) + "\n");
-    }
-}
-
-void SiecManager::wyslijDoHosta(QJsonObject json)
-{
-    wyslij(&m_socketKlienta, json);
-}
-
-void SiecManager::wyslijDoKlienta(QJsonObject json)
-{
-    for(auto* k : m_klienciHosta) wyslij(k, json);
-}
-
-void SiecManager::naNowePolaczenie()
-{
-    while(m_server.hasPendingConnections())
-    {
-        auto* s = m_server.nextPendingConnection();
-        m_klienciHosta.append(s);
-        connect(s, &QTcpSocket::readyRead, this, &SiecManager::naDane);
-        connect(s, &QTcpSocket::disconnected, [this, s](){ m_klienciHosta.removeOne(s); s->deleteLater(); });
-        emit log("Klient dołączył!");
-    }
-}
-
-void SiecManager::naDane()
-{
-    QTcpSocket* s = qobject_cast<QTcpSocket*>(sender());
-    if(!s) return;
-    
-    while(s->canReadLine())
-    {
-        QByteArray line = s->readLine();
-        QJsonDocument doc = QJsonDocument::fromJson(line);
-        if(doc.isObject()) emit wiadomoscOdebrana(doc.object());
-    }
-}
-
-void SiecManager::naBlad(QAbstractSocket::SocketError)
-{
-    emit log("Błąd sieci: " + m_socketKlienta.errorString());
-}
+#include "kosci_network.h"
+#include "game_trace.h"
+#include "kosci_config.h"
+#include <QJsonDocument>
+
+SiecManager::SiecManager(QObject* parent) : QObject(parent)
+{
+    connect(&m_server, &QTcpServer::newConnection, this, &SiecManager::naNowePolaczenie);
+    connect(&m_socketKlienta, &QTcpSocket::connected, this, &SiecManager::polaczono);
+    connect(&m_socketKlienta, &QTcpSocket::readyRead, this, &SiecManager::naDane);
+    connect(&m_socketKlienta, &QTcpSocket::errorOccurred, this, &SiecManager::naBlad);
+
+    MetricsRegistry& r = MetricsRegistry::instance();
+    const QString gra = MetricsRegistry::labels({ { "game", "kosci" } });
+    m_mierniki << r.addGauge("game_rooms_active", gra, [this]{ return m_server.isListening() ? 1.0 : 0.0; });
+    m_mierniki << r.addGauge("game_connections", gra, [this]{ return (double)m_klienciHosta.size(); });
+    m_mierniki << r.addGauge("game_outbound_queue_bytes", gra, [this]{
+        qint64 suma = 0;
+        for(auto* k : m_klienciHosta) suma += k->bytesToWrite();
+        return (double)suma;
+    });
+}
+
+SiecManager::~SiecManager()
+{
+    for(int id : m_mierniki) MetricsRegistry::instance().removeGauge(id);
+}
+
+bool SiecManager::startSerwer(quint16 port)
+{
+    m_jestemHostem = true;
+    return m_server.listen(QHostAddress::Any, port);
+}
+
+void SiecManager::startKlient(QString ip, quint16 port)
+{
+    m_jestemHostem = false;
+    m_socketKlienta.connectToHost(ip, port);
+}
+
+void SiecManager::wyslij(QTcpSocket* s, QJsonObject json)
+{
+    GAME_TRACE("SiecManager::wyslij", "net");
+    if(s && s->state() == QAbstractSocket::ConnectedState)
+    {
+        QByteArray data = QJsonDocument(json).toJson(QJsonDocument::Compact) + "\n";
+        s->write(data);
+        m_wyjscie.count(json.value(JsonK::TYP).toString(), data.size());
+    }
+}
+
+void SiecManager::wyslijDoHosta(QJsonObject json)
+{
+    wyslij(&m_socketKlienta, json);
+}
+
+void SiecManager::wyslijDoKlienta(QJsonObject json)
+{
+    for(auto* k : m_klienciHosta) wyslij(k, json);
+}
+
+void SiecManager::naNowePolaczenie()
+{
+    while(m_server.hasPendingConnections())
+    {
+        auto* s = m_server.nextPendingConnection();
+        m_klienciHosta.append(s);
+        connect(s, &QTcpSocket::readyRead, this, &SiecManager::naDane);
+        connect(s, &QTcpSocket::disconnected, [this, s](){ m_klienciHosta.removeOne(s); s->deleteLater(); });
+        emit log("Klient dołączył!");
+    }
+}
+
+void SiecManager::naDane()
+{
+    GAME_TRACE("SiecManager::naDane", "net");
+    static Counter& bledy = MetricsRegistry::instance().counter(
+        "game_parse_errors_total", MetricsRegistry::labels({ { "game", "kosci" } }));
+
+    QTcpSocket* s = qobject_cast<QTcpSocket*>(sender());
+    if(!s) return;
+    
+    while(s->canReadLine())
+    {
+        QByteArray line = s->readLine();
+        QJsonDocument doc = QJsonDocument::fromJson(line);
+        if(!doc.isObject())
+        {
+            bledy.add();
+            continue;
+        }
+        m_wejscie.count(doc.object().value(JsonK::TYP).toString(), line.size());
+        emit wiadomoscOdebrana(doc.object());
+    }
+}
+
+void SiecManager::naBlad(QAbstractSocket::SocketError)
+{
+    emit log("Błąd sieci: " + m_socketKlienta.errorString());
+}
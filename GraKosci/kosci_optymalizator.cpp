@@ -0,0 +1,262 @@
+#include "kosci_optymalizator.h"
+#include <QtAlgorithms>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <set>
+
+static int kluczRzutu(const std::array<int, 5>& posortowane)
+{
+    int klucz = 0;
+    for (int i = 4; i >= 0; i--) klucz = klucz * 6 + (posortowane[i] - 1);
+    return klucz;
+}
+
+static int kluczZachowania(const int* posortowane, int n)
+{
+    int klucz = 0;
+    for (int i = n - 1; i >= 0; i--) klucz = klucz * 7 + posortowane[i];
+    return klucz;
+}
+
+const OptymalizatorKosci& OptymalizatorKosci::instancja()
+{
+    static const OptymalizatorKosci tabele;
+    return tabele;
+}
+
+int OptymalizatorKosci::punktyDlaRzutu(Kategoria k, const std::array<int, 5>& d)
+{
+    std::map<int,int> m; int sum=0;
+    for(int v:d){ m[v]++; sum+=v; }
+
+    auto has = [&](std::initializer_list<int> s)
+    {
+        std::set<int> set(d.begin(), d.end());
+        for(int x:s) if(!set.count(x)) return false; return true;
+    };
+
+    switch(k)
+    {
+    case Kategoria::Jedynki: return m[1]*1;
+    case Kategoria::Dwojki: return m[2]*2;
+    case Kategoria::Trojki: return m[3]*3;
+    case Kategoria::Czworki: return m[4]*4;
+    case Kategoria::Piatki: return m[5]*5;
+    case Kategoria::Szostki: return m[6]*6;
+    case Kategoria::Trojka: for(auto p:m) if(p.second>=3) return sum; return 0;
+    case Kategoria::Czworka: for(auto p:m) if(p.second>=4) return sum; return 0;
+    case Kategoria::Full: { bool t=0,d=0; for(auto p:m){if(p.second==3)t=1;if(p.second==2)d=1;} return (t&&d)?25:0; }
+    case Kategoria::MalyStrit: return (has({1,2,3,4})||has({2,3,4,5})||has({3,4,5,6}))?30:0;
+    case Kategoria::DuzyStrit: return (has({1,2,3,4,5})||has({2,3,4,5,6}))?40:0;
+    case Kategoria::Yahtzee: for(auto p:m) if(p.second==5) return 50; return 0;
+    case Kategoria::Szansa: return sum;
+    }
+    return 0;
+}
+
+OptymalizatorKosci::OptymalizatorKosci()
+    : m_indeksRzutu(6 * 6 * 6 * 6 * 6, -1),
+      m_indeksZachowania(7 * 7 * 7 * 7 * 7, -1)
+{
+    // 252 posortowane rzuty i punkty kazdej kategorii dla kazdego z nich.
+    int n = 0;
+    for (int a = 1; a <= 6; a++)
+    for (int b = a; b <= 6; b++)
+    for (int c = b; c <= 6; c++)
+    for (int d = c; d <= 6; d++)
+    for (int e = d; e <= 6; e++)
+    {
+        std::array<int, 5> r = { a, b, c, d, e };
+        for (int i = 0; i < 5; i++) m_rzuty[n][i] = (quint8)r[i];
+        m_indeksRzutu[kluczRzutu(r)] = (qint16)n;
+        for (int k = 0; k < LICZBA_KATEGORII; k++) m_punkty[k][n] = (quint8)punktyDlaRzutu((Kategoria)k, r);
+        n++;
+    }
+
+    // 462 zachowane podzbiory (0..5 kosci), kazdy z rozkladem po przerzucie reszty.
+    std::vector<std::vector<int>> zachowania;
+    std::vector<int> biezace;
+    std::function<void(int)> wylicz = [&](int od) {
+        zachowania.push_back(biezace);
+        if (biezace.size() == 5) return;
+        for (int v = od; v <= 6; v++)
+        {
+            biezace.push_back(v);
+            wylicz(v);
+            biezace.pop_back();
+        }
+    };
+    wylicz(1);
+
+    int wpis = 0;
+    for (int z = 0; z < (int)zachowania.size(); z++)
+    {
+        const std::vector<int>& zach = zachowania[z];
+        m_indeksZachowania[kluczZachowania(zach.data(), (int)zach.size())] = (qint16)z;
+        m_poczatekPrzejsc[z] = wpis;
+
+        const int wolne = 5 - (int)zach.size();
+        int wariantow = 1;
+        for (int i = 0; i < wolne; i++) wariantow *= 6;
+
+        std::map<int, int> licznik;
+        for (int w = 0; w < wariantow; w++)
+        {
+            std::array<int, 5> r;
+            int x = w;
+            for (int i = 0; i < (int)zach.size(); i++) r[i] = zach[i];
+            for (int i = (int)zach.size(); i < 5; i++) { r[i] = x % 6 + 1; x /= 6; }
+            std::sort(r.begin(), r.end());
+            licznik[m_indeksRzutu[kluczRzutu(r)]]++;
+        }
+
+        for (const auto& p : licznik)
+        {
+            m_celPrzejscia.push_back((qint16)p.first);
+            m_pPrzejscia.push_back((double)p.second / wariantow);
+            wpis++;
+        }
+    }
+    m_poczatekPrzejsc[LICZBA_ZACHOWAN] = wpis;
+
+    for (int r = 0; r < LICZBA_RZUTOW; r++)
+    {
+        for (int maska = 0; maska < LICZBA_MASEK; maska++)
+        {
+            int zach[5]; int ile = 0;
+            for (int i = 0; i < 5; i++) if (maska & (1 << i)) zach[ile++] = m_rzuty[r][i];
+            m_zachowaniaRzutu[r][maska] = m_indeksZachowania[kluczZachowania(zach, ile)];
+        }
+    }
+
+    policzSzanse();
+}
+
+void OptymalizatorKosci::policzSzanse()
+{
+    m_szansaZachowan.assign(LICZBA_KATEGORII * MAX_RZUTOW * LICZBA_ZACHOWAN, 0.0);
+    m_oczekiwaneZachowan.assign(LICZBA_KATEGORII * MAX_RZUTOW * LICZBA_ZACHOWAN, 0.0);
+
+    std::array<double, LICZBA_RZUTOW> vp, ve;
+    for (int k = 0; k < LICZBA_KATEGORII; k++)
+    {
+        for (int r = 0; r < LICZBA_RZUTOW; r++)
+        {
+            vp[r] = m_punkty[k][r] > 0 ? 1.0 : 0.0;
+            ve[r] = m_punkty[k][r];
+        }
+
+        for (int pozostalo = 1; pozostalo <= MAX_RZUTOW; pozostalo++)
+        {
+            double* ekp = &m_szansaZachowan[(k * MAX_RZUTOW + pozostalo - 1) * LICZBA_ZACHOWAN];
+            double* eke = &m_oczekiwaneZachowan[(k * MAX_RZUTOW + pozostalo - 1) * LICZBA_ZACHOWAN];
+            wartosciZachowan(vp.data(), ekp);
+            wartosciZachowan(ve.data(), eke);
+            najlepszeWartosci(ekp, vp.data());
+            najlepszeWartosci(eke, ve.data());
+        }
+    }
+}
+
+OptymalizatorKosci::Szansa OptymalizatorKosci::szansa(Kategoria k, const std::array<int, 5>& kosci,
+                                                      int maska, int pozostaloRzutow) const
+{
+    Szansa wynik;
+    if (pozostaloRzutow <= 0)
+    {
+        int r = indeksRzutu(kosci);
+        if (r < 0) return wynik;
+        wynik.oczekiwane = punkty(k, r);
+        wynik.prawdopodobienstwo = wynik.oczekiwane > 0 ? 1.0 : 0.0;
+        return wynik;
+    }
+
+    int z = indeksZachowania(kosci, maska);
+    if (z < 0) return wynik;
+
+    int i = ((int)k * MAX_RZUTOW + std::min(pozostaloRzutow, MAX_RZUTOW) - 1) * LICZBA_ZACHOWAN + z;
+    wynik.prawdopodobienstwo = m_szansaZachowan[i];
+    wynik.oczekiwane = m_oczekiwaneZachowan[i];
+    return wynik;
+}
+
+int OptymalizatorKosci::indeksRzutu(const std::array<int, 5>& kosci) const
+{
+    std::array<int, 5> r = kosci;
+    for (int v : r) if (v < 1 || v > 6) return -1;
+    std::sort(r.begin(), r.end());
+    return m_indeksRzutu[kluczRzutu(r)];
+}
+
+int OptymalizatorKosci::indeksZachowania(const std::array<int, 5>& kosci, int maska) const
+{
+    int zach[5]; int ile = 0;
+    for (int i = 0; i < 5; i++)
+    {
+        if (!(maska & (1 << i))) continue;
+        if (kosci[i] < 1 || kosci[i] > 6) return -1;
+        zach[ile++] = kosci[i];
+    }
+    std::sort(zach, zach + ile);
+    return m_indeksZachowania[kluczZachowania(zach, ile)];
+}
+
+void OptymalizatorKosci::wartosciZachowan(const double* v, double* ek) const
+{
+    for (int z = 0; z < LICZBA_ZACHOWAN; z++)
+    {
+        double s = 0.0;
+        for (int i = m_poczatekPrzejsc[z]; i < m_poczatekPrzejsc[z + 1]; i++)
+            s += m_pPrzejscia[i] * v[m_celPrzejscia[i]];
+        ek[z] = s;
+    }
+}
+
+void OptymalizatorKosci::najlepszeWartosci(const double* ek, double* v) const
+{
+    for (int r = 0; r < LICZBA_RZUTOW; r++)
+    {
+        double best = ek[m_zachowaniaRzutu[r][0]];
+        for (int maska = 1; maska < LICZBA_MASEK; maska++)
+            best = std::max(best, ek[m_zachowaniaRzutu[r][maska]]);
+        v[r] = best;
+    }
+}
+
+int OptymalizatorKosci::najlepszaMaska(const std::array<int, 5>& kosci, int pozostaloRzutow,
+                                       const double* ocenaKoncowa, double* wartosc) const
+{
+    const int wszystkie = LICZBA_MASEK - 1;
+    if (pozostaloRzutow <= 0 || indeksRzutu(kosci) < 0)
+    {
+        if (wartosc) *wartosc = indeksRzutu(kosci) < 0 ? 0.0 : ocenaKoncowa[indeksRzutu(kosci)];
+        return wszystkie;
+    }
+
+    // Indukcja wsteczna: ek = wartosci zachowan przy jednym przerzucie, v = najlepszy wybor z rzutu.
+    std::array<double, LICZBA_RZUTOW> v;
+    std::array<double, LICZBA_ZACHOWAN> ek;
+    std::copy(ocenaKoncowa, ocenaKoncowa + LICZBA_RZUTOW, v.begin());
+    for (int krok = 1; krok <= pozostaloRzutow; krok++)
+    {
+        wartosciZachowan(v.data(), ek.data());
+        if (krok < pozostaloRzutow) najlepszeWartosci(ek.data(), v.data());
+    }
+
+    int najlepsza = wszystkie;
+    double najlepszaWartosc = ek[indeksZachowania(kosci, wszystkie)];
+    for (int maska = wszystkie - 1; maska >= 0; maska--)
+    {
+        double w = ek[indeksZachowania(kosci, maska)];
+        if (w > najlepszaWartosc + 1e-9
+            || (w > najlepszaWartosc - 1e-9 && qPopulationCount((quint32)maska) > qPopulationCount((quint32)najlepsza)))
+        {
+            najlepsza = maska;
+            najlepszaWartosc = w;
+        }
+    }
+
+    if (wartosc) *wartosc = najlepszaWartosc;
+    return najlepsza;
+}
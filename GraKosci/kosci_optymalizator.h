@@ -0,0 +1,68 @@
+#ifndef KOSCI_OPTYMALIZATOR_H
+#define KOSCI_OPTYMALIZATOR_H
+
+#pragma once
+#include <QtGlobal>
+#include <array>
+#include <vector>
+#include "kosci_config.h"
+
+// Tablice przejsc dla 5 kosci: 252 rzuty (multizbiory) i 462 zachowane podzbiory.
+// Dla kazdego zachowanego podzbioru - rozklad rzutow po przerzuceniu reszty kosci.
+// Budowane raz przy pierwszym uzyciu i wspoldzielone tylko do odczytu przez bota i podglad szans.
+class OptymalizatorKosci
+{
+public:
+    static constexpr int LICZBA_RZUTOW = 252;
+    static constexpr int LICZBA_ZACHOWAN = 462;
+    static constexpr int LICZBA_KATEGORII = 13;
+    static constexpr int LICZBA_MASEK = 32;
+
+    static const OptymalizatorKosci& instancja();
+
+    int indeksRzutu(const std::array<int, 5>& kosci) const;           // -1 gdy oczka spoza 1..6
+    int indeksZachowania(const std::array<int, 5>& kosci, int maska) const;
+    int punkty(Kategoria k, int indeksRzutu) const { return m_punkty[(int)k][indeksRzutu]; }
+
+    // ek[K] = E[v(rzut)] po przerzuceniu kosci spoza zachowanego podzbioru K.
+    void wartosciZachowan(const double* v, double* ek) const;
+    // v[rzut] = max po 32 maskach ek[zachowanie(rzut, maska)].
+    void najlepszeWartosci(const double* ek, double* v) const;
+
+    // Maska zatrzymanych kosci (bit i = kosc i) maksymalizujaca oczekiwana ocene koncowa
+    // przy `pozostaloRzutow` przerzutach; przy remisie wygrywa wiecej zatrzymanych kosci.
+    int najlepszaMaska(const std::array<int, 5>& kosci, int pozostaloRzutow,
+                       const double* ocenaKoncowa, double* wartosc = nullptr) const;
+
+    // Gra pod jedna kategorie: szansa jej zaliczenia (> 0 pkt) i oczekiwane punkty na koniec tury,
+    // gdy teraz zatrzymujemy `maska`, a przerzuty rozgrywamy optymalnie pod te kategorie.
+    struct Szansa
+    {
+        double prawdopodobienstwo = 0.0;
+        double oczekiwane = 0.0;
+    };
+    Szansa szansa(Kategoria k, const std::array<int, 5>& kosci, int maska, int pozostaloRzutow) const;
+
+private:
+    OptymalizatorKosci();
+    void policzSzanse();
+
+    static int punktyDlaRzutu(Kategoria k, const std::array<int, 5>& d);
+
+    std::array<std::array<quint8, 5>, LICZBA_RZUTOW> m_rzuty;
+    std::vector<qint16> m_indeksRzutu;          // klucz: posortowane oczka w systemie szostkowym
+    std::vector<qint16> m_indeksZachowania;     // klucz: posortowane oczka (0 = brak) w systemie siodemkowym
+    std::array<std::array<qint16, LICZBA_MASEK>, LICZBA_RZUTOW> m_zachowaniaRzutu;
+
+    std::array<int, LICZBA_ZACHOWAN + 1> m_poczatekPrzejsc;
+    std::vector<qint16> m_celPrzejscia;
+    std::vector<double> m_pPrzejscia;
+
+    std::array<std::array<quint8, LICZBA_RZUTOW>, LICZBA_KATEGORII> m_punkty;
+
+    // [(kategoria * MAX_RZUTOW + pozostalo - 1) * LICZBA_ZACHOWAN + zachowanie]
+    std::vector<double> m_szansaZachowan;
+    std::vector<double> m_oczekiwaneZachowan;
+};
+
+#endif // KOSCI_OPTYMALIZATOR_H
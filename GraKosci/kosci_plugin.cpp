@@ -0,0 +1,17 @@
+#include "kosci_plugin.h"
+#include "kosci_window.h"
+
+QMainWindow *KosciPlugin::createWindow(const GameLaunchConfig &config)
+{
+    return new KosciWindow(config);
+}
+
+void KosciPlugin::resetWindow(QMainWindow *window, const GameLaunchConfig &config)
+{
+    static_cast<KosciWindow *>(window)->reset(config);
+}
+
+void KosciPlugin::suspendWindow(QMainWindow *window)
+{
+    static_cast<KosciWindow *>(window)->suspend();
+}
@@ -0,0 +1,19 @@
+#ifndef KOSCI_PLUGIN_H
+#define KOSCI_PLUGIN_H
+
+#include <QObject>
+#include "game_plugin.h"
+
+class KosciPlugin : public QObject, public GamePlugin
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID GamePlugin_iid FILE "kosci_plugin.json")
+    Q_INTERFACES(GamePlugin)
+
+public:
+    QMainWindow *createWindow(const GameLaunchConfig &config) override;
+    void resetWindow(QMainWindow *window, const GameLaunchConfig &config) override;
+    void suspendWindow(QMainWindow *window) override;
+};
+
+#endif
@@ -0,0 +1,123 @@
+#include "kosci_szanse.h"
+#include "kosci_logic.h"
+#include "kosci_tabela.h"
+#include <QColor>
+#include <QBrush>
+
+static const int LICZBA_KOLUMN = 3;
+static const int LIMIT_PAMIECI = 4096;
+
+PodgladSzans::PodgladSzans(QObject* parent) : QAbstractTableModel(parent)
+{
+}
+
+quint32 PodgladSzans::klucz(const std::array<int, 5>& kosci, int maska, int pozostalo)
+{
+    // 5 x 3 bity oczek, 5 bitow blokad, 2 bity pozostalych rzutow.
+    quint32 k = 0;
+    for (int i = 0; i < 5; i++) k |= (quint32)(kosci[i] & 7) << (3 * i);
+    k |= (quint32)(maska & 31) << 15;
+    k |= (quint32)(pozostalo & 3) << 20;
+    return k;
+}
+
+const PodgladSzans::Wiersze& PodgladSzans::wiersze(const std::array<int, 5>& kosci, int maska, int pozostalo)
+{
+    const quint32 k = klucz(kosci, maska, pozostalo);
+    auto it = m_pamiec.constFind(k);
+    if (it != m_pamiec.constEnd())
+        return it.value();
+
+    if (m_pamiec.size() >= LIMIT_PAMIECI)
+        m_pamiec.clear();
+
+    const OptymalizatorKosci& opt = OptymalizatorKosci::instancja();
+    Wiersze w;
+    for (int r = 0; r < OptymalizatorKosci::LICZBA_KATEGORII; r++)
+        w[r] = opt.szansa(TabelaWynikow::kategoriaWiersza(r), kosci, maska, pozostalo);
+    return m_pamiec.insert(k, w).value();
+}
+
+void PodgladSzans::odswiez(const KosciLogic& logic)
+{
+    const auto& gracze = logic.gracze();
+    const bool aktywny = !gracze.empty() && !logic.czyWszyscySkonczyli();
+
+    std::array<bool, OptymalizatorKosci::LICZBA_KATEGORII> otwarte{};
+    quint32 k = 0xFFFFFFFFu;
+    if (aktywny)
+    {
+        const StanGracza& g = gracze[logic.tura()];
+        for (int r = 0; r < OptymalizatorKosci::LICZBA_KATEGORII; r++)
+            otwarte[r] = !g.zajete.value(TabelaWynikow::kategoriaWiersza(r));
+
+        // Przed pierwszym rzutem wszystkie kosci ida pod kubek, blokady nie maja znaczenia.
+        const int pozostalo = MAX_RZUTOW - logic.rzutNr();
+        int maska = 0;
+        if (logic.rzutNr() > 0)
+            for (int i = 0; i < 5; i++) if (logic.blokady()[i]) maska |= 1 << i;
+
+        k = klucz(logic.kosci(), maska, pozostalo);
+        if (k != m_klucz)
+            m_wiersze = wiersze(logic.kosci(), maska, pozostalo);
+    }
+
+    if (k == m_klucz && otwarte == m_otwarte && aktywny == m_aktywny)
+        return;
+
+    m_klucz = k;
+    m_otwarte = otwarte;
+    m_aktywny = aktywny;
+    emit dataChanged(index(0, 0), index(rowCount() - 1, LICZBA_KOLUMN - 1),
+                     { Qt::DisplayRole, Qt::ForegroundRole });
+}
+
+int PodgladSzans::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : OptymalizatorKosci::LICZBA_KATEGORII;
+}
+
+int PodgladSzans::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : LICZBA_KOLUMN;
+}
+
+QVariant PodgladSzans::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid()) return QVariant();
+
+    const int r = index.row();
+    const int c = index.column();
+
+    if (role == Qt::DisplayRole)
+    {
+        if (c == 0)
+            return TabelaWynikow::nazwaWiersza(r);
+        if (!m_aktywny || !m_otwarte[r])
+            return QString("-");
+        if (c == 1)
+            return QString::number(m_wiersze[r].prawdopodobienstwo * 100.0, 'f', 1) + " %";
+        return QString::number(m_wiersze[r].oczekiwane, 'f', 1);
+    }
+
+    if (role == Qt::TextAlignmentRole && c > 0)
+        return int(Qt::AlignCenter);
+
+    if (role == Qt::ForegroundRole && c > 0 && (!m_aktywny || !m_otwarte[r]))
+        return QBrush(QColor("#999"));
+
+    return QVariant();
+}
+
+QVariant PodgladSzans::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) return QVariant();
+    if (section == 0) return QString("Kategoria");
+    if (section == 1) return QString("Szansa");
+    return QString("Oczek. pkt");
+}
+
+Qt::ItemFlags PodgladSzans::flags(const QModelIndex& index) const
+{
+    return index.isValid() ? Qt::ItemIsEnabled : Qt::NoItemFlags;
+}
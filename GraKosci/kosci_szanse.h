@@ -0,0 +1,43 @@
+#ifndef KOSCI_SZANSE_H
+#define KOSCI_SZANSE_H
+
+#pragma once
+#include <QAbstractTableModel>
+#include <QHash>
+#include <array>
+#include "kosci_optymalizator.h"
+
+class KosciLogic;
+
+// Podglad szans dla aktywnego gracza: wiersz = kategoria, kolumny = szansa zaliczenia i oczekiwane punkty.
+// Wartosci pochodza z tablic OptymalizatorKosci i sa pamietane per klucz (kosci, blokady, pozostale rzuty),
+// wiec przelaczenie blokady to odczyt z pamieci podrecznej albo 13 odczytow z tablic.
+class PodgladSzans : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit PodgladSzans(QObject* parent = nullptr);
+
+    void odswiez(const KosciLogic& logic);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+private:
+    typedef std::array<OptymalizatorKosci::Szansa, OptymalizatorKosci::LICZBA_KATEGORII> Wiersze;
+
+    static quint32 klucz(const std::array<int, 5>& kosci, int maska, int pozostalo);
+    const Wiersze& wiersze(const std::array<int, 5>& kosci, int maska, int pozostalo);
+
+    QHash<quint32, Wiersze> m_pamiec;
+    quint32 m_klucz = 0xFFFFFFFFu;
+    Wiersze m_wiersze{};
+    std::array<bool, OptymalizatorKosci::LICZBA_KATEGORII> m_otwarte{};
+    bool m_aktywny = false;
+};
+
+#endif // KOSCI_SZANSE_H
@@ -0,0 +1,208 @@
+#include "kosci_tabela.h"
+#include "kosci_logic.h"
+#include <QColor>
+#include <QBrush>
+
+static const std::array<Kategoria, 13> KAT_LISTA = {
+    Kategoria::Jedynki, Kategoria::Dwojki, Kategoria::Trojki, Kategoria::Czworki, Kategoria::Piatki, Kategoria::Szostki,
+    Kategoria::Trojka, Kategoria::Czworka, Kategoria::Full, Kategoria::MalyStrit, Kategoria::DuzyStrit, Kategoria::Yahtzee, Kategoria::Szansa
+};
+
+static const QStringList NAZWY_WIERSZY = {
+    "Jedynki", "Dwójki", "Trójki", "Czwórki", "Piątki", "Szóstki",
+    "3 Jednakowe", "4 Jednakowe", "Full", "Mały Strit", "Duży Strit", "YAHTZEE", "Szansa",
+    "Suma Góra", "Bonus (+35)", "Suma Dół", "SUMA ŁĄCZNA"
+};
+
+static const int LICZBA_WIERSZY = 17;
+
+TabelaWynikow::TabelaWynikow(QObject* parent) : QAbstractTableModel(parent)
+{
+}
+
+int TabelaWynikow::liczbaKategorii()
+{
+    return (int)KAT_LISTA.size();
+}
+
+Kategoria TabelaWynikow::kategoriaWiersza(int wiersz)
+{
+    return KAT_LISTA[wiersz];
+}
+
+QString TabelaWynikow::nazwaWiersza(int wiersz)
+{
+    return NAZWY_WIERSZY[wiersz];
+}
+
+TabelaWynikow::Komorka& TabelaWynikow::komorka(QVector<Komorka>& tab, int gracz, int wiersz) const
+{
+    return tab[gracz * LICZBA_WIERSZY + wiersz];
+}
+
+void TabelaWynikow::odswiez(const KosciLogic& logic)
+{
+    const auto& gracze = logic.gracze();
+    const int n = (int)gracze.size();
+    const int kat = liczbaKategorii();
+
+    bool podgladAktywny = logic.czyMojaTura() && logic.rzutNr() > 0;
+    int tura = podgladAktywny ? logic.tura() : -1;
+    if (tura != m_turaPodgladu || (podgladAktywny && logic.kosci() != m_kosciPodgladu))
+    {
+        m_turaPodgladu = tura;
+        m_kosciPodgladu = logic.kosci();
+        m_podglad.fill(0, kat);
+        if (podgladAktywny)
+            for (int r = 0; r < kat; r++) m_podglad[r] = logic.obliczPunkty(KAT_LISTA[r], m_kosciPodgladu);
+    }
+
+    QVector<Komorka> nowe(n * LICZBA_WIERSZY);
+    for (int i = 0; i < n; i++)
+    {
+        const StanGracza& g = gracze[i];
+        for (int r = 0; r < kat; r++)
+        {
+            Komorka& k = komorka(nowe, i, r);
+            Kategoria cat = KAT_LISTA[r];
+            if (g.zajete.value(cat))
+            {
+                k.wartosc = g.wynik.value(cat);
+                k.rodzaj = RodzajKomorki::Wynik;
+            }
+            else if (i == m_turaPodgladu)
+            {
+                k.wartosc = m_podglad[r];
+                k.rodzaj = RodzajKomorki::Podglad;
+            }
+        }
+
+        const int sumy[4] = { g.sumaGor(), g.bonus(), g.sumaDol(), g.total() };
+        for (int s = 0; s < 4; s++)
+        {
+            Komorka& k = komorka(nowe, i, kat + s);
+            k.wartosc = sumy[s];
+            k.rodzaj = RodzajKomorki::Suma;
+        }
+    }
+
+    QStringList nazwy;
+    for (const auto& g : gracze) nazwy << g.nazwa;
+
+    // Zmiana liczby graczy zmienia ksztalt tabeli - tylko wtedy pelny reset.
+    if (nazwy.size() != m_nazwy.size())
+    {
+        beginResetModel();
+        m_nazwy = nazwy;
+        m_komorki = nowe;
+        endResetModel();
+        return;
+    }
+
+    if (nazwy != m_nazwy)
+    {
+        m_nazwy = nazwy;
+        emit headerDataChanged(Qt::Horizontal, 1, n);
+    }
+
+    // Dla kazdej kolumny jeden dataChanged od pierwszego do ostatniego zmienionego wiersza.
+    QVector<Komorka> stare;
+    stare.swap(m_komorki);
+    m_komorki = nowe;
+    for (int i = 0; i < n; i++)
+    {
+        int od = -1, doW = -1;
+        for (int r = 0; r < LICZBA_WIERSZY; r++)
+        {
+            if (komorka(stare, i, r) != komorka(nowe, i, r))
+            {
+                if (od < 0) od = r;
+                doW = r;
+            }
+        }
+        if (od >= 0)
+            emit dataChanged(index(od, i + 1), index(doW, i + 1), { Qt::DisplayRole, RolaRodzaju });
+    }
+}
+
+int TabelaWynikow::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : LICZBA_WIERSZY;
+}
+
+int TabelaWynikow::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_nazwy.size() + 1;
+}
+
+QVariant TabelaWynikow::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid()) return QVariant();
+
+    const int r = index.row();
+    const int c = index.column();
+
+    if (c == 0)
+    {
+        if (role == Qt::DisplayRole) return NAZWY_WIERSZY[r];
+        if (role == RolaRodzaju) return (int)(r < liczbaKategorii() ? RodzajKomorki::Naglowek : RodzajKomorki::Suma);
+        return QVariant();
+    }
+
+    const Komorka& k = m_komorki[(c - 1) * LICZBA_WIERSZY + r];
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        return k.rodzaj == RodzajKomorki::Pusta ? QVariant() : QVariant(QString::number(k.wartosc));
+    case Qt::TextAlignmentRole:
+        return (int)Qt::AlignCenter;
+    case RolaRodzaju:
+        return (int)k.rodzaj;
+    }
+    return QVariant();
+}
+
+QVariant TabelaWynikow::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal)
+        return QAbstractTableModel::headerData(section, orientation, role);
+
+    if (section == 0) return "Kategoria";
+    if (section - 1 < m_nazwy.size()) return m_nazwy[section - 1];
+    return QVariant();
+}
+
+Qt::ItemFlags TabelaWynikow::flags(const QModelIndex& index) const
+{
+    if (!index.isValid()) return Qt::NoItemFlags;
+    if (index.column() == 0 || index.row() >= liczbaKategorii()) return Qt::ItemIsEnabled;
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+void TabelaWynikowDelegat::initStyleOption(QStyleOptionViewItem* option, const QModelIndex& index) const
+{
+    QStyledItemDelegate::initStyleOption(option, index);
+
+    static const QBrush tloNaglowka(QColor(220, 220, 220));
+    static const QBrush tloWyniku(QColor(200, 255, 200));
+    static const QBrush tloSumy(QColor(255, 250, 205));
+
+    switch ((TabelaWynikow::RodzajKomorki)index.data(TabelaWynikow::RolaRodzaju).toInt())
+    {
+    case TabelaWynikow::RodzajKomorki::Naglowek:
+        option->backgroundBrush = tloNaglowka;
+        break;
+    case TabelaWynikow::RodzajKomorki::Wynik:
+        option->backgroundBrush = tloWyniku;
+        option->font.setBold(true);
+        break;
+    case TabelaWynikow::RodzajKomorki::Podglad:
+        option->palette.setColor(QPalette::Text, Qt::gray);
+        break;
+    case TabelaWynikow::RodzajKomorki::Suma:
+        option->backgroundBrush = tloSumy;
+        break;
+    case TabelaWynikow::RodzajKomorki::Pusta:
+        break;
+    }
+}
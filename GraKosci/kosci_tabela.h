@@ -0,0 +1,78 @@
+#ifndef KOSCI_TABELA_H
+#define KOSCI_TABELA_H
+
+#pragma once
+#include <QAbstractTableModel>
+#include <QStyledItemDelegate>
+#include <QVector>
+#include <QStringList>
+#include <array>
+#include "kosci_config.h"
+
+class KosciLogic;
+
+// Model tabeli wynikow: wiersze = 13 kategorii + 4 sumy, kolumna 0 = nazwy, dalej gracze.
+// odswiez() porownuje nowa migawke z poprzednia i zglasza dataChanged tylko dla zmienionych zakresow.
+class TabelaWynikow : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum class RodzajKomorki : quint8
+    {
+        Pusta,
+        Wynik,
+        Podglad,
+        Suma,
+        Naglowek
+    };
+
+    static constexpr int RolaRodzaju = Qt::UserRole + 1;
+
+    explicit TabelaWynikow(QObject* parent = nullptr);
+
+    void odswiez(const KosciLogic& logic);
+
+    static int liczbaKategorii();
+    static Kategoria kategoriaWiersza(int wiersz);
+    static QString nazwaWiersza(int wiersz);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+private:
+    struct Komorka
+    {
+        int wartosc = 0;
+        RodzajKomorki rodzaj = RodzajKomorki::Pusta;
+
+        bool operator==(const Komorka& o) const { return wartosc == o.wartosc && rodzaj == o.rodzaj; }
+        bool operator!=(const Komorka& o) const { return !(*this == o); }
+    };
+
+    Komorka& komorka(QVector<Komorka>& tab, int gracz, int wiersz) const;
+
+    QStringList m_nazwy;
+    QVector<Komorka> m_komorki;      // [gracz * liczba wierszy + wiersz]
+
+    // Podglad punktow liczymy ponownie tylko, gdy zmienily sie kosci albo tura.
+    std::array<int, 5> m_kosciPodgladu{ 0, 0, 0, 0, 0 };
+    int m_turaPodgladu = -1;
+    QVector<int> m_podglad;
+};
+
+class TabelaWynikowDelegat : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+protected:
+    void initStyleOption(QStyleOptionViewItem* option, const QModelIndex& index) const override;
+};
+
+#endif // KOSCI_TABELA_H
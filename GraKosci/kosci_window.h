@@ -1,46 +1,66 @@
-#ifndef KOSCI_WINDOW_H
-#define KOSCI_WINDOW_H
-
-#pragma once
-#include <QMainWindow>
-#include <QToolButton>
-#include <QTimer>
-#include "kosci_logic.h"
-#include "game_config.h"
-
-QT_BEGIN_NAMESPACE
-namespace Ui
-{
-class OknoGry;
-}
-QT_END_NAMESPACE
-
-class KosciWindow : public QMainWindow
-{
-    Q_OBJECT
-
-public:
-    explicit KosciWindow(const GameLaunchConfig &config, QWidget* parent = nullptr);
-    ~KosciWindow();
-
-signals:
-    void gameClosed();
-
-protected:
-    void closeEvent(QCloseEvent *event) override;
-
-private slots:
-    void odswiez();
-    void onAnimacja();
-    void onBackToMenu();
-
-private:
-    Ui::OknoGry* ui;
-    KosciLogic* logic;
-    QTimer animTimer;
-    int animKroki = 0;
-
-    void ustawKosc(int idx, int val, bool blocked);
-};
-
-#endif // KOSCI_WINDOW_H
+#ifndef KOSCI_WINDOW_H
+#define KOSCI_WINDOW_H
+
+#pragma once
+#include <QMainWindow>
+#include <QTimer>
+#include <QPushButton>
+#include "kosci_logic.h"
+#include "kosci_tabela.h"
+#include "kosci_szanse.h"
+#include "kosci_kostka.h"
+#include "game_config.h"
+
+QT_BEGIN_NAMESPACE
+namespace Ui
+{
+class OknoGry;
+}
+QT_END_NAMESPACE
+
+class KosciWindow : public QMainWindow
+{
+    Q_OBJECT
+
+public:
+    explicit KosciWindow(const GameLaunchConfig &config, QWidget* parent = nullptr);
+    ~KosciWindow();
+
+    // Okno z puli launchera: nowa logika gry bez ponownego skladania .ui.
+    void reset(const GameLaunchConfig &config);
+    void suspend();
+
+signals:
+    void gameClosed();
+
+protected:
+    void closeEvent(QCloseEvent *event) override;
+
+private slots:
+    void odswiez();
+    void onAnimacja();
+    void onBackToMenu();
+    void zapiszGre();
+    void wczytajGre();
+
+private:
+    Ui::OknoGry* ui;
+    KosciLogic* logic;
+    TabelaWynikow* tabelaModel;
+    PodgladSzans* szanseModel;
+    QTimer animTimer;
+    int animKroki = 0;
+    QPushButton* btnZapisz;
+    QPushButton* btnWczytaj;
+    GameLaunchConfig konfiguracja;
+    bool lokalna = false;
+
+    void ustawKosc(int idx, int val, bool blocked);
+    bool wczytaj(const QString& sciezka, QString* blad);
+    bool przywroc(const QByteArray& dane);
+    void wznow();
+    void autozapis();
+    void zapiszStatystyki(int punktyZwyciezcy);
+};
+
+#endif // KOSCI_WINDOW_H
@@ -1,191 +1,339 @@
-#include "boardscene.h"
-#include <QGraphicsEllipseItem>
-#include <QGraphicsTextItem>
-#include <QPen>
-#include <QBrush>
-
-BoardScene::BoardScene(Gra* gra, QObject* parent)
-    : QGraphicsScene(parent), m_gra(gra)
-{
-    setSceneRect(-420, -420, 840, 840);
-    resetujTlo();
-}
-
-static QColor kolorWyszarzony(const QColor& c)
-{
-    QColor g(220, 220, 220);
-    return QColor((c.red() + g.red())/2,
-                  (c.green() + g.green())/2,
-                  (c.blue() + g.blue())/2);
-}
-
-
-QColor BoardScene::kolorQt(KolorGracza k) const
-{
-    switch (k)
-    {
-    case KolorGracza::Czerwony: return QColor(220, 60, 60);
-    case KolorGracza::Zielony: return QColor(60, 180, 80);
-    case KolorGracza::Niebieski: return QColor(70, 120, 240);
-    case KolorGracza::Zolty: return QColor(230, 200, 60);
-    }
-    return Qt::gray;
-}
-
-void BoardScene::rysujPlansze()
-{
-    clear();
-
-    QPen pen(Qt::black, 1);
-    for (int i = 0; i < 52; ++i)
-    {
-        QPointF p = m_plansza.torGlowny()[i];
-        auto* kolo = addEllipse(p.x() - 10, p.y() - 10, 20, 20, pen, QBrush(Qt::white));
-        kolo->setZValue(-10);
-    }
-
-    for (int k = 0; k < 4; ++k)
-    {
-        KolorGracza kg = static_cast<KolorGracza>(k);
-        QBrush pedzelDom(kolorWyszarzony(kolorQt(kg)));
-
-        for (int i = 0; i < 4; ++i)
-        {
-            QPointF p = m_plansza.toryDomowe()[k][i];
-            auto* kolo = addEllipse(p.x() - 9, p.y() - 9, 18, 18, pen, pedzelDom);
-            kolo->setZValue(-10);
-        }
-    }
-    for (int k = 0; k < 4; ++k)
-    {
-        KolorGracza kg = static_cast<KolorGracza>(k);
-        QBrush pedzelBaza(kolorWyszarzony(kolorQt(kg)));
-
-        for (int id = 0; id < 4; ++id)
-        {
-            QPointF p = m_plansza.pozycjaBaza(kg, id);
-            auto* kolo = addEllipse(p.x() - 9, p.y() - 9, 18, 18, pen, pedzelBaza);
-            kolo->setZValue(-10);
-        }
-    }
-    addEllipse(-16, -16, 32, 32, pen, QBrush(QColor(240,240,240)))->setZValue(-10);
-
-}
-
-QString BoardScene::kluczPola(const Gracz& g, const Pionek& p) const
-{
-    if (p.wBazie())
-        return "baza_" + QString::number((int)p.kolor()) + "_" + QString::number(p.id());
-
-    if (p.naTorzeGlownym())
-    {
-        int abs = (g.indeksStartu() + p.krok()) % 52;
-        return "tor_" + QString::number(abs);
-    }
-    return "dom_" + QString::number((int)p.kolor()) + "_" + QString::number(p.krok() - 52);
-}
-
-void BoardScene::utworzTokenyJesliTrzeba()
-{
-    if (!m_gra) return;
-
-    for (auto& g : m_gra->gracze())
-    {
-        for (auto& p : const_cast<QVector<Pionek>&>(g.pionki()))
-        {
-            if (!m_tokeny.contains(&p))
-            {
-                auto* item = new TokenItem(&p, kolorQt(p.kolor()));
-                addItem(item);
-                m_tokeny.insert(&p, item);
-
-                connect(item, &TokenItem::klikniety, this, [this](Pionek* pp){
-                    emit pionekKlikniety(pp);
-                });
-
-            }
-        }
-    }
-}
-
-void BoardScene::ustawPozycjeTokenow()
-{
-    QHash<QString, QVector<TokenItem*>> grupy;
-
-    for (const auto& g : m_gra->gracze())
-    {
-        for (const auto& p : g.pionki())
-        {
-            TokenItem* item = m_tokeny.value(const_cast<Pionek*>(&p), nullptr);
-            if (!item) continue;
-
-            QString key = kluczPola(g, p);
-            grupy[key].push_back(item);
-        }
-    }
-
-    for (auto it = grupy.begin(); it != grupy.end(); ++it)
-    {
-        const QString& key = it.key();
-        auto& lista = it.value();
-        QPointF bazowa(0,0);
-        bool znaleziono = false;
-        
-        for (const auto& g : m_gra->gracze())
-        {
-            for (const auto& p : g.pionki())
-            {
-                if (kluczPola(g, p) == key)
-                {
-                    bazowa = m_plansza.pozycjaDlaPionka(g, p);
-                    znaleziono = true;
-                    break;
-                }
-            }
-            if (znaleziono) break;
-        }
-
-        for (int i = 0; i < lista.size(); ++i)
-        {
-            QPointF off(0,0);
-            if (lista.size() == 2)
-                off = (i == 0) ? QPointF(-10, 0) : QPointF(10, 0);
-            else if (lista.size() >= 3)
-                off = QPointF(-10 + i*10, (i%2==0)? -8 : 8);
-
-            lista[i]->setPos(bazowa + off);
-        }
-    }
-}
-
-void BoardScene::ustawPodswietlenia()
-{
-    for (auto* item : m_tokeny)
-        item->ustawPodswietlenie(false);
-
-    if (!m_gra || !m_gra->czyRzucono()) return;
-
-    auto mozliwe = m_gra->mozliwePionki();
-    for (auto* p : mozliwe)
-    {
-        if (m_tokeny.contains(p))
-            m_tokeny[p]->ustawPodswietlenie(true);
-    }
-}
-
-void BoardScene::odswiez()
-{
-    if (!m_gra) return;
-
-    utworzTokenyJesliTrzeba();
-    ustawPozycjeTokenow();
-    ustawPodswietlenia();
-}
-
-void BoardScene::resetujTlo()
-{
-    clear();          
-    m_tokeny.clear(); 
-    rysujPlansze();   
-}
-
+#include "boardscene.h"
+#include "game_trace.h"
+#include "startup_profile.h"
+#include <QGraphicsEllipseItem>
+#include <QGraphicsTextItem>
+#include <QPen>
+#include <QBrush>
+#include <QSet>
+#include <algorithm>
+
+static const int KLATKA_MS = 16;
+static const double MS_NA_POLE = 90.0;
+static const double MS_NA_POLE_SZYBKO = 35.0;
+static const double MAKS_CZAS_ANIMACJI = 700.0;
+
+BoardScene::BoardScene(Gra* gra, QObject* parent)
+    : QGraphicsScene(parent), m_gra(gra)
+{
+    setSceneRect(-420, -420, 840, 840);
+
+    // Tokeny ruszaja sie co klatke - indeks BSP przebudowywalby sie przy kazdym setPos.
+    setItemIndexMethod(QGraphicsScene::NoIndex);
+
+    m_zegarAnimacji.setInterval(KLATKA_MS);
+    m_zegarAnimacji.setTimerType(Qt::PreciseTimer);
+    connect(&m_zegarAnimacji, &QTimer::timeout, this, &BoardScene::krokAnimacji);
+
+    rysujPlansze();
+}
+
+static QColor kolorWyszarzony(const QColor& c)
+{
+    QColor g(220, 220, 220);
+    return QColor((c.red() + g.red())/2,
+                  (c.green() + g.green())/2,
+                  (c.blue() + g.blue())/2);
+}
+
+
+QColor BoardScene::kolorQt(KolorGracza k) const
+{
+    switch (k)
+    {
+    case KolorGracza::Czerwony: return QColor(220, 60, 60);
+    case KolorGracza::Zielony: return QColor(60, 180, 80);
+    case KolorGracza::Niebieski: return QColor(70, 120, 240);
+    case KolorGracza::Zolty: return QColor(230, 200, 60);
+    }
+    return Qt::gray;
+}
+
+void BoardScene::rysujPlansze()
+{
+    StartupStage etap("BoardScene::rysujPlansze");
+    clear();
+
+    QPen pen(Qt::black, 1);
+    for (int i = 0; i < 52; ++i)
+    {
+        QPointF p = m_plansza.torGlowny()[i];
+        auto* kolo = addEllipse(p.x() - 10, p.y() - 10, 20, 20, pen, QBrush(Qt::white));
+        kolo->setZValue(-10);
+    }
+
+    for (int k = 0; k < 4; ++k)
+    {
+        KolorGracza kg = static_cast<KolorGracza>(k);
+        QBrush pedzelDom(kolorWyszarzony(kolorQt(kg)));
+
+        for (int i = 0; i < 4; ++i)
+        {
+            QPointF p = m_plansza.toryDomowe()[k][i];
+            auto* kolo = addEllipse(p.x() - 9, p.y() - 9, 18, 18, pen, pedzelDom);
+            kolo->setZValue(-10);
+        }
+    }
+    for (int k = 0; k < 4; ++k)
+    {
+        KolorGracza kg = static_cast<KolorGracza>(k);
+        QBrush pedzelBaza(kolorWyszarzony(kolorQt(kg)));
+
+        for (int id = 0; id < 4; ++id)
+        {
+            QPointF p = m_plansza.pozycjaBaza(kg, id);
+            auto* kolo = addEllipse(p.x() - 9, p.y() - 9, 18, 18, pen, pedzelBaza);
+            kolo->setZValue(-10);
+        }
+    }
+    addEllipse(-16, -16, 32, 32, pen, QBrush(QColor(240,240,240)))->setZValue(-10);
+
+}
+
+QString BoardScene::kluczPola(const Gracz& g, const Pionek& p) const
+{
+    if (p.wBazie())
+        return "baza_" + QString::number((int)p.kolor()) + "_" + QString::number(p.id());
+
+    if (p.naTorzeGlownym())
+    {
+        int abs = (g.indeksStartu() + p.krok()) % 52;
+        return "tor_" + QString::number(abs);
+    }
+    return "dom_" + QString::number((int)p.kolor()) + "_" + QString::number(p.krok() - 52);
+}
+
+void BoardScene::utworzTokenyJesliTrzeba()
+{
+    if (!m_gra) return;
+
+    for (auto& g : m_gra->gracze())
+    {
+        for (auto& p : const_cast<QVector<Pionek>&>(g.pionki()))
+        {
+            int klucz = kluczTokenu(p);
+            if (TokenItem* item = m_tokeny.value(klucz, nullptr))
+            {
+                item->ustawPionek(&p);
+                continue;
+            }
+
+            auto* item = new TokenItem(&p, kolorQt(p.kolor()));
+            addItem(item);
+            item->setPos(m_plansza.pozycjaDlaPionka(g, p));
+            m_tokeny.insert(klucz, item);
+            m_ostatniKrok.insert(klucz, p.krok());
+
+            connect(item, &TokenItem::klikniety, this, [this](Pionek* pp){
+                emit pionekKlikniety(pp);
+            });
+        }
+    }
+}
+
+void BoardScene::ustawPozycjeTokenow()
+{
+    struct Grupa
+    {
+        QPointF bazowa;
+        QVector<QPair<const Gracz*, const Pionek*>> pionki;
+    };
+    QHash<QString, Grupa> grupy;
+
+    for (const auto& g : m_gra->gracze())
+    {
+        for (const auto& p : g.pionki())
+        {
+            if (!m_tokeny.contains(kluczTokenu(p))) continue;
+
+            Grupa& gr = grupy[kluczPola(g, p)];
+            if (gr.pionki.isEmpty())
+                gr.bazowa = m_plansza.pozycjaDlaPionka(g, p);
+            gr.pionki.push_back({ &g, &p });
+        }
+    }
+
+    for (auto it = grupy.cbegin(); it != grupy.cend(); ++it)
+    {
+        const auto& lista = it.value().pionki;
+
+        for (int i = 0; i < lista.size(); ++i)
+        {
+            QPointF off(0,0);
+            if (lista.size() == 2)
+                off = (i == 0) ? QPointF(-10, 0) : QPointF(10, 0);
+            else if (lista.size() >= 3)
+                off = QPointF(-10 + i*10, (i%2==0)? -8 : 8);
+
+            const Pionek& p = *lista[i].second;
+            przesunToken(m_tokeny.value(kluczTokenu(p)), *lista[i].first, p, it.value().bazowa + off);
+        }
+    }
+}
+
+void BoardScene::przesunToken(TokenItem* item, const Gracz& g, const Pionek& p, const QPointF& cel)
+{
+    int klucz = kluczTokenu(p);
+    int poprzedni = m_ostatniKrok.value(klucz, p.krok());
+    m_ostatniKrok[klucz] = p.krok();
+
+    auto it = m_animacje.find(item);
+    bool wTrakcie = (it != m_animacje.end());
+    if (wTrakcie && it->cel == cel)
+        return;
+
+    if (!m_animacjeWlaczone || (!wTrakcie && item->pos() == cel))
+    {
+        if (wTrakcie)
+            m_animacje.erase(it);
+        item->setPos(cel);
+        item->setZValue(0);
+        return;
+    }
+
+    Animacja a;
+    a.cel = cel;
+    a.punkty.push_back(item->pos());
+
+    // Ruch po torze idzie pole po polu; zbicie, wyjscie z bazy i przeskoki stanu leca prosto.
+    if (poprzedni >= 0 && p.krok() > poprzedni && p.krok() - poprzedni <= 6)
+    {
+        for (int k = poprzedni + 1; k < p.krok(); ++k)
+            a.punkty.push_back(m_plansza.pozycjaDlaKroku(g, k));
+    }
+    a.punkty.push_back(cel);
+
+    // Stan przyszedl zanim poprzednia animacja sie skonczyla - doganiamy szybciej.
+    int odcinki = a.punkty.size() - 1;
+    double ms = wTrakcie ? MS_NA_POLE_SZYBKO : MS_NA_POLE;
+    a.msNaOdcinek = std::min(ms, MAKS_CZAS_ANIMACJI / odcinki);
+
+    m_animacje.insert(item, a);
+    item->setZValue(1);
+
+    if (!m_zegarAnimacji.isActive())
+    {
+        m_czasKlatki.start();
+        m_zegarAnimacji.start();
+    }
+}
+
+void BoardScene::krokAnimacji()
+{
+    double dt = (double)m_czasKlatki.restart();
+    if (dt > 100.0) dt = 100.0;
+
+    // Wszystkie tokeny przesuwamy w jednym przebiegu - scena laczy to w jedno odswiezenie widoku.
+    for (auto it = m_animacje.begin(); it != m_animacje.end(); )
+    {
+        TokenItem* item = it.key();
+        Animacja& a = it.value();
+
+        a.postep += dt / a.msNaOdcinek;
+        while (a.postep >= 1.0 && a.odcinek < a.punkty.size() - 2)
+        {
+            a.postep -= 1.0;
+            a.odcinek++;
+        }
+
+        if (a.postep >= 1.0)
+        {
+            item->setPos(a.cel);
+            item->setZValue(0);
+            it = m_animacje.erase(it);
+            continue;
+        }
+
+        const QPointF& z = a.punkty[a.odcinek];
+        const QPointF& d = a.punkty[a.odcinek + 1];
+        double t = a.postep * a.postep * (3.0 - 2.0 * a.postep);
+        item->setPos(z + (d - z) * t);
+        ++it;
+    }
+
+    if (m_animacje.isEmpty())
+        m_zegarAnimacji.stop();
+}
+
+void BoardScene::dokonczAnimacje()
+{
+    for (auto it = m_animacje.begin(); it != m_animacje.end(); ++it)
+    {
+        it.key()->setPos(it.value().cel);
+        it.key()->setZValue(0);
+    }
+
+    m_animacje.clear();
+    m_zegarAnimacji.stop();
+}
+
+void BoardScene::ustawAnimacje(bool wlaczone)
+{
+    m_animacjeWlaczone = wlaczone;
+    if (!wlaczone)
+        dokonczAnimacje();
+}
+
+void BoardScene::ustawPodswietlenia()
+{
+    for (auto* item : m_tokeny)
+        item->ustawPodswietlenie(false);
+
+    if (!m_gra || !m_gra->czyRzucono()) return;
+
+    auto mozliwe = m_gra->mozliwePionki();
+    for (auto* p : mozliwe)
+    {
+        if (TokenItem* item = m_tokeny.value(kluczTokenu(*p), nullptr))
+            item->ustawPodswietlenie(true);
+    }
+}
+
+void BoardScene::odswiez()
+{
+    GAME_TRACE("BoardScene::odswiez", "ui");
+    if (!m_gra) return;
+
+    dopasujTokeny();
+    ustawPozycjeTokenow();
+    ustawPodswietlenia();
+}
+
+// Podmiana stanu (CH_STATE) przebudowuje graczy, wiec Pionek* w tokenach wskazuja na stare obiekty.
+// Tokeny kolorow spoza stanu znikaja, reszta od razu dostaje nowe wskazniki - bez czekania na odswiez().
+void BoardScene::dopasujTokeny()
+{
+    if (!m_gra) return;
+
+    QSet<int> aktualne;
+    for (const auto& g : m_gra->gracze())
+        for (const auto& p : g.pionki())
+            aktualne.insert(kluczTokenu(p));
+
+    for (auto it = m_tokeny.begin(); it != m_tokeny.end(); )
+    {
+        if (aktualne.contains(it.key()))
+        {
+            ++it;
+            continue;
+        }
+        m_animacje.remove(it.value());
+        m_ostatniKrok.remove(it.key());
+        delete it.value();
+        it = m_tokeny.erase(it);
+    }
+
+    utworzTokenyJesliTrzeba();
+}
+
+// Pola planszy sa stale - nowa gra usuwa tylko tokeny zamiast budowac ~85 elementow od nowa.
+void BoardScene::resetujTlo()
+{
+    m_zegarAnimacji.stop();
+    m_animacje.clear();
+    m_ostatniKrok.clear();
+
+    qDeleteAll(m_tokeny);
+    m_tokeny.clear();
+}
+
@@ -1,35 +1,63 @@
-#pragma once
-#include <QGraphicsScene>
-#include <QHash>
-#include "gra.h"
-#include "plansza.h"
-#include "tokenitem.h"
-
-class BoardScene : public QGraphicsScene
-{
-    Q_OBJECT
-public:
-    BoardScene(Gra* gra, QObject* parent = nullptr);
-
-signals:
-    void pionekKlikniety(Pionek* p);
-
-public slots:
-    void odswiez();
-    void resetujTlo();
-
-private:
-    void rysujPlansze();
-    QColor kolorQt(KolorGracza k) const;
-    void utworzTokenyJesliTrzeba();
-    void ustawPozycjeTokenow();
-    void ustawPodswietlenia();
-
-    QString kluczPola(const Gracz& g, const Pionek& p) const;
-
-private:
-    Gra* m_gra = nullptr;
-    Plansza m_plansza;
-
-    QHash<Pionek*, TokenItem*> m_tokeny;
-};
+#pragma once
+#include <QGraphicsScene>
+#include <QHash>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "gra.h"
+#include "plansza.h"
+#include "tokenitem.h"
+
+class BoardScene : public QGraphicsScene
+{
+    Q_OBJECT
+public:
+    BoardScene(Gra* gra, QObject* parent = nullptr);
+
+    void ustawAnimacje(bool wlaczone);
+    bool czyAnimuje() const { return !m_animacje.isEmpty(); }
+
+signals:
+    void pionekKlikniety(Pionek* p);
+
+public slots:
+    void odswiez();
+    void resetujTlo();
+    void dopasujTokeny();
+    void dokonczAnimacje();
+
+private slots:
+    void krokAnimacji();
+
+private:
+    // Jedna animacja na token; nowy cel zastepuje stara sciezke zamiast ja kolejkowac.
+    struct Animacja
+    {
+        QVector<QPointF> punkty;
+        QPointF cel;
+        int odcinek = 0;
+        double postep = 0.0;
+        double msNaOdcinek = 0.0;
+    };
+
+    void rysujPlansze();
+    QColor kolorQt(KolorGracza k) const;
+    void utworzTokenyJesliTrzeba();
+    void ustawPozycjeTokenow();
+    void ustawPodswietlenia();
+    void przesunToken(TokenItem* item, const Gracz& g, const Pionek& p, const QPointF& cel);
+
+    QString kluczPola(const Gracz& g, const Pionek& p) const;
+    static int kluczTokenu(const Pionek& p) { return (int)p.kolor() * 4 + p.id(); }
+
+private:
+    Gra* m_gra = nullptr;
+    Plansza m_plansza;
+
+    QHash<int, TokenItem*> m_tokeny;
+    QHash<int, int> m_ostatniKrok;
+
+    QHash<TokenItem*, Animacja> m_animacje;
+    QTimer m_zegarAnimacji;
+    QElapsedTimer m_czasKlatki;
+    bool m_animacjeWlaczone = true;
+};
@@ -0,0 +1,17 @@
+#include "chinczyk_plugin.h"
+#include "chinczyk_window.h"
+
+QMainWindow *ChinczykPlugin::createWindow(const GameLaunchConfig &config)
+{
+    return new ChinczykWindow(config);
+}
+
+void ChinczykPlugin::resetWindow(QMainWindow *window, const GameLaunchConfig &config)
+{
+    static_cast<ChinczykWindow *>(window)->resetuj(config);
+}
+
+void ChinczykPlugin::suspendWindow(QMainWindow *window)
+{
+    static_cast<ChinczykWindow *>(window)->wstrzymaj();
+}
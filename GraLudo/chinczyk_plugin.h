@@ -0,0 +1,19 @@
+#ifndef CHINCZYK_PLUGIN_H
+#define CHINCZYK_PLUGIN_H
+
+#include <QObject>
+#include "game_plugin.h"
+
+class ChinczykPlugin : public QObject, public GamePlugin
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID GamePlugin_iid FILE "chinczyk_plugin.json")
+    Q_INTERFACES(GamePlugin)
+
+public:
+    QMainWindow *createWindow(const GameLaunchConfig &config) override;
+    void resetWindow(QMainWindow *window, const GameLaunchConfig &config) override;
+    void suspendWindow(QMainWindow *window) override;
+};
+
+#endif
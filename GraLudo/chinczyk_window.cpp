@@ -1,731 +1,1210 @@
-#include "chinczyk_window.h"
-#include <QVBoxLayout>
-#include <QHBoxLayout>
-#include <QWidget>
-#include <QMessageBox>
-#include <QStatusBar>
-#include <QPainter>
-#include <QJsonArray>
-
-ChinczykWindow::ChinczykWindow(const GameLaunchConfig& config, QWidget* parent)
-    : QMainWindow(parent), m_config(config)
-{
-    zbudujUI();
-    podlaczSygnaly();
-    initTryb();
-}
-
-ChinczykWindow::ChinczykWindow(QWidget* parent)
-    : ChinczykWindow(GameLaunchConfig{}, parent)
-{
-}
-
-void ChinczykWindow::zbudujUI()
-{
-    auto* central = new QWidget(this);
-    setCentralWidget(central);
-
-    m_view = new QGraphicsView(this);
-    m_view->setRenderHint(QPainter::Antialiasing, true);
-
-    m_scena = new BoardScene(&m_gra, this);
-    m_view->setScene(m_scena);
-
-    m_btnNowa = new QPushButton("Nowa gra", this);
-    m_btnRzut = new QPushButton("Rzut kostka", this);
-    m_btnStart = new QPushButton("Start gry", this);
-
-    m_comboGracze = new QComboBox(this);
-    m_comboGracze->addItem("2 graczy", 2);
-    m_comboGracze->addItem("3 graczy", 3);
-    m_comboGracze->addItem("4 graczy", 4);
-    m_comboGracze->setCurrentIndex(2);
-
-    m_lblRzut = new QLabel("Rzut: -", this);
-    m_lblTura = new QLabel("Tura: -", this);
-
-    m_lblSiec = new QLabel("", this);
-    m_lblLobby = new QLabel("", this);
-
-    auto* gora = new QHBoxLayout();
-    gora->addWidget(m_comboGracze);
-    gora->addWidget(m_btnNowa);
-    gora->addSpacing(15);
-    gora->addWidget(m_btnRzut);
-    gora->addSpacing(15);
-
-    gora->addWidget(m_lblTura);
-    gora->addWidget(m_lblRzut);
-
-    gora->addSpacing(15);
-    gora->addWidget(m_lblSiec);
-    gora->addWidget(m_lblLobby);
-    gora->addWidget(m_btnStart);
-
-    gora->addStretch(1);
-
-    auto* layout = new QVBoxLayout(central);
-    layout->addLayout(gora);
-    layout->addWidget(m_view);
-
-    resize(900, 900);
-    setWindowTitle("Chinczyk (Ludo) - Qt");
-    statusBar()->showMessage("Gotowe.");
-}
-
-void ChinczykWindow::podlaczSygnaly()
-{
-    connect(m_scena, &BoardScene::pionekKlikniety, this, [this](Pionek* p){
-        obsluzPionekKlik(p);
-    });
-
-    connect(m_btnStart, &QPushButton::clicked, this, [this](){
-        if (!m_siecAktywna || !m_jestemHostem) return;
-        if (m_graRozpoczeta) return;
-
-        if (!m_serwer.czyPelny())
-        {
-            QMessageBox::information(this, "Lobby", "Brakuje graczy do startu.");
-            return;
-        }
-
-        startGrySieciowejHost();
-    });
-
-    connect(m_comboGracze, &QComboBox::currentIndexChanged, this, [this](int){
-        if (!m_siecAktywna || !m_jestemHostem) return;
-        if (m_graRozpoczeta) return;
-        int n = m_comboGracze->currentData().toInt();
-        m_serwer.ustawDocelowaLiczbeGraczy(n);
-    });
-
-    connect(m_btnNowa, &QPushButton::clicked, this, [this](){
-
-        if (m_siecAktywna && !m_jestemHostem)
-            return;
-
-        if (m_siecAktywna && m_jestemHostem)
-        {
-            auto odp = QMessageBox::question(
-                this,
-                "Nowa gra",
-                "Zakoncz obecna gre i rozpocznij nowa?",
-                QMessageBox::Yes | QMessageBox::No
-                );
-
-            if (odp == QMessageBox::No)
-                return;
-
-            rozpocznijNowaGreSieciowaHost();
-            return;
-        }
-
-        auto czyGraTrwa = [this]() -> bool
-        {
-            if (m_gra.gracze().isEmpty()) return false;
-            if (m_gra.czyRzucono() || m_gra.ostatniRzut() != 0) return true;
-
-            for (const auto& g : m_gra.gracze())
-                for (const auto& p : g.pionki())
-                    if (!p.wBazie())
-                        return true;
-
-            return false;
-        };
-
-        if (czyGraTrwa())
-        {
-            auto odp = QMessageBox::question(
-                this,
-                "Nowa gra",
-                "Zakoncz obecna gre i rozpocznij nowa?",
-                QMessageBox::Yes | QMessageBox::No
-                );
-
-            if (odp == QMessageBox::No)
-                return;
-        }
-
-        int n = m_comboGracze->currentData().toInt();
-
-        if (m_scena)
-            m_scena->resetujTlo();
-
-        m_gra.nowaGra(n);
-    });
-
-    connect(m_btnRzut, &QPushButton::clicked, this, [this](){
-        obsluzRzutKlik();
-    });
-
-    connect(&m_gra, &Gra::stanZmieniony, this, [this](){
-
-        if (!m_gra.gracze().isEmpty())
-            m_lblTura->setText("Tura: " + kolorNaTekst(m_gra.aktualnyGracz().kolor()));
-        else
-            m_lblTura->setText("Tura: -");
-
-        if (m_gra.czyRzucono())
-            m_lblRzut->setText("Rzut: " + QString::number(m_gra.ostatniRzut()));
-        else
-            m_lblRzut->setText("Rzut: -");
-
-        odswiezUiSieci();
-        m_scena->odswiez();
-
-        wyslijStanJesliHost();
-    });
-
-    connect(&m_gra, &Gra::komunikat, this, [this](const QString& t){
-        statusBar()->showMessage(t, 5000);
-    });
-
-    connect(&m_gra, &Gra::koniecGry, this, [this](const QString& zwyciezca){
-
-        if (!m_siecAktywna)
-        {
-            QMessageBox box(this);
-            box.setIcon(QMessageBox::Information);
-            box.setWindowTitle("Koniec gry");
-            box.setText("Koniec gry wygral: " + zwyciezca);
-
-            auto* btnNowa = box.addButton("Rozpocznij nowa gre", QMessageBox::AcceptRole);
-            QPushButton* btnKont = nullptr;
-
-            if (m_gra.moznaKontynuowacPoWygranej())
-                btnKont = box.addButton("Kontynuuj", QMessageBox::RejectRole);
-
-            box.setWindowFlags(box.windowFlags() & ~Qt::WindowCloseButtonHint);
-            box.setDefaultButton(btnNowa);
-            box.setEscapeButton(btnNowa);
-
-            box.exec();
-
-            if (box.clickedButton() == btnNowa)
-            {
-                int n = m_comboGracze->currentData().toInt();
-                m_scena->resetujTlo();
-                m_gra.nowaGra(n);
-                return;
-            }
-
-            if (btnKont && box.clickedButton() == btnKont)
-                m_gra.kontynuujPoWygranej();
-
-            return;
-        }
-        if (!m_jestemHostem)
-            return;
-
-        wyslijGameOverJesliHost(zwyciezca);
-
-        QMessageBox box(this);
-        box.setIcon(QMessageBox::Information);
-        box.setWindowTitle("Koniec gry");
-        box.setText("Koniec gry wygral: " + zwyciezca);
-
-        auto* btnNowa = box.addButton("Rozpocznij nowa gre", QMessageBox::AcceptRole);
-        QPushButton* btnKont = nullptr;
-
-        if (m_gra.moznaKontynuowacPoWygranej())
-            btnKont = box.addButton("Kontynuuj", QMessageBox::RejectRole);
-
-        box.setWindowFlags(box.windowFlags() & ~Qt::WindowCloseButtonHint);
-        box.setDefaultButton(btnNowa);
-        box.setEscapeButton(btnNowa);
-
-        box.exec();
-
-        if (box.clickedButton() == btnNowa)
-        {
-            rozpocznijNowaGreSieciowaHost();
-            return;
-        }
-
-        if (btnKont && box.clickedButton() == btnKont)
-        {
-            m_gra.kontynuujPoWygranej();
-        }
-    });
-}
-
-void ChinczykWindow::initTryb()
-{
-    m_siecAktywna = (m_config.mode == GameMode::NetHost || m_config.mode == GameMode::NetClient);
-    m_lblSiec->setText("");
-    m_lblLobby->setText("");
-    m_btnStart->setVisible(false);
-
-    if (m_siecAktywna)
-    {
-        initSiec();
-        odswiezUiSieci();
-        return;
-    }
-
-    m_graRozpoczeta = true;
-
-    int n = m_comboGracze->currentData().toInt();
-    m_gra.nowaGra(n);
-}
-
-void ChinczykWindow::initSiec()
-{
-    if (m_config.mode == GameMode::NetClient)
-        m_comboGracze->setEnabled(false);
-
-    if (m_config.mode == GameMode::NetClient)
-        m_btnNowa->setEnabled(false);
-
-    m_btnStart->setVisible(m_config.mode == GameMode::NetHost);
-
-    if (m_config.mode == GameMode::NetHost)
-    {
-        m_jestemHostem = true;
-        m_mojSlot = 0;
-
-        int n = m_comboGracze->currentData().toInt();
-        m_totalPlayers = n;
-        m_mojKolor = KolorGracza::Czerwony;
-
-        connect(&m_serwer, &ChinczykSerwer::log, this, [this](const QString& s){
-            statusBar()->showMessage(s, 6000);
-        });
-
-        connect(&m_serwer, &ChinczykSerwer::lobbyZmienione, this, [this](const QJsonObject& lobby){
-            ustawLobbyZJson(lobby);
-            odswiezUiSieci();
-        });
-
-        connect(&m_serwer, &ChinczykSerwer::wiadomoscOdebrana, this, [this](int slot, const QJsonObject& msg){
-            obsluzMsgHost(slot, msg);
-        });
-
-        m_serwer.start((quint16)m_config.port, n, m_config.playerName);
-
-        m_lblSiec->setText("Siec: Host (Czerwony)");
-        statusBar()->showMessage("Host: nasluch na porcie " + QString::number(m_config.port), 6000);
-    }
-    else
-    {
-        m_jestemHostem = false;
-
-        connect(&m_klient, &ChinczykKlient::log, this, [this](const QString& s){
-            statusBar()->showMessage(s, 6000);
-        });
-
-        connect(&m_klient, &ChinczykKlient::wiadomoscOdebrana, this, [this](const QJsonObject& msg){
-            obsluzMsgKlient(msg);
-        });
-
-        connect(&m_klient, &ChinczykKlient::rozlaczono, this, [this](){
-            statusBar()->showMessage("Klient: rozlaczono.", 6000);
-        });
-
-        m_lblSiec->setText("Siec: Klient (laczenie...)");
-        m_klient.polacz(m_config.hostIp, (quint16)m_config.port, m_config.playerName);
-    }
-}
-
-void ChinczykWindow::ustawLobbyZJson(const QJsonObject& lobby)
-{
-    m_lobby = lobby;
-
-    m_totalPlayers = lobby.value("totalPlayers").toInt(m_totalPlayers);
-
-    int pol = 0;
-    QJsonArray players = lobby.value("players").toArray();
-    for (const auto& v : players)
-    {
-        QJsonObject p = v.toObject();
-        if (p.value("connected").toBool(false))
-            pol++;
-    }
-
-    m_lblLobby->setText("Polaczeni: " + QString::number(pol) + "/" + QString::number(m_totalPlayers));
-
-    if (m_siecAktywna && m_jestemHostem && !m_graRozpoczeta)
-    {
-        bool ktosJest = (pol > 1);
-        if (ktosJest)
-            m_comboGracze->setEnabled(false);
-    }
-
-    if (m_siecAktywna && !m_jestemHostem)
-    {
-        m_comboGracze->setEnabled(false);
-    }
-}
-
-void ChinczykWindow::odswiezUiSieci()
-{
-    if (!m_siecAktywna)
-    {
-        m_btnStart->setVisible(false);
-        m_btnNowa->setEnabled(true);
-        m_btnRzut->setEnabled(!m_gra.czyRzucono());
-        return;
-    }
-
-    if (!m_graRozpoczeta)
-    {
-        m_btnRzut->setEnabled(false);
-        m_btnNowa->setEnabled(false);
-
-        if (m_jestemHostem)
-        {
-            m_btnStart->setVisible(true);
-            m_btnStart->setEnabled(lobbyPelne());
-        }
-        else
-        {
-            m_btnStart->setVisible(false);
-        }
-        return;
-    }
-
-    if (m_jestemHostem)
-    {
-        m_btnNowa->setEnabled(true);
-    }
-    else
-    {
-        m_btnNowa->setEnabled(false);
-    }
-    bool moja = czyMojaTura();
-    m_btnRzut->setEnabled(moja && !m_gra.czyRzucono() && !m_gra.czyOczekujeNaDecyzje());
-}
-
-bool ChinczykWindow::czyMojaTura() const
-{
-    if (!m_graRozpoczeta) return false;
-    if (m_gra.gracze().isEmpty()) return false;
-    return m_gra.aktualnyGracz().kolor() == m_mojKolor;
-}
-
-KolorGracza ChinczykWindow::kolorDlaSlot(int slot) const
-{
-    if (m_totalPlayers <= 2)
-    {
-        if (slot == 0) return KolorGracza::Czerwony;
-        return KolorGracza::Niebieski;
-    }
-    if (m_totalPlayers == 3)
-    {
-        if (slot == 0) return KolorGracza::Czerwony;
-        if (slot == 1) return KolorGracza::Zielony;
-        return KolorGracza::Niebieski;
-    }
-    if (slot == 0) return KolorGracza::Czerwony;
-    if (slot == 1) return KolorGracza::Zielony;
-    if (slot == 2) return KolorGracza::Niebieski;
-    return KolorGracza::Zolty;
-}
-
-Pionek* ChinczykWindow::znajdzPionek(KolorGracza kolor, int id)
-{
-    auto& gracze = m_gra.gracze();      
-    for (auto& g : gracze)                 
-    {
-        if (g.kolor() != kolor) continue;
-        if (id < 0 || id >= g.pionki().size()) return nullptr;
-        return &g.pionki()[id];            
-    }
-    return nullptr;
-}
-
-void ChinczykWindow::startGrySieciowejHost()
-{
-    if (!lobbyPelne())
-    {
-        QMessageBox::information(this, "Lobby", "Brakuje graczy do startu.");
-        return;
-    }
-    m_totalPlayers = m_serwer.docelowaLiczbaGraczy();
-
-    if (m_scena)
-        m_scena->resetujTlo();
-
-    m_gra.nowaGra(m_totalPlayers);
-    m_graRozpoczeta = true;
-
-    QJsonObject msg;
-    msg["t"] = "CH_START";
-    msg["totalPlayers"] = m_totalPlayers;
-    msg["state"] = m_gra.stanJson();
-
-    m_serwer.wyslijDoWszystkich(msg);
-
-    odswiezUiSieci();
-}
-
-void ChinczykWindow::rozpocznijNowaGreSieciowaHost()
-{
-    if (!m_serwer.czyPelny())
-    {
-        QMessageBox::information(this, "Lobby", "Brakuje graczy do startu.");
-        return;
-    }
-    if (!m_jestemHostem) return;
-
-    if (!m_graRozpoczeta)
-    {
-        statusBar()->showMessage("Lobby: uzyj 'Start gry' po dolaczeniu graczy.", 4000);
-        return;
-    }
-
-    if (m_scena)
-        m_scena->resetujTlo();
-
-    m_gra.nowaGra(m_totalPlayers);
-
-    QJsonObject msg;
-    msg["t"] = "CH_START";
-    msg["totalPlayers"] = m_totalPlayers;
-    msg["state"] = m_gra.stanJson();
-    m_serwer.wyslijDoWszystkich(msg);
-}
-
-void ChinczykWindow::wyslijStanJesliHost()
-{
-    if (!m_siecAktywna || !m_jestemHostem) return;
-    if (!m_graRozpoczeta) return;
-
-    QJsonObject msg;
-    msg["t"] = "CH_STATE";
-    msg["state"] = m_gra.stanJson();
-    m_serwer.wyslijDoWszystkich(msg);
-}
-
-void ChinczykWindow::wyslijGameOverJesliHost(const QString& zwyciezca)
-{
-    if (!m_siecAktywna || !m_jestemHostem) return;
-
-    QJsonObject msg;
-    msg["t"] = "CH_GAMEOVER";
-    msg["winner"] = zwyciezca;
-    msg["canContinue"] = m_gra.moznaKontynuowacPoWygranej();
-    m_serwer.wyslijDoWszystkich(msg);
-}
-
-void ChinczykWindow::obsluzRzutKlik()
-{
-    if (!m_siecAktywna)
-    {
-        m_gra.rzutKostka();
-        return;
-    }
-
-    if (!m_graRozpoczeta)
-    {
-        statusBar()->showMessage("Czekaj na start gry.", 3000);
-        return;
-    }
-
-    if (!czyMojaTura())
-    {
-        statusBar()->showMessage("Nie twoja tura.", 2500);
-        return;
-    }
-
-    if (m_gra.czyOczekujeNaDecyzje())
-        return;
-
-    if (m_jestemHostem)
-    {
-        m_gra.rzutKostka();
-    }
-    else
-    {
-        QJsonObject msg;
-        msg["t"] = "CH_REQ_ROLL";
-        msg["slot"] = m_mojSlot;
-        m_klient.wyslij(msg);
-    }
-}
-
-void ChinczykWindow::obsluzPionekKlik(Pionek* p)
-{
-    if (!p) return;
-
-    if (!m_siecAktywna)
-    {
-        m_gra.wykonajRuch(p);
-        return;
-    }
-
-    if (!m_graRozpoczeta)
-        return;
-
-    if (!czyMojaTura())
-    {
-        statusBar()->showMessage("Nie twoja tura.", 2500);
-        return;
-    }
-
-    if (m_gra.czyOczekujeNaDecyzje())
-        return;
-
-    if (m_jestemHostem)
-    {
-        m_gra.wykonajRuch(p);
-    }
-    else
-    {
-        QJsonObject msg;
-        msg["t"] = "CH_REQ_MOVE";
-        msg["slot"] = m_mojSlot;
-        msg["id"] = p->id();
-        m_klient.wyslij(msg);
-    }
-}
-
-void ChinczykWindow::obsluzMsgHost(int slot, const QJsonObject& msg)
-{
-    QString t = msg.value("t").toString();
-
-    if (!m_graRozpoczeta)
-    {
-        return;
-    }
-    KolorGracza kolor = kolorDlaSlot(slot);
-    if (m_gra.gracze().isEmpty()) return;
-    if (m_gra.aktualnyGracz().kolor() != kolor) return;
-
-    if (t == "CH_REQ_ROLL")
-    {
-        if (m_gra.czyOczekujeNaDecyzje()) return;
-        if (m_gra.czyRzucono()) return;
-
-        m_gra.rzutKostka();
-        return;
-    }
-
-    if (t == "CH_REQ_MOVE")
-    {
-        if (m_gra.czyOczekujeNaDecyzje()) return;
-        if (!m_gra.czyRzucono()) return;
-
-        int id = msg.value("id").toInt(-1);
-        Pionek* p = znajdzPionek(kolor, id);
-        if (p)
-            m_gra.wykonajRuch(p);
-
-        return;
-    }
-}
-
-void ChinczykWindow::obsluzMsgKlient(const QJsonObject& msg)
-{
-    QString t = msg.value("t").toString();
-
-    if (t == "CH_REJECT")
-    {
-        QString reason = msg.value("reason").toString("Odrzucono polaczenie.");
-        QMessageBox::critical(this, "Siec", reason);
-        close();
-        return;
-    }
-
-    if (t == "CH_WELCOME")
-    {
-        m_mojSlot = msg.value("slot").toInt(-1);
-        int k = msg.value("kolor").toInt(0);
-        m_totalPlayers = msg.value("totalPlayers").toInt(0);
-
-        m_mojKolor = (KolorGracza)k;
-
-        m_lblSiec->setText("Siec: Klient (" + kolorNaTekst(m_mojKolor) + ")");
-        statusBar()->showMessage("Dolaczono do lobby. Slot: " + QString::number(m_mojSlot), 6000);
-
-        QJsonObject lobby;
-        lobby["t"] = "CH_LOBBY";
-        lobby["totalPlayers"] = m_totalPlayers;
-        lobby["players"] = msg.value("players").toArray();
-        ustawLobbyZJson(lobby);
-        odswiezUiSieci();
-        return;
-    }
-
-    if (t == "CH_LOBBY")
-    {
-        ustawLobbyZJson(msg);
-        odswiezUiSieci();
-        return;
-    }
-
-    if (t == "CH_START")
-    {
-        m_totalPlayers = msg["totalPlayers"].toInt();
-
-        m_comboGracze->setEnabled(false);
-        int idx = (m_totalPlayers == 2 ? 0 : (m_totalPlayers == 3 ? 1 : 2));
-        m_comboGracze->setCurrentIndex(idx);
-
-        if (m_scena) m_scena->resetujTlo();
-        m_gra.nowaGra(m_totalPlayers);
-        m_gra.ustawStanJson(msg["state"].toObject());
-
-        m_graRozpoczeta = true;
-
-        m_scena->odswiez();
-        odswiezUiSieci();
-        return;
-    }
-
-    if (t == "CH_STATE")
-    {
-        if (!m_graRozpoczeta) return;
-
-        QJsonObject st = msg.value("state").toObject();
-        if (m_scena) m_scena->resetujTlo();
-
-        m_gra.ustawStanJson(st);
-        m_scena->odswiez();
-        odswiezUiSieci();
-        return;
-    }
-    if (t == "CH_GAMEOVER")
-    {
-        QString w = msg.value("winner").toString("?");
-        QMessageBox::information(this, "Koniec gry", "Koniec gry wygral: " + w);
-        return;
-    }
-}
-
-void ChinczykWindow::closeEvent(QCloseEvent* e)
-{
-    if (m_siecAktywna)
-    {
-        if (m_jestemHostem)
-            m_serwer.stop();
-        else
-            m_klient.rozlacz();
-    }
-
-    emit gameClosed();
-    QMainWindow::closeEvent(e);
-}
-
-int ChinczykWindow::liczbaPolaczonychWLobby() const
-{
-    if (!m_lobby.contains("players")) return 0;
-
-    int pol = 0;
-    QJsonArray players = m_lobby.value("players").toArray();
-    for (const auto& v : players)
-    {
-        QJsonObject p = v.toObject();
-        if (p.value("connected").toBool(false))
-            pol++;
-    }
-    return pol;
-}
-
-bool ChinczykWindow::lobbyPelne() const
-{
-    if (m_totalPlayers <= 0) return false;
-    return liczbaPolaczonychWLobby() >= m_totalPlayers;
-}
-
-
+#include "chinczyk_window.h"
+#include "game_trace.h"
+#include "startup_profile.h"
+#include "game_save.h"
+#include "game_stats.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QWidget>
+#include <QMessageBox>
+#include <QStatusBar>
+#include <QPainter>
+#include <QJsonArray>
+#include <QFileDialog>
+#include <QTimer>
+
+ChinczykWindow::ChinczykWindow(const GameLaunchConfig& config, QWidget* parent)
+    : QMainWindow(parent), m_config(config)
+{
+    zbudujUI();
+    podlaczSygnaly();
+    initTryb();
+}
+
+ChinczykWindow::ChinczykWindow(QWidget* parent)
+    : ChinczykWindow(GameLaunchConfig{}, parent)
+{
+}
+
+void ChinczykWindow::resetuj(const GameLaunchConfig& config)
+{
+    wstrzymaj();
+    m_config = config;
+
+    m_jestemHostem = false;
+    m_graRozpoczeta = false;
+    m_mojSlot = -1;
+    m_totalPlayers = 0;
+    m_mojKolor = KolorGracza::Czerwony;
+    m_ostatniGid = -1;
+    m_lobby = QJsonObject();
+
+    m_ziarnoUjawnione = true;
+    m_zobowiazanie.clear();
+    m_gidZobowiazania = -1;
+    m_obserwowaneRzuty.clear();
+
+    m_comboGracze->setEnabled(true);
+    m_btnNowa->setEnabled(true);
+    m_btnPowtorka->setEnabled(true);
+    m_scena->resetujTlo();
+    m_gra.wyczysc();
+    statusBar()->showMessage("Gotowe.");
+
+    initTryb();
+}
+
+void ChinczykWindow::wstrzymaj()
+{
+    autozapis();
+
+    if (m_snapshot && GameSnapshots::instance())
+        GameSnapshots::instance()->remove(m_snapshot);
+    m_snapshot = 0;
+
+    if (m_siecAktywna)
+    {
+        if (m_jestemHostem)
+        {
+            ujawnijZiarnoJesliHost();
+            m_serwer.stop();
+        }
+        else
+            m_klient.rozlacz();
+        m_siecAktywna = false;
+    }
+
+    m_rejestrator.odlacz();
+
+    if (m_trybPowtorki)
+    {
+        m_trybPowtorki = false;
+        m_panelPowtorki->setVisible(false);
+    }
+    m_scena->dokonczAnimacje();
+}
+
+void ChinczykWindow::zbudujUI()
+{
+    StartupStage etap("ChinczykWindow::zbudujUI");
+    auto* central = new QWidget(this);
+    setCentralWidget(central);
+
+    m_view = new QGraphicsView(this);
+    m_view->setRenderHint(QPainter::Antialiasing, true);
+
+    m_scena = new BoardScene(&m_gra, this);
+    m_view->setScene(m_scena);
+
+    m_btnNowa = new QPushButton("Nowa gra", this);
+    m_btnRzut = new QPushButton("Rzut kostka", this);
+    m_btnStart = new QPushButton("Start gry", this);
+    m_btnCofnij = new QPushButton("Cofnij", this);
+    m_btnPonow = new QPushButton("Ponow", this);
+    m_btnCofnij->setShortcut(QKeySequence::Undo);
+    m_btnPonow->setShortcut(QKeySequence::Redo);
+
+    m_comboGracze = new QComboBox(this);
+    m_comboGracze->addItem("2 graczy", 2);
+    m_comboGracze->addItem("3 graczy", 3);
+    m_comboGracze->addItem("4 graczy", 4);
+    m_comboGracze->setCurrentIndex(2);
+
+    m_lblRzut = new QLabel("Rzut: -", this);
+    m_lblTura = new QLabel("Tura: -", this);
+
+    m_lblSiec = new QLabel("", this);
+    m_lblLobby = new QLabel("", this);
+
+    m_btnPowtorka = new QPushButton("Powtorka...", this);
+    m_btnZapisz = new QPushButton("Zapisz...", this);
+    m_btnWczytaj = new QPushButton("Wczytaj...", this);
+
+    m_panelPowtorki = new QWidget(this);
+    m_suwakPowtorki = new QSlider(Qt::Horizontal, m_panelPowtorki);
+    m_lblPowtorka = new QLabel("Tura: 0/0", m_panelPowtorki);
+    auto* btnPoprzednia = new QPushButton("<", m_panelPowtorki);
+    auto* btnNastepna = new QPushButton(">", m_panelPowtorki);
+    auto* btnZamknij = new QPushButton("Zamknij powtorke", m_panelPowtorki);
+
+    auto* dol = new QHBoxLayout(m_panelPowtorki);
+    dol->setContentsMargins(0, 0, 0, 0);
+    dol->addWidget(btnPoprzednia);
+    dol->addWidget(m_suwakPowtorki, 1);
+    dol->addWidget(btnNastepna);
+    dol->addWidget(m_lblPowtorka);
+    dol->addWidget(btnZamknij);
+    m_panelPowtorki->setVisible(false);
+
+    connect(btnPoprzednia, &QPushButton::clicked, this, [this](){
+        m_suwakPowtorki->setValue(m_suwakPowtorki->value() - 1);
+    });
+    connect(btnNastepna, &QPushButton::clicked, this, [this](){
+        m_suwakPowtorki->setValue(m_suwakPowtorki->value() + 1);
+    });
+    connect(btnZamknij, &QPushButton::clicked, this, &ChinczykWindow::zamknijPowtorke);
+
+    auto* gora = new QHBoxLayout();
+    gora->addWidget(m_comboGracze);
+    gora->addWidget(m_btnNowa);
+    gora->addSpacing(15);
+    gora->addWidget(m_btnRzut);
+    gora->addWidget(m_btnCofnij);
+    gora->addWidget(m_btnPonow);
+    gora->addSpacing(15);
+
+    gora->addWidget(m_lblTura);
+    gora->addWidget(m_lblRzut);
+
+    gora->addSpacing(15);
+    gora->addWidget(m_lblSiec);
+    gora->addWidget(m_lblLobby);
+    gora->addWidget(m_btnStart);
+
+    gora->addStretch(1);
+    gora->addWidget(m_btnZapisz);
+    gora->addWidget(m_btnWczytaj);
+    gora->addWidget(m_btnPowtorka);
+
+    auto* layout = new QVBoxLayout(central);
+    layout->addLayout(gora);
+    layout->addWidget(m_panelPowtorki);
+    layout->addWidget(m_view);
+
+    resize(900, 900);
+    setWindowTitle("Chinczyk (Ludo) - Qt");
+    statusBar()->showMessage("Gotowe.");
+}
+
+void ChinczykWindow::podlaczSygnaly()
+{
+    // Serwer i klient sa polami okna, wiec laczymy je raz - okno z puli moze zmieniac tryb.
+    connect(&m_serwer, &ChinczykSerwer::log, this, [this](const QString& s){
+        statusBar()->showMessage(s, 6000);
+    });
+
+    connect(&m_serwer, &ChinczykSerwer::lobbyZmienione, this, [this](const QJsonObject& lobby){
+        ustawLobbyZJson(lobby);
+        odswiezUiSieci();
+    });
+
+    connect(&m_serwer, &ChinczykSerwer::wiadomoscOdebrana, this, [this](int slot, const QJsonObject& msg){
+        obsluzMsgHost(slot, msg);
+    });
+
+    connect(&m_klient, &ChinczykKlient::log, this, [this](const QString& s){
+        statusBar()->showMessage(s, 6000);
+    });
+
+    connect(&m_klient, &ChinczykKlient::wiadomoscOdebrana, this, [this](const QJsonObject& msg){
+        obsluzMsgKlient(msg);
+    });
+
+    connect(&m_klient, &ChinczykKlient::rozlaczono, this, [this](){
+        statusBar()->showMessage("Klient: rozlaczono.", 6000);
+    });
+
+    connect(m_scena, &BoardScene::pionekKlikniety, this, [this](Pionek* p){
+        obsluzPionekKlik(p);
+    });
+
+    connect(m_btnStart, &QPushButton::clicked, this, [this](){
+        if (!m_siecAktywna || !m_jestemHostem) return;
+        if (m_graRozpoczeta) return;
+
+        if (!m_serwer.czyPelny())
+        {
+            QMessageBox::information(this, "Lobby", "Brakuje graczy do startu.");
+            return;
+        }
+
+        startGrySieciowejHost();
+    });
+
+    connect(m_comboGracze, &QComboBox::currentIndexChanged, this, [this](int){
+        if (!m_siecAktywna || !m_jestemHostem) return;
+        if (m_graRozpoczeta) return;
+        int n = m_comboGracze->currentData().toInt();
+        m_serwer.ustawDocelowaLiczbeGraczy(n);
+    });
+
+    connect(m_btnNowa, &QPushButton::clicked, this, [this](){
+
+        if (m_siecAktywna && !m_jestemHostem)
+            return;
+
+        if (m_siecAktywna && m_jestemHostem)
+        {
+            auto odp = QMessageBox::question(
+                this,
+                "Nowa gra",
+                "Zakoncz obecna gre i rozpocznij nowa?",
+                QMessageBox::Yes | QMessageBox::No
+                );
+
+            if (odp == QMessageBox::No)
+                return;
+
+            rozpocznijNowaGreSieciowaHost();
+            return;
+        }
+
+        if (czyGraTrwa())
+        {
+            auto odp = QMessageBox::question(
+                this,
+                "Nowa gra",
+                "Zakoncz obecna gre i rozpocznij nowa?",
+                QMessageBox::Yes | QMessageBox::No
+                );
+
+            if (odp == QMessageBox::No)
+                return;
+        }
+
+        int n = m_comboGracze->currentData().toInt();
+
+        if (m_scena)
+            m_scena->resetujTlo();
+
+        m_gra.nowaGra(n);
+    });
+
+    connect(m_btnRzut, &QPushButton::clicked, this, [this](){
+        obsluzRzutKlik();
+    });
+
+    connect(m_btnCofnij, &QPushButton::clicked, this, [this](){
+        if (!m_siecAktywna && !m_trybPowtorki)
+            m_gra.cofnijRuch();
+    });
+
+    connect(m_btnPonow, &QPushButton::clicked, this, [this](){
+        if (!m_siecAktywna && !m_trybPowtorki)
+            m_gra.ponowRuch();
+    });
+
+    connect(m_btnPowtorka, &QPushButton::clicked, this, &ChinczykWindow::otworzPowtorke);
+    connect(m_btnZapisz, &QPushButton::clicked, this, &ChinczykWindow::zapiszGre);
+    connect(m_btnWczytaj, &QPushButton::clicked, this, &ChinczykWindow::wczytajGre);
+
+    connect(m_suwakPowtorki, &QSlider::valueChanged, this, &ChinczykWindow::pokazTurePowtorki);
+    connect(m_suwakPowtorki, &QSlider::sliderPressed, this, [this](){
+        m_scena->ustawAnimacje(false);
+    });
+    connect(m_suwakPowtorki, &QSlider::sliderReleased, this, [this](){
+        m_scena->ustawAnimacje(true);
+    });
+
+    // Gra zlicza zmiany z calego przebiegu petli zdarzen, wiec tu trafia
+    // co najwyzej jedno odswiezenie UI i jeden broadcast stanu na iteracje.
+    connect(&m_gra, &Gra::stanZmieniony, this, [this](Gra::Zmiany zmiany){
+
+        if (zmiany & (Gra::ZmianaTura | Gra::ZmianaGra))
+        {
+            if (!m_gra.gracze().isEmpty())
+                m_lblTura->setText("Tura: " + kolorNaTekst(m_gra.aktualnyGracz().kolor()));
+            else
+                m_lblTura->setText("Tura: -");
+        }
+
+        if (zmiany & (Gra::ZmianaRzut | Gra::ZmianaGra))
+        {
+            if (m_gra.czyRzucono())
+                m_lblRzut->setText("Rzut: " + QString::number(m_gra.ostatniRzut()));
+            else
+                m_lblRzut->setText("Rzut: -");
+        }
+
+        odswiezUiSieci();
+
+        // Podswietlenia zaleza od rzutu, wiec sama zmiana tury sceny nie dotyka.
+        if (zmiany & (Gra::ZmianaPionki | Gra::ZmianaRzut | Gra::ZmianaGra))
+            m_scena->odswiez();
+
+        wyslijStanJesliHost();
+    });
+
+    connect(&m_gra, &Gra::komunikat, this, [this](const QString& t){
+        statusBar()->showMessage(t, 5000);
+    });
+
+    connect(&m_gra, &Gra::nowaGraRozpoczeta, this, [this](int){
+        m_zapisaneMiejsca = 0;
+    });
+
+    connect(&m_gra, &Gra::koniecGry, this, [this](const QString& zwyciezca){
+        zapiszMiejsce(zwyciezca);
+
+        // Zwycieski ruch ma byc widoczny (i wyslany) zanim pojawi sie okno konca gry.
+        m_gra.wyslijZmiany();
+
+        if (!m_siecAktywna)
+        {
+            QMessageBox box(this);
+            box.setIcon(QMessageBox::Information);
+            box.setWindowTitle("Koniec gry");
+            box.setText("Koniec gry wygral: " + zwyciezca);
+
+            auto* btnNowa = box.addButton("Rozpocznij nowa gre", QMessageBox::AcceptRole);
+            QPushButton* btnKont = nullptr;
+
+            if (m_gra.moznaKontynuowacPoWygranej())
+                btnKont = box.addButton("Kontynuuj", QMessageBox::RejectRole);
+
+            box.setWindowFlags(box.windowFlags() & ~Qt::WindowCloseButtonHint);
+            box.setDefaultButton(btnNowa);
+            box.setEscapeButton(btnNowa);
+
+            box.exec();
+
+            if (box.clickedButton() == btnNowa)
+            {
+                zapiszPozostalych();
+                int n = m_comboGracze->currentData().toInt();
+                m_scena->resetujTlo();
+                m_gra.nowaGra(n);
+                return;
+            }
+
+            if (btnKont && box.clickedButton() == btnKont)
+                m_gra.kontynuujPoWygranej();
+
+            return;
+        }
+        if (!m_jestemHostem)
+            return;
+
+        wyslijGameOverJesliHost(zwyciezca);
+
+        QMessageBox box(this);
+        box.setIcon(QMessageBox::Information);
+        box.setWindowTitle("Koniec gry");
+        box.setText("Koniec gry wygral: " + zwyciezca);
+
+        auto* btnNowa = box.addButton("Rozpocznij nowa gre", QMessageBox::AcceptRole);
+        QPushButton* btnKont = nullptr;
+
+        if (m_gra.moznaKontynuowacPoWygranej())
+            btnKont = box.addButton("Kontynuuj", QMessageBox::RejectRole);
+
+        box.setWindowFlags(box.windowFlags() & ~Qt::WindowCloseButtonHint);
+        box.setDefaultButton(btnNowa);
+        box.setEscapeButton(btnNowa);
+
+        box.exec();
+
+        if (box.clickedButton() == btnNowa)
+        {
+            zapiszPozostalych();
+            rozpocznijNowaGreSieciowaHost();
+            return;
+        }
+
+        if (btnKont && box.clickedButton() == btnKont)
+        {
+            m_gra.kontynuujPoWygranej();
+        }
+    });
+}
+
+void ChinczykWindow::initTryb()
+{
+    m_siecAktywna = (m_config.mode == GameMode::NetHost || m_config.mode == GameMode::NetClient);
+    m_lblSiec->setText("");
+    m_lblLobby->setText("");
+    m_btnStart->setVisible(false);
+    m_btnPowtorka->setVisible(!m_siecAktywna);
+    m_btnZapisz->setVisible(!m_siecAktywna);
+    m_btnWczytaj->setVisible(!m_siecAktywna);
+    m_btnCofnij->setVisible(!m_siecAktywna);
+    m_btnPonow->setVisible(!m_siecAktywna);
+
+    if (m_config.mode != GameMode::NetClient)
+        m_rejestrator.podlacz(&m_gra);
+
+    if (m_siecAktywna)
+    {
+        initSiec();
+        odswiezUiSieci();
+        return;
+    }
+
+    m_graRozpoczeta = true;
+
+    int n = m_comboGracze->currentData().toInt();
+    m_gra.nowaGra(n);
+
+    // Pytanie o przerwana gre dopiero po pierwszej klatce - nie wlicza sie do czasu startu gry.
+    StartupProfile::onFirstFrame(this, [this](qint64){
+        QTimer::singleShot(0, this, &ChinczykWindow::wznowAutozapis);
+    });
+}
+
+void ChinczykWindow::initSiec()
+{
+    if (m_config.mode == GameMode::NetClient)
+        m_comboGracze->setEnabled(false);
+
+    if (m_config.mode == GameMode::NetClient)
+        m_btnNowa->setEnabled(false);
+
+    m_btnStart->setVisible(m_config.mode == GameMode::NetHost);
+
+    if (m_config.mode == GameMode::NetHost)
+    {
+        m_jestemHostem = true;
+        m_mojSlot = 0;
+
+        int n = m_comboGracze->currentData().toInt();
+        m_totalPlayers = n;
+        m_mojKolor = KolorGracza::Czerwony;
+
+        m_serwer.start((quint16)m_config.port, n, m_config.playerName);
+
+        if (GameSnapshots* snapshoty = GameSnapshots::instance())
+        {
+            m_snapshot = snapshoty->add(QString("ludo_%1").arg(m_config.port), [this](){
+                if (!m_graRozpoczeta || m_gra.gracze().isEmpty())
+                    return QByteArray();
+                return GameSave::pack(GameType::Chinczyk, Gra::WERSJA_STANU, m_gra.stanBinarny());
+            });
+        }
+
+        m_lblSiec->setText("Siec: Host (Czerwony)");
+        statusBar()->showMessage("Host: nasluch na porcie " + QString::number(m_config.port), 6000);
+    }
+    else
+    {
+        m_jestemHostem = false;
+
+        m_lblSiec->setText("Siec: Klient (laczenie...)");
+        m_klient.polacz(m_config.hostIp, (quint16)m_config.port, m_config.playerName);
+    }
+}
+
+void ChinczykWindow::ustawLobbyZJson(const QJsonObject& lobby)
+{
+    m_lobby = lobby;
+
+    m_totalPlayers = lobby.value("totalPlayers").toInt(m_totalPlayers);
+
+    int pol = 0;
+    QJsonArray players = lobby.value("players").toArray();
+    for (const auto& v : players)
+    {
+        QJsonObject p = v.toObject();
+        if (p.value("connected").toBool(false))
+            pol++;
+    }
+
+    m_lblLobby->setText("Polaczeni: " + QString::number(pol) + "/" + QString::number(m_totalPlayers));
+
+    if (m_siecAktywna && m_jestemHostem && !m_graRozpoczeta)
+    {
+        bool ktosJest = (pol > 1);
+        if (ktosJest)
+            m_comboGracze->setEnabled(false);
+    }
+
+    if (m_siecAktywna && !m_jestemHostem)
+    {
+        m_comboGracze->setEnabled(false);
+    }
+}
+
+void ChinczykWindow::odswiezUiSieci()
+{
+    if (m_trybPowtorki)
+    {
+        m_btnRzut->setEnabled(false);
+        m_btnNowa->setEnabled(false);
+        m_btnCofnij->setEnabled(false);
+        m_btnPonow->setEnabled(false);
+        m_comboGracze->setEnabled(false);
+        return;
+    }
+
+    if (!m_siecAktywna)
+    {
+        m_btnStart->setVisible(false);
+        m_btnNowa->setEnabled(true);
+        m_btnRzut->setEnabled(!m_gra.czyRzucono());
+        m_btnCofnij->setEnabled(m_gra.czyMoznaCofnac());
+        m_btnPonow->setEnabled(m_gra.czyMoznaPonowic());
+        return;
+    }
+
+    if (!m_graRozpoczeta)
+    {
+        m_btnRzut->setEnabled(false);
+        m_btnNowa->setEnabled(false);
+
+        if (m_jestemHostem)
+        {
+            m_btnStart->setVisible(true);
+            m_btnStart->setEnabled(lobbyPelne());
+        }
+        else
+        {
+            m_btnStart->setVisible(false);
+        }
+        return;
+    }
+
+    if (m_jestemHostem)
+    {
+        m_btnNowa->setEnabled(true);
+    }
+    else
+    {
+        m_btnNowa->setEnabled(false);
+    }
+    bool moja = czyMojaTura();
+    m_btnRzut->setEnabled(moja && !m_gra.czyRzucono() && !m_gra.czyOczekujeNaDecyzje());
+}
+
+bool ChinczykWindow::czyMojaTura() const
+{
+    if (!m_graRozpoczeta) return false;
+    if (m_gra.gracze().isEmpty()) return false;
+    return m_gra.aktualnyGracz().kolor() == m_mojKolor;
+}
+
+KolorGracza ChinczykWindow::kolorDlaSlot(int slot) const
+{
+    if (m_totalPlayers <= 2)
+    {
+        if (slot == 0) return KolorGracza::Czerwony;
+        return KolorGracza::Niebieski;
+    }
+    if (m_totalPlayers == 3)
+    {
+        if (slot == 0) return KolorGracza::Czerwony;
+        if (slot == 1) return KolorGracza::Zielony;
+        return KolorGracza::Niebieski;
+    }
+    if (slot == 0) return KolorGracza::Czerwony;
+    if (slot == 1) return KolorGracza::Zielony;
+    if (slot == 2) return KolorGracza::Niebieski;
+    return KolorGracza::Zolty;
+}
+
+Pionek* ChinczykWindow::znajdzPionek(KolorGracza kolor, int id)
+{
+    auto& gracze = m_gra.gracze();      
+    for (auto& g : gracze)                 
+    {
+        if (g.kolor() != kolor) continue;
+        if (id < 0 || id >= g.pionki().size()) return nullptr;
+        return &g.pionki()[id];            
+    }
+    return nullptr;
+}
+
+void ChinczykWindow::startGrySieciowejHost()
+{
+    if (!lobbyPelne())
+    {
+        QMessageBox::information(this, "Lobby", "Brakuje graczy do startu.");
+        return;
+    }
+    m_totalPlayers = m_serwer.docelowaLiczbaGraczy();
+
+    if (m_scena)
+        m_scena->resetujTlo();
+
+    m_gra.nowaGra(m_totalPlayers);
+    m_graRozpoczeta = true;
+    m_ziarnoUjawnione = false;
+
+    QJsonObject msg;
+    msg["t"] = "CH_START";
+    msg["totalPlayers"] = m_totalPlayers;
+    msg["state"] = m_gra.stanJson();
+    msg["commit"] = QString::fromLatin1(GameRng::commitment(m_gra.ziarno()));
+
+    m_serwer.wyslijDoWszystkich(msg);
+
+    odswiezUiSieci();
+}
+
+void ChinczykWindow::rozpocznijNowaGreSieciowaHost()
+{
+    if (!m_serwer.czyPelny())
+    {
+        QMessageBox::information(this, "Lobby", "Brakuje graczy do startu.");
+        return;
+    }
+    if (!m_jestemHostem) return;
+
+    if (!m_graRozpoczeta)
+    {
+        statusBar()->showMessage("Lobby: uzyj 'Start gry' po dolaczeniu graczy.", 4000);
+        return;
+    }
+
+    ujawnijZiarnoJesliHost();
+
+    if (m_scena)
+        m_scena->resetujTlo();
+
+    m_gra.nowaGra(m_totalPlayers);
+    m_ziarnoUjawnione = false;
+
+    QJsonObject msg;
+    msg["t"] = "CH_START";
+    msg["totalPlayers"] = m_totalPlayers;
+    msg["state"] = m_gra.stanJson();
+    msg["commit"] = QString::fromLatin1(GameRng::commitment(m_gra.ziarno()));
+    m_serwer.wyslijDoWszystkich(msg);
+}
+
+void ChinczykWindow::wyslijStanJesliHost()
+{
+    if (!m_siecAktywna || !m_jestemHostem) return;
+    if (!m_graRozpoczeta) return;
+
+    QJsonObject msg;
+    msg["t"] = "CH_STATE";
+    msg["state"] = m_gra.stanJson();
+    m_serwer.wyslijDoWszystkich(msg);
+}
+
+void ChinczykWindow::wyslijGameOverJesliHost(const QString& zwyciezca)
+{
+    if (!m_siecAktywna || !m_jestemHostem) return;
+
+    QJsonObject msg;
+    msg["t"] = "CH_GAMEOVER";
+    msg["winner"] = zwyciezca;
+    msg["canContinue"] = m_gra.moznaKontynuowacPoWygranej();
+    m_serwer.wyslijDoWszystkich(msg);
+
+    // Przy "Kontynuuj" dalsze rzuty ida z tego samego ziarna - ujawniamy je dopiero na koniec.
+    if (!m_gra.moznaKontynuowacPoWygranej())
+        ujawnijZiarnoJesliHost();
+}
+
+void ChinczykWindow::ujawnijZiarnoJesliHost()
+{
+    if (!m_siecAktywna || !m_jestemHostem || m_ziarnoUjawnione) return;
+    m_ziarnoUjawnione = true;
+
+    QJsonObject msg;
+    msg["t"] = "CH_SEED";
+    msg["gid"] = m_gra.idGry();
+    msg["seed"] = QString::number(m_gra.ziarno());
+    m_serwer.wyslijDoWszystkich(msg);
+}
+
+void ChinczykWindow::zapamietajRzut(const QJsonObject& stan)
+{
+    if (m_zobowiazanie.isEmpty() || !stan.value("rzucono").toBool(false)) return;
+    if (stan.value("gid").toInt(-1) != m_gidZobowiazania) return;
+
+    m_obserwowaneRzuty.insert(stan.value("nr").toInt(0), stan.value("rzut").toInt(0));
+}
+
+void ChinczykWindow::zweryfikujRzuty(quint64 ziarno)
+{
+    if (m_zobowiazanie.isEmpty()) return;
+
+    bool zgodne = (QString::fromLatin1(GameRng::commitment(ziarno)) == m_zobowiazanie);
+
+    if (zgodne && !m_obserwowaneRzuty.isEmpty())
+    {
+        Kostka kostka(ziarno);
+        const int ostatni = m_obserwowaneRzuty.lastKey();
+        for (int nr = 1; nr <= ostatni && zgodne; ++nr)
+        {
+            int oczka = kostka.rzut();
+            auto it = m_obserwowaneRzuty.constFind(nr);
+            if (it != m_obserwowaneRzuty.constEnd() && it.value() != oczka)
+                zgodne = false;
+        }
+    }
+
+    if (zgodne)
+        statusBar()->showMessage("Rzuty hosta zweryfikowane (" + QString::number(m_obserwowaneRzuty.size()) + ").", 6000);
+    else
+        QMessageBox::warning(this, "Weryfikacja rzutow", "Rzuty hosta nie zgadzaja sie z ujawnionym ziarnem!");
+
+    m_zobowiazanie.clear();
+    m_obserwowaneRzuty.clear();
+}
+
+void ChinczykWindow::obsluzRzutKlik()
+{
+    if (m_trybPowtorki)
+        return;
+
+    if (!m_siecAktywna)
+    {
+        m_gra.rzutKostka();
+        return;
+    }
+
+    if (!m_graRozpoczeta)
+    {
+        statusBar()->showMessage("Czekaj na start gry.", 3000);
+        return;
+    }
+
+    if (!czyMojaTura())
+    {
+        statusBar()->showMessage("Nie twoja tura.", 2500);
+        return;
+    }
+
+    if (m_gra.czyOczekujeNaDecyzje())
+        return;
+
+    if (m_jestemHostem)
+    {
+        m_gra.rzutKostka();
+    }
+    else
+    {
+        QJsonObject msg;
+        msg["t"] = "CH_REQ_ROLL";
+        msg["slot"] = m_mojSlot;
+        m_klient.wyslij(msg);
+    }
+}
+
+void ChinczykWindow::obsluzPionekKlik(Pionek* p)
+{
+    if (!p || m_trybPowtorki) return;
+
+    if (!m_siecAktywna)
+    {
+        m_gra.wykonajRuch(p);
+        return;
+    }
+
+    if (!m_graRozpoczeta)
+        return;
+
+    if (!czyMojaTura())
+    {
+        statusBar()->showMessage("Nie twoja tura.", 2500);
+        return;
+    }
+
+    if (m_gra.czyOczekujeNaDecyzje())
+        return;
+
+    if (m_jestemHostem)
+    {
+        m_gra.wykonajRuch(p);
+    }
+    else
+    {
+        QJsonObject msg;
+        msg["t"] = "CH_REQ_MOVE";
+        msg["slot"] = m_mojSlot;
+        msg["id"] = p->id();
+        m_klient.wyslij(msg);
+    }
+}
+
+void ChinczykWindow::obsluzMsgHost(int slot, const QJsonObject& msg)
+{
+    GAME_TRACE("ChinczykWindow::obsluzMsgHost", "gra");
+    static Histogram& czasTury = MetricsRegistry::instance().histogram(
+        "game_turn_seconds", MetricsRegistry::labels({ { "game", "ludo" } }));
+    ScopedTimer pomiar(czasTury);
+
+    QString t = msg.value("t").toString();
+
+    if (!m_graRozpoczeta)
+    {
+        return;
+    }
+    KolorGracza kolor = kolorDlaSlot(slot);
+    if (m_gra.gracze().isEmpty()) return;
+    if (m_gra.aktualnyGracz().kolor() != kolor) return;
+
+    if (t == "CH_REQ_ROLL")
+    {
+        if (m_gra.czyOczekujeNaDecyzje()) return;
+        if (m_gra.czyRzucono()) return;
+
+        m_gra.rzutKostka();
+        return;
+    }
+
+    if (t == "CH_REQ_MOVE")
+    {
+        if (m_gra.czyOczekujeNaDecyzje()) return;
+        if (!m_gra.czyRzucono()) return;
+
+        int id = msg.value("id").toInt(-1);
+        Pionek* p = znajdzPionek(kolor, id);
+        if (p)
+            m_gra.wykonajRuch(p);
+
+        return;
+    }
+}
+
+void ChinczykWindow::obsluzMsgKlient(const QJsonObject& msg)
+{
+    GAME_TRACE("ChinczykWindow::obsluzMsgKlient", "gra");
+    QString t = msg.value("t").toString();
+
+    if (t == "CH_REJECT")
+    {
+        QString reason = msg.value("reason").toString("Odrzucono polaczenie.");
+        QMessageBox::critical(this, "Siec", reason);
+        close();
+        return;
+    }
+
+    if (t == "CH_WELCOME")
+    {
+        m_mojSlot = msg.value("slot").toInt(-1);
+        int k = msg.value("kolor").toInt(0);
+        m_totalPlayers = msg.value("totalPlayers").toInt(0);
+
+        m_mojKolor = (KolorGracza)k;
+
+        m_lblSiec->setText("Siec: Klient (" + kolorNaTekst(m_mojKolor) + ")");
+        statusBar()->showMessage("Dolaczono do lobby. Slot: " + QString::number(m_mojSlot), 6000);
+
+        QJsonObject lobby;
+        lobby["t"] = "CH_LOBBY";
+        lobby["totalPlayers"] = m_totalPlayers;
+        lobby["players"] = msg.value("players").toArray();
+        ustawLobbyZJson(lobby);
+        odswiezUiSieci();
+        return;
+    }
+
+    if (t == "CH_LOBBY")
+    {
+        ustawLobbyZJson(msg);
+        odswiezUiSieci();
+        return;
+    }
+
+    if (t == "CH_START")
+    {
+        m_totalPlayers = msg["totalPlayers"].toInt();
+
+        m_comboGracze->setEnabled(false);
+        int idx = (m_totalPlayers == 2 ? 0 : (m_totalPlayers == 3 ? 1 : 2));
+        m_comboGracze->setCurrentIndex(idx);
+
+        if (m_scena) m_scena->resetujTlo();
+        m_gra.nowaGra(m_totalPlayers);
+        m_gra.ustawStanJson(msg["state"].toObject());
+
+        m_zobowiazanie = msg.value("commit").toString();
+        m_gidZobowiazania = m_gra.idGry();
+        m_obserwowaneRzuty.clear();
+
+        m_graRozpoczeta = true;
+
+        odswiezUiSieci();
+        return;
+    }
+
+    if (t == "CH_STATE")
+    {
+        if (!m_graRozpoczeta) return;
+
+        QJsonObject st = msg.value("state").toObject();
+
+        zapamietajRzut(st);
+
+        // Tokeny sa przypiete do (kolor, id), wiec przezywaja podmiane stanu i moga sie animowac;
+        // zmiana liczby graczy usuwa tokeny kolorow, ktorych w stanie juz nie ma.
+        m_gra.ustawStanJson(st);
+        m_scena->dopasujTokeny();
+        return;
+    }
+    if (t == "CH_SEED")
+    {
+        if (msg.value("gid").toInt(-1) == m_gidZobowiazania)
+            zweryfikujRzuty(msg.value("seed").toString().toULongLong());
+        return;
+    }
+
+    if (t == "CH_GAMEOVER")
+    {
+        QString w = msg.value("winner").toString("?");
+        QMessageBox::information(this, "Koniec gry", "Koniec gry wygral: " + w);
+        return;
+    }
+}
+
+void ChinczykWindow::closeEvent(QCloseEvent* e)
+{
+    wstrzymaj();
+
+    emit gameClosed();
+    QMainWindow::closeEvent(e);
+}
+
+int ChinczykWindow::liczbaPolaczonychWLobby() const
+{
+    if (!m_lobby.contains("players")) return 0;
+
+    int pol = 0;
+    QJsonArray players = m_lobby.value("players").toArray();
+    for (const auto& v : players)
+    {
+        QJsonObject p = v.toObject();
+        if (p.value("connected").toBool(false))
+            pol++;
+    }
+    return pol;
+}
+
+bool ChinczykWindow::lobbyPelne() const
+{
+    if (m_totalPlayers <= 0) return false;
+    return liczbaPolaczonychWLobby() >= m_totalPlayers;
+}
+
+// Pusta nazwa = miejsce bez gracza z nickiem (pozostali gracze przy jednym komputerze), bez statystyk.
+QString ChinczykWindow::nazwaGracza(KolorGracza kolor) const
+{
+    if (kolor == m_mojKolor)
+        return m_config.playerName.isEmpty() ? "Gracz" : m_config.playerName;
+
+    if (!m_siecAktywna)
+        return QString();
+
+    QJsonArray players = m_lobby.value("players").toArray();
+    for (const auto& v : players)
+    {
+        QJsonObject p = v.toObject();
+        if (p.value("kolor").toInt(-1) == (int)kolor)
+            return p.value("name").toString();
+    }
+    return QString();
+}
+
+// Miejsce to liczba graczy, ktorzy juz skonczyli; ponowienie zwycieskiego ruchu nie liczy sie drugi raz.
+void ChinczykWindow::zapiszMiejsce(const QString& zwyciezca)
+{
+    GameStats* statystyki = GameStats::instance();
+    if (!statystyki || m_trybPowtorki)
+        return;
+
+    int miejsce = 0;
+    for (const auto& g : m_gra.gracze())
+        if (g.wygral())
+            miejsce++;
+
+    for (const auto& g : m_gra.gracze())
+    {
+        const quint8 bit = 1 << (int)g.kolor();
+        if (kolorNaTekst(g.kolor()) != zwyciezca || (m_zapisaneMiejsca & bit))
+            continue;
+
+        m_zapisaneMiejsca |= bit;
+        const QString nazwa = nazwaGracza(g.kolor());
+        if (!nazwa.isEmpty())
+            statystyki->record({ GameType::Chinczyk, nazwa, miejsce == 1, miejsce });
+    }
+}
+
+// Koniec partii bez dogrywania: wszyscy, ktorzy nie doszli, dziela nastepne miejsce.
+void ChinczykWindow::zapiszPozostalych()
+{
+    GameStats* statystyki = GameStats::instance();
+    if (!statystyki || m_trybPowtorki)
+        return;
+
+    int miejsce = 1;
+    for (const auto& g : m_gra.gracze())
+        if (g.wygral())
+            miejsce++;
+
+    for (const auto& g : m_gra.gracze())
+    {
+        const quint8 bit = 1 << (int)g.kolor();
+        if (g.wygral() || (m_zapisaneMiejsca & bit))
+            continue;
+
+        m_zapisaneMiejsca |= bit;
+        const QString nazwa = nazwaGracza(g.kolor());
+        if (!nazwa.isEmpty())
+            statystyki->record({ GameType::Chinczyk, nazwa, false, miejsce });
+    }
+}
+
+bool ChinczykWindow::czyGraTrwa() const
+{
+    if (m_gra.gracze().isEmpty()) return false;
+    if (m_gra.czyRzucono() || m_gra.ostatniRzut() != 0) return true;
+
+    for (const auto& g : m_gra.gracze())
+        for (const auto& p : g.pionki())
+            if (!p.wBazie())
+                return true;
+
+    return false;
+}
+
+void ChinczykWindow::zapiszGre()
+{
+    if (m_siecAktywna || m_trybPowtorki || m_gra.gracze().isEmpty())
+        return;
+
+    QString sciezka = QFileDialog::getSaveFileName(this, "Zapisz gre",
+                                                   GameSave::directory() + "/ludo.gsav",
+                                                   GameSave::fileFilter());
+    if (sciezka.isEmpty())
+        return;
+
+    QString blad;
+    if (!GameSave::write(sciezka, GameSave::pack(GameType::Chinczyk, Gra::WERSJA_STANU, m_gra.stanBinarny()), &blad))
+        QMessageBox::warning(this, "Zapis gry", blad);
+}
+
+void ChinczykWindow::wczytajGre()
+{
+    if (m_siecAktywna || m_trybPowtorki)
+        return;
+
+    QString sciezka = QFileDialog::getOpenFileName(this, "Wczytaj gre",
+                                                   GameSave::directory(),
+                                                   GameSave::fileFilter());
+    if (sciezka.isEmpty())
+        return;
+
+    QString blad;
+    if (!wczytajZapis(sciezka, &blad))
+        QMessageBox::warning(this, "Wczytanie gry", blad);
+}
+
+bool ChinczykWindow::wczytajZapis(const QString& sciezka, QString* blad)
+{
+    QByteArray dane;
+    if (!GameSave::read(sciezka, GameType::Chinczyk, Gra::WERSJA_STANU, &dane, blad))
+        return false;
+
+    if (!przywrocStan(dane))
+    {
+        if (blad) *blad = "Plik zapisu zawiera niepoprawny stan gry.";
+        return false;
+    }
+    return true;
+}
+
+// Gra zglasza zmiane dopiero w nastepnej iteracji petli, wiec scena przebudowuje tokeny raz.
+bool ChinczykWindow::przywrocStan(const QByteArray& dane)
+{
+    if (!m_gra.ustawStanBinarny(dane))
+        return false;
+
+    // Nagranie sprzed wczytania nie pasuje juz do stanu planszy.
+    m_rejestrator.zakoncz();
+
+    m_zapisaneMiejsca = 0;
+    for (const auto& g : m_gra.gracze())
+        if (g.wygral())
+            m_zapisaneMiejsca |= 1 << (int)g.kolor();
+    m_scena->resetujTlo();
+
+    int indeks = m_comboGracze->findData(m_gra.gracze().size());
+    if (indeks >= 0)
+        m_comboGracze->setCurrentIndex(indeks);
+    return true;
+}
+
+// Wznowiona gra lokalna nie nagrywa powtorki (przywrocStan konczy nagranie nowej gry).
+void ChinczykWindow::wznowAutozapis()
+{
+    if (m_siecAktywna || m_trybPowtorki)
+        return;
+
+    QByteArray dane;
+    if (!GameSave::readAutosave(GameType::Chinczyk, Gra::WERSJA_STANU, m_config, &dane))
+        return;
+
+    auto odp = QMessageBox::question(
+        this,
+        "Przerwana gra",
+        "Wznowic przerwana gre?",
+        QMessageBox::Yes | QMessageBox::No
+        );
+
+    if (odp == QMessageBox::No || !przywrocStan(dane))
+        return;
+
+    GameSave::removeAutosave(GameType::Chinczyk);
+    statusBar()->showMessage("Wznowiono przerwana gre.", 5000);
+}
+
+void ChinczykWindow::autozapis()
+{
+    if (m_siecAktywna || m_trybPowtorki || !czyGraTrwa())
+        return;
+
+    GameSave::writeAutosave(GameType::Chinczyk, Gra::WERSJA_STANU, m_config, m_gra.stanBinarny());
+}
+
+void ChinczykWindow::otworzPowtorke()
+{
+    if (m_siecAktywna)
+        return;
+
+    QString sciezka = QFileDialog::getOpenFileName(this, "Otworz powtorke",
+                                                   RejestratorPowtorki::domyslnyKatalog(),
+                                                   "Powtorki Ludo (*.ludr)");
+    if (sciezka.isEmpty())
+        return;
+
+    QString blad;
+    if (!m_odtwarzacz.wczytaj(sciezka, &blad))
+    {
+        QMessageBox::warning(this, "Powtorka", blad);
+        return;
+    }
+
+    m_rejestrator.zakoncz();
+    m_trybPowtorki = true;
+
+    m_scena->resetujTlo();
+    m_panelPowtorki->setVisible(true);
+    m_btnPowtorka->setEnabled(false);
+
+    {
+        QSignalBlocker blok(m_suwakPowtorki);
+        m_suwakPowtorki->setRange(0, m_odtwarzacz.liczbaTur());
+        m_suwakPowtorki->setValue(0);
+    }
+    pokazTurePowtorki(0);
+
+    statusBar()->showMessage("Powtorka: " + QString::number(m_odtwarzacz.liczbaTur()) + " tur.", 5000);
+}
+
+void ChinczykWindow::pokazTurePowtorki(int tura)
+{
+    if (!m_trybPowtorki)
+        return;
+
+    m_gra.ustawStanBinarny(m_odtwarzacz.stanNaTurze(tura));
+    m_lblPowtorka->setText("Tura: " + QString::number(tura) + "/" + QString::number(m_odtwarzacz.liczbaTur()));
+}
+
+void ChinczykWindow::zamknijPowtorke()
+{
+    if (!m_trybPowtorki)
+        return;
+
+    m_trybPowtorki = false;
+    m_panelPowtorki->setVisible(false);
+    m_btnPowtorka->setEnabled(true);
+    m_comboGracze->setEnabled(true);
+
+    int n = m_comboGracze->currentData().toInt();
+    m_scena->resetujTlo();
+    m_gra.nowaGra(n);
+}
@@ -1,88 +1,137 @@
-#pragma once
-#include <QMainWindow>
-#include <QGraphicsView>
-#include <QPushButton>
-#include <QLabel>
-#include <QComboBox>
-#include <QCloseEvent>
-#include <QJsonObject>
-
-#include "gra.h"
-#include "boardscene.h"
-#include "game_config.h"
-#include "chinczyk_network.h"
-
-class ChinczykWindow : public QMainWindow
-{
-    Q_OBJECT
-public:
-    explicit ChinczykWindow(QWidget* parent = nullptr);
-    explicit ChinczykWindow(const GameLaunchConfig& config, QWidget* parent = nullptr);
-
-signals:
-    void gameClosed();
-
-protected:
-    void closeEvent(QCloseEvent* e) override;
-
-private:
-    void zbudujUI();
-    void podlaczSygnaly();
-
-    void initTryb();    
-    void initSiec();     
-
-    void startGrySieciowejHost();
-    void rozpocznijNowaGreSieciowaHost();
-
-    void ustawLobbyZJson(const QJsonObject& lobby);
-    void odswiezUiSieci();
-
-    bool czyMojaTura() const;
-    KolorGracza kolorDlaSlot(int slot) const;
-    Pionek* znajdzPionek(KolorGracza kolor, int id);
-
-    void obsluzRzutKlik();
-    void obsluzPionekKlik(Pionek* p);
-
-    void obsluzMsgHost(int slot, const QJsonObject& msg);
-    void obsluzMsgKlient(const QJsonObject& msg);
-
-    void wyslijStanJesliHost();
-    void wyslijGameOverJesliHost(const QString& zwyciezca);
-
-    bool lobbyPelne() const;
-    int liczbaPolaczonychWLobby() const;
-
-private:
-    GameLaunchConfig m_config;
-    Gra m_gra;
-    BoardScene* m_scena = nullptr;
-
-    QGraphicsView* m_view = nullptr;
-    QPushButton* m_btnNowa = nullptr;
-    QPushButton* m_btnRzut = nullptr;
-    QPushButton* m_btnStart = nullptr;
-
-    QComboBox* m_comboGracze = nullptr;
-    QLabel* m_lblRzut = nullptr;
-    QLabel* m_lblTura = nullptr;
-
-    QLabel* m_lblSiec = nullptr;
-    QLabel* m_lblLobby = nullptr;
-
-    bool m_siecAktywna = false;
-    bool m_jestemHostem = false;
-    bool m_graRozpoczeta = false;
-
-    int m_mojSlot = -1;          
-    int m_totalPlayers = 0;      
-    KolorGracza m_mojKolor = KolorGracza::Czerwony;
-
-    int m_ostatniGid = -1;
-
-    ChinczykSerwer m_serwer;
-    ChinczykKlient m_klient;
-    QJsonObject m_lobby;
-};
-
+#pragma once
+#include <QMainWindow>
+#include <QGraphicsView>
+#include <QPushButton>
+#include <QLabel>
+#include <QComboBox>
+#include <QSlider>
+#include <QCloseEvent>
+#include <QJsonObject>
+#include <QMap>
+
+#include "gra.h"
+#include "boardscene.h"
+#include "game_config.h"
+#include "chinczyk_network.h"
+#include "powtorka.h"
+
+class ChinczykWindow : public QMainWindow
+{
+    Q_OBJECT
+public:
+    explicit ChinczykWindow(QWidget* parent = nullptr);
+    explicit ChinczykWindow(const GameLaunchConfig& config, QWidget* parent = nullptr);
+
+    // Okno z puli launchera: wstrzymaj() zamyka siec i nagrywanie, resetuj() zaczyna od nowa
+    // z nowa konfiguracja bez ponownego budowania UI i sceny.
+    void resetuj(const GameLaunchConfig& config);
+    void wstrzymaj();
+
+signals:
+    void gameClosed();
+
+protected:
+    void closeEvent(QCloseEvent* e) override;
+
+private:
+    void zbudujUI();
+    void podlaczSygnaly();
+
+    void initTryb();    
+    void initSiec();     
+
+    void startGrySieciowejHost();
+    void rozpocznijNowaGreSieciowaHost();
+
+    void ustawLobbyZJson(const QJsonObject& lobby);
+    void odswiezUiSieci();
+
+    bool czyMojaTura() const;
+    KolorGracza kolorDlaSlot(int slot) const;
+    Pionek* znajdzPionek(KolorGracza kolor, int id);
+
+    void obsluzRzutKlik();
+    void obsluzPionekKlik(Pionek* p);
+
+    void obsluzMsgHost(int slot, const QJsonObject& msg);
+    void obsluzMsgKlient(const QJsonObject& msg);
+
+    void wyslijStanJesliHost();
+    void wyslijGameOverJesliHost(const QString& zwyciezca);
+    void ujawnijZiarnoJesliHost();
+
+    void zapamietajRzut(const QJsonObject& stan);
+    void zweryfikujRzuty(quint64 ziarno);
+
+    bool lobbyPelne() const;
+    int liczbaPolaczonychWLobby() const;
+
+    QString nazwaGracza(KolorGracza kolor) const;
+    void zapiszMiejsce(const QString& zwyciezca);
+    void zapiszPozostalych();
+
+    bool czyGraTrwa() const;
+    void zapiszGre();
+    void wczytajGre();
+    bool wczytajZapis(const QString& sciezka, QString* blad);
+    bool przywrocStan(const QByteArray& dane);
+    void wznowAutozapis();
+    void autozapis();
+
+    void otworzPowtorke();
+    void pokazTurePowtorki(int tura);
+    void zamknijPowtorke();
+
+private:
+    GameLaunchConfig m_config;
+    Gra m_gra;
+    BoardScene* m_scena = nullptr;
+
+    QGraphicsView* m_view = nullptr;
+    QPushButton* m_btnNowa = nullptr;
+    QPushButton* m_btnRzut = nullptr;
+    QPushButton* m_btnStart = nullptr;
+    QPushButton* m_btnCofnij = nullptr;
+    QPushButton* m_btnPonow = nullptr;
+
+    QComboBox* m_comboGracze = nullptr;
+    QLabel* m_lblRzut = nullptr;
+    QLabel* m_lblTura = nullptr;
+
+    QLabel* m_lblSiec = nullptr;
+    QLabel* m_lblLobby = nullptr;
+
+    QPushButton* m_btnPowtorka = nullptr;
+    QPushButton* m_btnZapisz = nullptr;
+    QPushButton* m_btnWczytaj = nullptr;
+    QWidget* m_panelPowtorki = nullptr;
+    QSlider* m_suwakPowtorki = nullptr;
+    QLabel* m_lblPowtorka = nullptr;
+
+    bool m_siecAktywna = false;
+    bool m_jestemHostem = false;
+    bool m_graRozpoczeta = false;
+    bool m_trybPowtorki = false;
+
+    int m_mojSlot = -1;          
+    int m_totalPlayers = 0;      
+    KolorGracza m_mojKolor = KolorGracza::Czerwony;
+
+    int m_ostatniGid = -1;
+
+    ChinczykSerwer m_serwer;
+    ChinczykKlient m_klient;
+    QJsonObject m_lobby;
+
+    bool m_ziarnoUjawnione = true;
+    QString m_zobowiazanie;
+    int m_gidZobowiazania = -1;
+    QMap<int, int> m_obserwowaneRzuty;
+
+    int m_snapshot = 0;
+    quint8 m_zapisaneMiejsca = 0;   // bit = kolor, ktorego wynik trafil juz do statystyk w tej grze
+
+    RejestratorPowtorki m_rejestrator;
+    OdtwarzaczPowtorki m_odtwarzacz;
+};
+
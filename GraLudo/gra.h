@@ -1,61 +1,133 @@
-#pragma once
-#include <QObject>
-#include <QVector>
-#include "gracz.h"
-#include <QJsonObject>
-
-class Gra : public QObject
-{
-    Q_OBJECT
-public:
-    explicit Gra(QObject* parent = nullptr);
-
-    void nowaGra(int liczbaGraczy);
-
-    QVector<Gracz>& gracze() { return m_gracze; }
-    const QVector<Gracz>& gracze() const { return m_gracze; }
-    int aktualnyIndex() const { return m_aktualnyIndex; }
-    const Gracz& aktualnyGracz() const { return m_gracze[m_aktualnyIndex]; }
-    Gracz& aktualnyGracz() { return m_gracze[m_aktualnyIndex]; }
-
-    int ostatniRzut() const { return m_ostatniRzut; }
-    bool czyRzucono() const { return m_rzucono; }
-    bool czyOczekujeNaDecyzje() const { return m_oczekujeNaDecyzje; }
-    int rzutKostka();
-    QVector<Pionek*> mozliwePionki();
-
-    bool wykonajRuch(Pionek* pionek);
-
-    bool moznaKontynuowacPoWygranej() const;
-    void kontynuujPoWygranej();
-    int idGry() const { return m_idGry; }
-
-    QJsonObject stanJson() const;
-    void ustawStanJson(const QJsonObject& j);
-
-
-signals:
-    void stanZmieniony();
-    void komunikat(const QString& tekst);
-    void koniecGry(const QString& zwyciezca);
-
-private:
-    int absIndexDla(const Gracz& g, int krokRel) const;
-    int policzNaPoluAbs(int abs, KolorGracza kolor) const;
-    int maksNaPoluAbs(int abs) const; 
-    bool czyJestBlokadaNaAbs(int abs) const;
-
-    bool czyPrzejscieZablokowane(const Gracz& g, const Pionek& p, int oczka) const;
-    bool czyRuchDozwolony(const Gracz& g, const Pionek& p, int oczka) const;
-
-    void zbicieJesliTrzeba(const Gracz& gRuszajacy, int absDocelowy, KolorGracza kolorRuszajacego);
-    void nastepnyGracz();
-    bool m_oczekujeNaDecyzje = false;
-
-    QVector<Gracz> m_gracze;
-    int m_aktualnyIndex = 0;
-    int m_ostatniRzut = 0;
-    bool m_rzucono = false;
-    int m_idGry = 0;
-};
-
+#pragma once
+#include <QObject>
+#include <QVector>
+#include "gracz.h"
+#include "kostka.h"
+#include <QJsonObject>
+#include <QByteArray>
+
+// Wpis dziennika ruchow: tyle, ile trzeba do cofniecia/ponowienia ruchu w O(1).
+struct RuchDziennika
+{
+    qint8 gracz = 0;
+    qint8 pionek = 0;
+    qint8 zKroku = -1;
+    qint8 naKrok = -1;
+    qint8 zbityGracz = -1;
+    qint8 zbityPionek = -1;
+    qint8 zbityKrok = -1;
+    qint8 rzut = 0;
+    qint8 turaPo = 0;
+    qint8 rzutPo = 0;
+    bool oczekujePo = false;
+};
+
+class Gra : public QObject
+{
+    Q_OBJECT
+public:
+    enum Zmiana
+    {
+        ZmianaBrak = 0x0,
+        ZmianaPionki = 0x1,
+        ZmianaTura = 0x2,
+        ZmianaRzut = 0x4,
+        ZmianaGra = 0x8,
+        ZmianaWszystko = 0xF
+    };
+    Q_DECLARE_FLAGS(Zmiany, Zmiana)
+
+    explicit Gra(QObject* parent = nullptr);
+
+    void nowaGra(int liczbaGraczy, quint64 ziarno = 0);
+    // Pusta plansza jak po konstrukcji (bez graczy); uniewaznia zaplanowane pominiecie tury.
+    void wyczysc();
+
+    QVector<Gracz>& gracze() { return m_gracze; }
+    const QVector<Gracz>& gracze() const { return m_gracze; }
+    int aktualnyIndex() const { return m_aktualnyIndex; }
+    const Gracz& aktualnyGracz() const { return m_gracze[m_aktualnyIndex]; }
+    Gracz& aktualnyGracz() { return m_gracze[m_aktualnyIndex]; }
+
+    int ostatniRzut() const { return m_ostatniRzut; }
+    bool czyRzucono() const { return m_rzucono; }
+    bool czyOczekujeNaDecyzje() const { return m_oczekujeNaDecyzje; }
+    int rzutKostka();
+    int zastosujRzut(int oczka);
+    void pominTure();
+    void ustawOpoznieniePominiecia(int ms) { m_opoznieniePominiecia = ms; }
+    QVector<Pionek*> mozliwePionki();
+
+    bool wykonajRuch(Pionek* pionek);
+
+    bool czyMoznaCofnac() const;
+    bool czyMoznaPonowic() const;
+    bool cofnijRuch();
+    bool ponowRuch();
+    const QVector<RuchDziennika>& dziennik() const { return m_dziennik; }
+    int pozycjaDziennika() const { return m_pozycjaDziennika; }
+
+    bool moznaKontynuowacPoWygranej() const;
+    void kontynuujPoWygranej();
+    int idGry() const { return m_idGry; }
+    quint64 ziarno() const { return m_kostka.ziarno(); }
+    int liczbaRzutow() const { return m_liczbaRzutow; }
+
+    QJsonObject stanJson() const;
+    void ustawStanJson(const QJsonObject& j);
+
+    // Wersja ukladu stanBinarny() w plikach zapisu (GameSave); zmiana ukladu = nowa wersja.
+    static constexpr quint8 WERSJA_STANU = 1;
+    QByteArray stanBinarny() const;
+    bool ustawStanBinarny(const QByteArray& dane);
+
+    // Wypycha zalegle powiadomienie od razu, zamiast czekac na petle zdarzen.
+    void wyslijZmiany();
+
+signals:
+    void stanZmieniony(Gra::Zmiany zmiany);
+    void komunikat(const QString& tekst);
+    void koniecGry(const QString& zwyciezca);
+
+    void nowaGraRozpoczeta(int liczbaGraczy);
+    void rzutWykonany(KolorGracza kolor, int oczka);
+    void ruchWykonany(KolorGracza kolor, int idPionka);
+    void kontynuowano();
+    void ruchCofniety();
+    void ruchPonowiony();
+
+private:
+    int absIndexDla(const Gracz& g, int krokRel) const;
+    int policzNaPoluAbs(int abs, KolorGracza kolor) const;
+    int maksNaPoluAbs(int abs) const; 
+    bool czyJestBlokadaNaAbs(int abs) const;
+
+    bool czyPrzejscieZablokowane(const Gracz& g, const Pionek& p, int oczka) const;
+    bool czyRuchDozwolony(const Gracz& g, const Pionek& p, int oczka) const;
+
+    void zbicieJesliTrzeba(const Gracz& gRuszajacy, int absDocelowy, KolorGracza kolorRuszajacego, RuchDziennika& wpis);
+    void zapiszWDzienniku(RuchDziennika& wpis);
+    void wyczyscDziennik();
+    void nastepnyGracz();
+    void zglosZmiane(Zmiany zmiany);
+    bool m_oczekujeNaDecyzje = false;
+
+    Zmiany m_brudne;
+    bool m_zaplanowano = false;
+
+    QVector<Gracz> m_gracze;
+    int m_aktualnyIndex = 0;
+    int m_ostatniRzut = 0;
+    bool m_rzucono = false;
+    int m_idGry = 0;
+    int m_opoznieniePominiecia = 650;
+
+    Kostka m_kostka;
+    int m_liczbaRzutow = 0;
+
+    QVector<RuchDziennika> m_dziennik;
+    int m_pozycjaDziennika = 0;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(Gra::Zmiany)
+
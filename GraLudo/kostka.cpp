@@ -1,7 +1,6 @@
-#include "kostka.h"
-#include <QRandomGenerator>
-
-int Kostka::rzut()
-{
-    return QRandomGenerator::global()->bounded(1, 7);
-}
+#include "kostka.h"
+
+int Kostka::rzut()
+{
+    return m_rng.bounded(1, 7);
+}
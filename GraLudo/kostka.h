@@ -1,8 +1,18 @@
-#pragma once
-
-class Kostka
-{
-public:
-    static int rzut(); 
-};
-
+#pragma once
+#include "game_rng.h"
+
+class Kostka
+{
+public:
+    explicit Kostka(quint64 ziarno = GameRng::randomSeed()) : m_rng(ziarno) {}
+
+    int rzut(); 
+
+    void ustawZiarno(quint64 ziarno) { m_rng.reseed(ziarno); }
+    void przywroc(quint64 ziarno, quint64 stan) { m_rng.restore(ziarno, stan); }
+    quint64 ziarno() const { return m_rng.seed(); }
+    quint64 stan() const { return m_rng.state(); }
+
+private:
+    GameRng m_rng;
+};
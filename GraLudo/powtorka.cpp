@@ -0,0 +1,259 @@
+#include "powtorka.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QStandardPaths>
+#include <cstring>
+#include <algorithm>
+
+static const char MAGIA[4] = { 'L', 'U', 'D', 'R' };
+static const quint16 WERSJA_POWTORKI = 1;
+static const int ROZMIAR_NAGLOWKA = 24;
+static const int ROZMIAR_REKORDU = 4;
+static const int KROK_KLATEK = 64;
+
+RejestratorPowtorki::RejestratorPowtorki(QObject* parent) : QObject(parent)
+{
+}
+
+RejestratorPowtorki::~RejestratorPowtorki()
+{
+    zakoncz();
+}
+
+QString RejestratorPowtorki::domyslnyKatalog()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/powtorki";
+}
+
+void RejestratorPowtorki::podlacz(Gra* gra)
+{
+    odlacz();
+    m_gra = gra;
+
+    connect(gra, &Gra::nowaGraRozpoczeta, this, [this](int n){
+        rozpocznij(n);
+    });
+    connect(gra, &Gra::rzutWykonany, this, [this](KolorGracza k, int oczka){
+        dopisz(TypRekordu::Rzut, (int)k, oczka);
+    });
+    connect(gra, &Gra::ruchWykonany, this, [this](KolorGracza k, int id){
+        dopisz(TypRekordu::Ruch, (int)k, id);
+    });
+    connect(gra, &Gra::kontynuowano, this, [this](){
+        dopisz(TypRekordu::Kontynuacja, 0, 0);
+    });
+    connect(gra, &Gra::ruchCofniety, this, [this](){
+        dopisz(TypRekordu::Cofniecie, 0, 0);
+    });
+    connect(gra, &Gra::ruchPonowiony, this, [this](){
+        dopisz(TypRekordu::Ponowienie, 0, 0);
+    });
+}
+
+void RejestratorPowtorki::odlacz()
+{
+    if (m_gra)
+        disconnect(m_gra, nullptr, this, nullptr);
+    m_gra = nullptr;
+    zakoncz();
+}
+
+void RejestratorPowtorki::rozpocznij(int liczbaGraczy)
+{
+    zakoncz();
+
+    QString katalog = domyslnyKatalog();
+    QDir().mkpath(katalog);
+
+    QDateTime teraz = QDateTime::currentDateTime();
+    m_plik.setFileName(katalog + "/ludo_" + teraz.toString("yyyyMMdd_HHmmss_zzz") + ".ludr");
+    if (!m_plik.open(QIODevice::WriteOnly))
+        return;
+
+    QByteArray naglowek;
+    QDataStream out(&naglowek, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.writeRawData(MAGIA, 4);
+    out << WERSJA_POWTORKI << (quint8)liczbaGraczy << (quint8)0
+        << (quint64)(m_gra ? m_gra->ziarno() : 0) << (qint64)teraz.toMSecsSinceEpoch();
+
+    m_plik.write(naglowek);
+    m_plik.flush();
+}
+
+void RejestratorPowtorki::dopisz(TypRekordu typ, int kolor, int wartosc)
+{
+    if (!m_plik.isOpen())
+        return;
+
+    // Flush po kazdym rekordzie - po awarii zostaje wszystko poza ewentualnie ostatnim rekordem.
+    const char r[ROZMIAR_REKORDU] = { (char)typ, (char)kolor, (char)wartosc, 0 };
+    m_plik.write(r, ROZMIAR_REKORDU);
+    m_plik.flush();
+}
+
+void RejestratorPowtorki::zakoncz()
+{
+    if (m_plik.isOpen())
+        m_plik.close();
+}
+
+OdtwarzaczPowtorki::OdtwarzaczPowtorki()
+{
+    m_gra.ustawOpoznieniePominiecia(0);
+}
+
+bool OdtwarzaczPowtorki::wczytaj(const QString& sciezka, QString* blad)
+{
+    auto porazka = [blad](const QString& tekst){
+        if (blad) *blad = tekst;
+        return false;
+    };
+
+    QFile f(sciezka);
+    if (!f.open(QIODevice::ReadOnly))
+        return porazka("Nie mozna otworzyc pliku.");
+
+    QByteArray dane = f.readAll();
+    if (dane.size() < ROZMIAR_NAGLOWKA || std::memcmp(dane.constData(), MAGIA, 4) != 0)
+        return porazka("To nie jest plik powtorki.");
+
+    QDataStream in(dane);
+    in.setByteOrder(QDataStream::LittleEndian);
+    in.skipRawData(4);
+
+    quint16 wersja = 0;
+    quint8 liczba = 0, rezerwa = 0;
+    in >> wersja >> liczba >> rezerwa >> m_ziarno >> m_czasStartu;
+
+    if (wersja != WERSJA_POWTORKI)
+        return porazka("Nieobslugiwana wersja powtorki.");
+    if (liczba < 2 || liczba > 4)
+        return porazka("Uszkodzony naglowek powtorki.");
+
+    m_liczbaGraczy = liczba;
+    m_rekordy.clear();
+    m_cofniete.clear();
+    m_poczatkiTur.clear();
+    m_klatki.clear();
+
+    const int n = (dane.size() - ROZMIAR_NAGLOWKA) / ROZMIAR_REKORDU;
+    m_rekordy.reserve(n);
+    m_klatki.reserve(n / KROK_KLATEK + 1);
+
+    m_gra.nowaGra(m_liczbaGraczy);
+    m_klatki.push_back(m_gra.stanBinarny());
+
+    // Rekordy sa walidowane przez zasady Gra - pierwszy niedozwolony konczy powtorke.
+    const char* p = dane.constData() + ROZMIAR_NAGLOWKA;
+    for (int i = 0; i < n; ++i, p += ROZMIAR_REKORDU)
+    {
+        RekordPowtorki r;
+        r.typ = (TypRekordu)(quint8)p[0];
+        r.kolor = (quint8)p[1];
+        r.wartosc = (quint8)p[2];
+
+        if (r.typ == TypRekordu::Cofniecie || r.typ == TypRekordu::Ponowienie)
+        {
+            if (!zastosujCofniecie(r.typ))
+                break;
+            continue;
+        }
+
+        if (!zastosuj(r))
+            break;
+        m_cofniete.clear();
+
+        if (r.typ == TypRekordu::Rzut)
+            m_poczatkiTur.push_back(m_rekordy.size());
+        m_rekordy.push_back(r);
+
+        if (m_rekordy.size() % KROK_KLATEK == 0)
+            m_klatki.push_back(m_gra.stanBinarny());
+    }
+
+    return true;
+}
+
+// Cofniecia nie trafiaja do m_rekordy: ruch jest zdejmowany z konca listy, wiec
+// przewijanie z klatek kluczowych nigdy nie potrzebuje dziennika Gra.
+bool OdtwarzaczPowtorki::zastosujCofniecie(TypRekordu typ)
+{
+    if (typ == TypRekordu::Cofniecie)
+    {
+        if (m_rekordy.isEmpty() || m_rekordy.last().typ != TypRekordu::Ruch || !m_gra.cofnijRuch())
+            return false;
+
+        m_cofniete.push_back(m_rekordy.takeLast());
+        if ((m_klatki.size() - 1) * KROK_KLATEK > m_rekordy.size())
+            m_klatki.removeLast();
+        return true;
+    }
+
+    if (m_cofniete.isEmpty() || !m_gra.ponowRuch())
+        return false;
+
+    m_rekordy.push_back(m_cofniete.takeLast());
+    if (m_rekordy.size() % KROK_KLATEK == 0)
+        m_klatki.push_back(m_gra.stanBinarny());
+    return true;
+}
+
+bool OdtwarzaczPowtorki::zastosuj(const RekordPowtorki& r)
+{
+    if (m_gra.gracze().isEmpty())
+        return false;
+
+    switch (r.typ)
+    {
+    case TypRekordu::Rzut:
+        if (r.wartosc < 1 || r.wartosc > 6) return false;
+        if ((int)m_gra.aktualnyGracz().kolor() != r.kolor) return false;
+        if (m_gra.czyRzucono() || m_gra.czyOczekujeNaDecyzje()) return false;
+        m_gra.zastosujRzut(r.wartosc);
+        return true;
+
+    case TypRekordu::Ruch:
+    {
+        if ((int)m_gra.aktualnyGracz().kolor() != r.kolor) return false;
+        auto& pionki = m_gra.aktualnyGracz().pionki();
+        if (r.wartosc >= pionki.size()) return false;
+        return m_gra.wykonajRuch(&pionki[r.wartosc]);
+    }
+
+    case TypRekordu::Kontynuacja:
+        if (!m_gra.czyOczekujeNaDecyzje()) return false;
+        m_gra.kontynuujPoWygranej();
+        return true;
+
+    case TypRekordu::Cofniecie:
+    case TypRekordu::Ponowienie:
+        break;
+    }
+    return false;
+}
+
+QByteArray OdtwarzaczPowtorki::stanPoRekordach(int n)
+{
+    if (m_klatki.isEmpty())
+        return QByteArray();
+
+    if (n < 0) n = 0;
+    if (n > m_rekordy.size()) n = m_rekordy.size();
+
+    int k = std::min<int>(n / KROK_KLATEK, m_klatki.size() - 1);
+    m_gra.ustawStanBinarny(m_klatki[k]);
+
+    for (int i = k * KROK_KLATEK; i < n; ++i)
+        zastosuj(m_rekordy[i]);
+
+    return m_gra.stanBinarny();
+}
+
+QByteArray OdtwarzaczPowtorki::stanNaTurze(int tura)
+{
+    if (tura < 0) tura = 0;
+    int n = (tura < m_poczatkiTur.size()) ? m_poczatkiTur[tura] : m_rekordy.size();
+    return stanPoRekordach(n);
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <QObject>
+#include <QFile>
+#include <QVector>
+#include <QByteArray>
+#include "gra.h"
+
+// Plik powtorki: naglowek (24 B) + rekordy stalej dlugosci (4 B), little-endian.
+enum class TypRekordu : quint8 { Rzut = 1, Ruch = 2, Kontynuacja = 3, Cofniecie = 4, Ponowienie = 5 };
+
+struct RekordPowtorki
+{
+    TypRekordu typ = TypRekordu::Rzut;
+    quint8 kolor = 0;
+    quint8 wartosc = 0;     // oczka dla Rzut, id pionka dla Ruch
+};
+
+class RejestratorPowtorki : public QObject
+{
+    Q_OBJECT
+public:
+    explicit RejestratorPowtorki(QObject* parent = nullptr);
+    ~RejestratorPowtorki();
+
+    static QString domyslnyKatalog();
+
+    void podlacz(Gra* gra);
+    void odlacz();
+    void zakoncz();
+
+    QString sciezka() const { return m_plik.fileName(); }
+
+private:
+    void rozpocznij(int liczbaGraczy);
+    void dopisz(TypRekordu typ, int kolor, int wartosc);
+
+    Gra* m_gra = nullptr;
+    QFile m_plik;
+};
+
+class OdtwarzaczPowtorki
+{
+public:
+    OdtwarzaczPowtorki();
+
+    bool wczytaj(const QString& sciezka, QString* blad = nullptr);
+
+    int liczbaGraczy() const { return m_liczbaGraczy; }
+    quint64 ziarno() const { return m_ziarno; }
+    qint64 czasStartu() const { return m_czasStartu; }
+    int liczbaTur() const { return m_poczatkiTur.size(); }
+    int liczbaRekordow() const { return m_rekordy.size(); }
+    const RekordPowtorki& rekord(int i) const { return m_rekordy[i]; }
+
+    // Stan tuz przed rzutem w turze `tura`; tura == liczbaTur() daje stan koncowy.
+    QByteArray stanNaTurze(int tura);
+    QByteArray stanPoRekordach(int n);
+
+private:
+    bool zastosuj(const RekordPowtorki& r);
+    bool zastosujCofniecie(TypRekordu typ);
+
+    Gra m_gra;
+    int m_liczbaGraczy = 0;
+    quint64 m_ziarno = 0;
+    qint64 m_czasStartu = 0;
+
+    QVector<RekordPowtorki> m_rekordy;
+    QVector<RekordPowtorki> m_cofniete;
+    QVector<int> m_poczatkiTur;
+    QVector<QByteArray> m_klatki;    // m_klatki[i] = stan po i * KROK_KLATEK rekordach
+};
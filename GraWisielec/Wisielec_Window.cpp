@@ -1,394 +1,513 @@
-#include "wisielec_window.h"
-#include <QVBoxLayout>
-#include <QHBoxLayout>
-#include <QGridLayout>
-#include <QMessageBox>
-#include <QPainter>
-#include <cmath>
-#include <QRandomGenerator>
-
-const QString STYLE_BTN_DEFAULT = "QPushButton { background-color: #2196F3; color: white; font-weight: bold; border-radius: 5px; font-size: 14px; } QPushButton:hover { background-color: #1976D2; } QPushButton:disabled { background-color: #ccc; color: #666; }";
-const QString STYLE_BTN_CORRECT = "QPushButton { background-color: #4CAF50; color: white; font-weight: bold; border-radius: 5px; font-size: 14px; }";
-const QString STYLE_BTN_WRONG   = "QPushButton { background-color: #f44336; color: white; font-weight: bold; border-radius: 5px; font-size: 14px; }";
-
-WisielecWindow::WisielecWindow(const GameLaunchConfig &cfg, QWidget *parent)
-    : QMainWindow(parent), config(cfg), server(nullptr), socket(nullptr)
-{
-    logic = new WisielecLogic(this);
-
-    connect(logic, &WisielecLogic::wordSet, this, &WisielecWindow::onWordSet);
-    connect(logic, &WisielecLogic::letterGuessed, this, &WisielecWindow::onLetterGuessed);
-    connect(logic, &WisielecLogic::gameStateChanged, this, &WisielecWindow::onGameStateChanged);
-    connect(logic, &WisielecLogic::errorsChanged, this, &WisielecWindow::onErrorsChanged);
-
-    setupUI();
-    createHangmanImages();
-
-    if(config.mode == GameMode::NetHost) amISetter = true;
-    else if(config.mode == GameMode::NetClient) amISetter = false;
-    else amISetter = true;
-
-    initGame();
-    resize(800, 600);
-}
-
-WisielecWindow::~WisielecWindow() {
-    if(server) server->close();
-    if(socket) socket->close();
-}
-
-void WisielecWindow::closeEvent(QCloseEvent *event) {
-    emit gameClosed();
-    QMainWindow::closeEvent(event);
-}
-
-void WisielecWindow::onBackToMenu() {
-    emit gameClosed();
-}
-
-void WisielecWindow::setupUI() {
-    QWidget *central = new QWidget(this);
-    setCentralWidget(central);
-    QVBoxLayout *mainLayout = new QVBoxLayout(central);
-
-    QHBoxLayout *topBar = new QHBoxLayout();
-    QPushButton *btnMenu = new QPushButton("Powrót do Menu", this);
-    connect(btnMenu, &QPushButton::clicked, this, &WisielecWindow::onBackToMenu);
-    topBar->addWidget(btnMenu);
-    topBar->addStretch();
-    mainLayout->addLayout(topBar);
-
-    stack = new QStackedWidget(this);
-    mainLayout->addWidget(stack);
-
-    pageWait = new QWidget(this);
-    QVBoxLayout *waitLay = new QVBoxLayout(pageWait);
-    waitLabel = new QLabel("Inicjalizacja...", this);
-    waitLabel->setAlignment(Qt::AlignCenter);
-    waitLabel->setStyleSheet("font-size: 18px;");
-    waitLay->addWidget(waitLabel);
-    stack->addWidget(pageWait);
-
-    pageSetup = new QWidget(this);
-    QVBoxLayout *setupLay = new QVBoxLayout(pageSetup);
-    QLabel *setupLbl = new QLabel("Ustaw hasło dla przeciwnika:", this);
-    setupLbl->setAlignment(Qt::AlignCenter);
-    setupLay->addWidget(setupLbl);
-    wordInput = new QLineEdit(this);
-    wordInput->setEchoMode(QLineEdit::Password);
-    wordInput->setAlignment(Qt::AlignCenter);
-    setupLay->addWidget(wordInput);
-    QPushButton *btnConfirm = new QPushButton("Zatwierdź", this);
-    connect(btnConfirm, &QPushButton::clicked, this, &WisielecWindow::confirmWord);
-    setupLay->addWidget(btnConfirm);
-    setupLay->addStretch();
-    stack->addWidget(pageSetup);
-
-    pageGame = new QWidget(this);
-    QHBoxLayout *gameLay = new QHBoxLayout(pageGame);
-
-    QVBoxLayout *left = new QVBoxLayout();
-    hangmanLabel = new QLabel(this);
-    hangmanLabel->setStyleSheet("border: 2px solid #ccc; background: white;");
-    hangmanLabel->setAlignment(Qt::AlignCenter);
-    left->addWidget(hangmanLabel);
-    errorsLabel = new QLabel("Błędy: 0/0");
-    errorsLabel->setAlignment(Qt::AlignCenter);
-    left->addWidget(errorsLabel);
-    gameLay->addLayout(left, 1);
-
-    QVBoxLayout *right = new QVBoxLayout();
-    maskedWordLabel = new QLabel("...");
-    maskedWordLabel->setStyleSheet("font-size: 24px; font-weight: bold;");
-    maskedWordLabel->setAlignment(Qt::AlignCenter);
-    right->addWidget(maskedWordLabel);
-
-    statusLabel = new QLabel("");
-    statusLabel->setAlignment(Qt::AlignCenter);
-    right->addWidget(statusLabel);
-
-    QWidget *kbd = new QWidget();
-    QGridLayout *grid = new QGridLayout(kbd);
-    QString chars = "AĄBCĆDEĘFGHIJKLŁMNŃOÓPQRSŚTUVWXYZŹŻ";
-    int r=0, c=0;
-    for(QChar ch : chars) {
-        QPushButton *b = new QPushButton(QString(ch));
-        b->setFixedSize(35,35);
-        b->setStyleSheet(STYLE_BTN_DEFAULT);
-        connect(b, &QPushButton::clicked, this, &WisielecWindow::onLetterClicked);
-        letterButtons[ch] = b;
-        grid->addWidget(b, r, c++);
-        if(c>8) { c=0; r++; }
-    }
-    right->addWidget(kbd);
-    gameLay->addLayout(right, 1);
-
-    stack->addWidget(pageGame);
-}
-
-void WisielecWindow::initGame() {
-    if(config.mode == GameMode::Solo) {
-        amISetter = false;
-        stack->setCurrentWidget(pageGame);
-        logic->generateRandomWord();
-        resetBoard();
-    }
-    else if(config.mode == GameMode::LocalDuo) {
-        amISetter = true;
-        stack->setCurrentWidget(pageSetup);
-    }
-    else if(config.mode == GameMode::NetHost) {
-        stack->setCurrentWidget(pageWait);
-        waitLabel->setText("Serwer startuje na porcie " + QString::number(config.port));
-        server = new QTcpServer(this);
-        connect(server, &QTcpServer::newConnection, this, &WisielecWindow::onNewConnection);
-        if(!server->listen(QHostAddress::Any, config.port)) {
-            QMessageBox::critical(this, "Błąd", "Nie można uruchomić serwera!");
-            emit gameClosed();
-        }
-    }
-    else if(config.mode == GameMode::NetClient) {
-        stack->setCurrentWidget(pageWait);
-        waitLabel->setText("Łączenie...");
-        socket = new QTcpSocket(this);
-        connect(socket, &QTcpSocket::connected, this, &WisielecWindow::onConnected);
-        connect(socket, &QTcpSocket::readyRead, this, &WisielecWindow::onSocketReadyRead);
-        connect(socket, &QTcpSocket::disconnected, this, &WisielecWindow::onSocketDisconnected);
-        socket->connectToHost(config.hostIp, config.port);
-    }
-}
-
-void WisielecWindow::confirmWord() {
-    QString w = wordInput->text().trimmed();
-    if(!WisielecLogic::isValidWord(w.toUpper())) {
-        QMessageBox::warning(this, "Błąd", "Tylko litery!");
-        return;
-    }
-
-    if(config.mode == GameMode::NetClient && amISetter) {
-        sendNetworkPacket("SET_WORD", w);
-        stack->setCurrentWidget(pageGame);
-        for(auto b : letterButtons) b->setEnabled(false);
-        statusLabel->setText("Czekam na ruch Hosta...");
-    } else {
-        logic->setWord(w);
-    }
-}
-
-void WisielecWindow::onLetterClicked() {
-    QPushButton *b = qobject_cast<QPushButton*>(sender());
-    if(!b) return;
-    QChar c = b->text()[0];
-
-    if(amISetter && config.mode != GameMode::LocalDuo) return;
-
-    if(config.mode == GameMode::NetClient) {
-        sendNetworkPacket("GUESS", QString(c));
-        b->setEnabled(false);
-    } else {
-        logic->guessLetter(c);
-    }
-}
-
-void WisielecWindow::sendNetworkPacket(const QString &type, const QString &payload) {
-    if(socket && socket->state() == QAbstractSocket::ConnectedState) {
-        socket->write((type + "|" + payload + "\n").toUtf8());
-    }
-}
-
-void WisielecWindow::onSocketReadyRead() {
-    while(socket->canReadLine()) {
-        QString line = QString::fromUtf8(socket->readLine()).trimmed();
-        processNetworkPacket("", line);
-    }
-}
-
-void WisielecWindow::processNetworkPacket(const QString&, const QString &line) {
-    QStringList parts = line.split('|');
-    if(parts.empty()) return;
-    QString type = parts[0];
-    QString data = parts.length() > 1 ? parts[1] : "";
-
-    if(config.mode == GameMode::NetHost) {
-        if(type == "GUESS" && !data.isEmpty()) logic->guessLetter(data[0]);
-        else if(type == "SET_WORD") logic->setWord(data);
-    } else {
-        if(type == "UPDATE") updateNetworkUI(data);
-    }
-}
-
-void WisielecWindow::updateNetworkUI(const QString &payload) {
-    QStringList p = payload.split(';');
-    if(p.size() < 4) return;
-
-    if(p.size() > 5) amISetter = !(p[5].toInt() == 1);
-
-    int st = p[3].toInt();
-    if(st == (int)WisielecLogic::GameState::WaitingForWord) {
-        resetBoard();
-        wordInput->clear();
-        stack->setCurrentWidget(amISetter ? pageSetup : pageWait);
-        if(!amISetter) waitLabel->setText("Przeciwnik ustawia słowo...");
-        return;
-    } else if (stack->currentWidget() != pageGame) {
-        stack->setCurrentWidget(pageGame);
-        resetBoard();
-    }
-
-    maskedWordLabel->setText(p[0]);
-    errorsLabel->setText(QString("Błędy: %1/%2").arg(p[1]).arg(p[2]));
-
-    int err = p[1].toInt();
-    if(hangmanImages.contains(err)) hangmanLabel->setPixmap(hangmanImages[err]);
-
-    QString used = p.size() > 4 ? p[4] : "";
-    for(auto k : letterButtons.keys()) {
-        if(used.contains(k)) {
-            QPushButton *btn = letterButtons[k];
-            btn->setEnabled(false);
-
-            if(p[0].contains(k)) {
-                btn->setStyleSheet(STYLE_BTN_CORRECT);
-            } else {
-                btn->setStyleSheet(STYLE_BTN_WRONG);
-            }
-        }
-    }
-
-    if(st == (int)WisielecLogic::GameState::Won) handleGameOver(true);
-    else if(st == (int)WisielecLogic::GameState::Lost) handleGameOver(false);
-}
-
-void WisielecWindow::onWordSet(const QString &m) {
-    if(stack->currentWidget() != pageGame) {
-        stack->setCurrentWidget(pageGame);
-        resetBoard();
-    }
-
-    if (config.mode != GameMode::LocalDuo && amISetter) {
-        for(auto b : letterButtons) b->setEnabled(false);
-        statusLabel->setText("Przeciwnik zgaduje Twoje hasło...");
-    } else {
-        statusLabel->setText("Zgaduj hasło!");
-    }
-
-    maskedWordLabel->setText(m);
-    updateHangmanImage();
-
-    if(config.mode == GameMode::NetHost) {
-        QString pl = QString("%1;0;%2;%3;;%4").arg(m).arg(logic->getMaxErrors())
-        .arg((int)WisielecLogic::GameState::Playing).arg(amISetter?1:0);
-        sendNetworkPacket("UPDATE", pl);
-    }
-}
-
-void WisielecWindow::onLetterGuessed(QChar c, bool ok) {
-    if(letterButtons.contains(c)) {
-        QPushButton *btn = letterButtons[c];
-        btn->setEnabled(false);
-        btn->setStyleSheet(ok ? STYLE_BTN_CORRECT : STYLE_BTN_WRONG);
-    }
-
-    maskedWordLabel->setText(logic->getMaskedWord());
-    updateHangmanImage();
-
-    if(config.mode == GameMode::NetHost) {
-        QString u; for(auto x : logic->getUsedLetters()) u+=x;
-        QString pl = QString("%1;%2;%3;%4;%5;%6")
-                         .arg(logic->getMaskedWord()).arg(logic->getErrors()).arg(logic->getMaxErrors())
-                         .arg((int)logic->getState()).arg(u).arg(amISetter?1:0);
-        sendNetworkPacket("UPDATE", pl);
-    }
-}
-
-void WisielecWindow::onGameStateChanged(WisielecLogic::GameState s) {
-    if(config.mode != GameMode::NetClient && (s==WisielecLogic::GameState::Won || s==WisielecLogic::GameState::Lost))
-        handleGameOver(s==WisielecLogic::GameState::Won);
-}
-
-void WisielecWindow::onErrorsChanged(int e) { errorsLabel->setText(QString("Błędy: %1").arg(e)); }
-
-void WisielecWindow::createHangmanImages() {
-    for(int i=0; i<=8; i++) {
-        QPixmap p(300, 400); p.fill(Qt::white);
-        QPainter pt(&p); pt.setPen(QPen(Qt::black, 3));
-        if(i>=1) pt.drawLine(50,380,250,380);
-        if(i>=2) pt.drawLine(100,380,100,50);
-        if(i>=3) pt.drawLine(100,50,200,50);
-        if(i>=4) pt.drawLine(200,50,200,100);
-        if(i>=5) pt.drawEllipse(175,100,50,50);
-        if(i>=6) pt.drawLine(200,150,200,250);
-        if(i>=7) { pt.drawLine(200,170,160,210); pt.drawLine(200,170,240,210); }
-        if(i>=8) { pt.drawLine(200,250,170,320); pt.drawLine(200,250,230,320); }
-        hangmanImages[i] = p;
-    }
-}
-
-void WisielecWindow::updateHangmanImage() {
-    int e = logic->getErrors();
-    if(hangmanImages.contains(e)) hangmanLabel->setPixmap(hangmanImages[e]);
-}
-
-void WisielecWindow::startNextRound() {
-    if(config.mode == GameMode::NetHost || config.mode == GameMode::NetClient) amISetter = !amISetter;
-
-    if(config.mode != GameMode::NetClient) {
-        logic->resetGame();
-
-        if(config.mode == GameMode::Solo) {
-            logic->generateRandomWord();
-        }
-        else if(config.mode == GameMode::NetHost) {
-            QString pl = QString("...;0;%1;%2;;%3")
-            .arg(logic->getMaxErrors())
-                .arg((int)WisielecLogic::GameState::WaitingForWord)
-                .arg(amISetter ? 1 : 0);
-            sendNetworkPacket("UPDATE", pl);
-        }
-    }
-
-    wordInput->clear();
-    resetBoard();
-
-    if(config.mode == GameMode::Solo) {
-        stack->setCurrentWidget(pageGame);
-    } else {
-        stack->setCurrentWidget(amISetter ? pageSetup : pageWait);
-        if(!amISetter) waitLabel->setText("Przeciwnik ustawia słowo...");
-    }
-}
-
-void WisielecWindow::resetBoard() {
-    for(auto b : letterButtons) {
-        b->setEnabled(true);
-        b->setStyleSheet(STYLE_BTN_DEFAULT);
-    }
-    updateHangmanImage();
-}
-
-void WisielecWindow::handleGameOver(bool won) {
-    QMessageBox::StandardButton r = QMessageBox::information(this, won?"Wygrana":"Przegrana",
-                                                             "Koniec gry. Rewanż?", QMessageBox::Yes|QMessageBox::No);
-    if(r == QMessageBox::Yes) startNextRound();
-    else emit gameClosed();
-}
-
-void WisielecWindow::onNewConnection() {
-    if(socket) socket->close();
-    socket = server->nextPendingConnection();
-    connect(socket, &QTcpSocket::readyRead, this, &WisielecWindow::onSocketReadyRead);
-    connect(socket, &QTcpSocket::disconnected, this, &WisielecWindow::onSocketDisconnected);
-    stack->setCurrentWidget(pageSetup);
-}
-
-void WisielecWindow::onSocketDisconnected() {
-    QMessageBox::warning(this, "Rozłączono", "Połączenie zostało zerwane.");
-    emit gameClosed();
-}
-
-void WisielecWindow::onConnectionError(QAbstractSocket::SocketError) {
-    QMessageBox::warning(this, "Błąd", "Błąd połączenia.");
-    emit gameClosed();
-}
-
-void WisielecWindow::onConnected() { waitLabel->setText("Połączono."); }
+#include "wisielec_window.h"
+#include "startup_profile.h"
+#include "game_save.h"
+#include "game_stats.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QMessageBox>
+#include <QFileDialog>
+#include <QStatusBar>
+#include <QStyle>
+#include <cmath>
+#include <QRandomGenerator>
+#include <QStandardPaths>
+
+// Jeden arkusz dla calej klawiatury, parsowany raz; stan litery to wlasciwosc "guess",
+// wiec zgadniecie nie parsuje arkusza od nowa dla kazdego przycisku.
+const QString STYLE_KEYBOARD =
+    "QPushButton { background-color: #2196F3; color: white; font-weight: bold; border-radius: 5px; font-size: 14px; }"
+    " QPushButton:hover { background-color: #1976D2; }"
+    " QPushButton:disabled { background-color: #ccc; color: #666; }"
+    " QPushButton[guess=\"correct\"] { background-color: #4CAF50; color: white; }"
+    " QPushButton[guess=\"wrong\"] { background-color: #f44336; color: white; }";
+
+static void setGuessState(QPushButton *b, const char *state) {
+    if(b->property("guess").toByteArray() == state) return;
+    b->setProperty("guess", QByteArray(state));
+    b->style()->unpolish(b);
+    b->style()->polish(b);
+}
+
+WisielecWindow::WisielecWindow(const GameLaunchConfig &cfg, QWidget *parent)
+    : QMainWindow(parent), config(cfg), session(nullptr), logic(nullptr)
+{
+    setupUI();
+    reset(cfg);
+    resize(800, 600);
+}
+
+WisielecWindow::~WisielecWindow() {
+    if(session) session->close();
+}
+
+void WisielecWindow::reset(const GameLaunchConfig &cfg) {
+    suspend();
+    config = cfg;
+    createSession();
+
+    hintButton->setVisible(config.mode == GameMode::Solo || config.mode == GameMode::LocalDuo);
+    botButton->setVisible(config.mode == GameMode::Solo);
+    saveButton->setVisible(isLocal());
+    loadButton->setVisible(isLocal());
+
+    setWindowTitle(QString());
+    wordInput->clear();
+    statusLabel->clear();
+    maskedWordLabel->setText("...");
+    onErrorsChanged(0);
+
+    if(config.mode == GameMode::NetHost) amISetter = true;
+    else if(config.mode == GameMode::NetClient) amISetter = false;
+    else amISetter = true;
+
+    resetBoard();
+    initGame();
+
+    // Pytanie o przerwana gre dopiero po pierwszej klatce - nie wlicza sie do czasu startu gry.
+    if(isLocal())
+        StartupProfile::onFirstFrame(this, [this](qint64) { QTimer::singleShot(0, this, &WisielecWindow::resumeAutosave); });
+}
+
+// Sesja trzyma gniazda i timery, wiec w ukrytym oknie z puli nie moze zostac.
+void WisielecWindow::suspend() {
+    stopBot();
+    if(!session) return;
+
+    autosave();
+    session->disconnect(this);
+    session->close();
+    session->deleteLater();
+    session = nullptr;
+    logic = nullptr;
+}
+
+void WisielecWindow::createSession() {
+    WisielecSession::Role role = WisielecSession::Role::Local;
+    if(config.mode == GameMode::NetHost) role = WisielecSession::Role::Host;
+    else if(config.mode == GameMode::NetClient) role = WisielecSession::Role::Client;
+
+    session = new WisielecSession(role, this);
+    logic = session->logic();
+
+    connect(session, &WisielecSession::wordSet, this, &WisielecWindow::onWordSet);
+    connect(session, &WisielecSession::letterGuessed, this, &WisielecWindow::onLetterGuessed);
+    connect(session, &WisielecSession::gameStateChanged, this, &WisielecWindow::onGameStateChanged);
+    connect(session, &WisielecSession::errorsChanged, this, &WisielecWindow::onErrorsChanged);
+    connect(session, &WisielecSession::roundWaiting, this, &WisielecWindow::onRoundWaiting);
+    connect(session, &WisielecSession::peerConnected, this, &WisielecWindow::onPeerConnected);
+    connect(session, &WisielecSession::peerDisconnected, this, &WisielecWindow::onPeerDisconnected);
+    connect(session, &WisielecSession::connectionFailed, this, &WisielecWindow::onConnectionFailed);
+    connect(session, &WisielecSession::playersChanged, this, &WisielecWindow::onPlayersChanged);
+
+    // Opcjonalny duzy slownik w katalogu danych aplikacji; bez niego zostaje lista wbudowana.
+    if (logic) {
+        QString dictPath = QStandardPaths::locate(QStandardPaths::AppDataLocation, "slownik.wdic");
+        if (dictPath.isEmpty()) dictPath = QStandardPaths::locate(QStandardPaths::AppDataLocation, "slownik.txt");
+        if (!dictPath.isEmpty()) logic->loadDictionary(dictPath);
+    }
+}
+
+void WisielecWindow::closeEvent(QCloseEvent *event) {
+    emit gameClosed();
+    QMainWindow::closeEvent(event);
+}
+
+void WisielecWindow::onBackToMenu() {
+    emit gameClosed();
+}
+
+void WisielecWindow::setupUI() {
+    StartupStage stage("WisielecWindow::setupUI");
+    QWidget *central = new QWidget(this);
+    setCentralWidget(central);
+    QVBoxLayout *mainLayout = new QVBoxLayout(central);
+
+    QHBoxLayout *topBar = new QHBoxLayout();
+    QPushButton *btnMenu = new QPushButton("Powrót do Menu", this);
+    connect(btnMenu, &QPushButton::clicked, this, &WisielecWindow::onBackToMenu);
+    topBar->addWidget(btnMenu);
+    topBar->addStretch();
+    saveButton = new QPushButton("Zapisz", this);
+    connect(saveButton, &QPushButton::clicked, this, &WisielecWindow::onSaveClicked);
+    topBar->addWidget(saveButton);
+    loadButton = new QPushButton("Wczytaj", this);
+    connect(loadButton, &QPushButton::clicked, this, &WisielecWindow::onLoadClicked);
+    topBar->addWidget(loadButton);
+    mainLayout->addLayout(topBar);
+
+    stack = new QStackedWidget(this);
+    mainLayout->addWidget(stack);
+
+    pageWait = new QWidget(this);
+    QVBoxLayout *waitLay = new QVBoxLayout(pageWait);
+    waitLabel = new QLabel("Inicjalizacja...", this);
+    waitLabel->setAlignment(Qt::AlignCenter);
+    waitLabel->setStyleSheet("font-size: 18px;");
+    waitLay->addWidget(waitLabel);
+    stack->addWidget(pageWait);
+
+    pageSetup = new QWidget(this);
+    QVBoxLayout *setupLay = new QVBoxLayout(pageSetup);
+    QLabel *setupLbl = new QLabel("Ustaw hasło dla przeciwnika:", this);
+    setupLbl->setAlignment(Qt::AlignCenter);
+    setupLay->addWidget(setupLbl);
+    wordInput = new QLineEdit(this);
+    wordInput->setEchoMode(QLineEdit::Password);
+    wordInput->setAlignment(Qt::AlignCenter);
+    setupLay->addWidget(wordInput);
+    QPushButton *btnConfirm = new QPushButton("Zatwierdź", this);
+    connect(btnConfirm, &QPushButton::clicked, this, &WisielecWindow::confirmWord);
+    setupLay->addWidget(btnConfirm);
+    setupLay->addStretch();
+    stack->addWidget(pageSetup);
+
+    pageGame = new QWidget(this);
+    QHBoxLayout *gameLay = new QHBoxLayout(pageGame);
+
+    QVBoxLayout *left = new QVBoxLayout();
+    hangmanView = new HangmanWidget(this);
+    left->addWidget(hangmanView);
+    errorsLabel = new QLabel("Błędy: 0/0");
+    errorsLabel->setAlignment(Qt::AlignCenter);
+    left->addWidget(errorsLabel);
+    gameLay->addLayout(left, 1);
+
+    QVBoxLayout *right = new QVBoxLayout();
+    maskedWordLabel = new QLabel("...");
+    maskedWordLabel->setStyleSheet("font-size: 24px; font-weight: bold;");
+    maskedWordLabel->setAlignment(Qt::AlignCenter);
+    right->addWidget(maskedWordLabel);
+
+    statusLabel = new QLabel("");
+    statusLabel->setAlignment(Qt::AlignCenter);
+    right->addWidget(statusLabel);
+
+    QWidget *kbd = new QWidget();
+    kbd->setStyleSheet(STYLE_KEYBOARD);
+    QGridLayout *grid = new QGridLayout(kbd);
+    QString chars = "AĄBCĆDEĘFGHIJKLŁMNŃOÓPQRSŚTUVWXYZŹŻ";
+    int r=0, c=0;
+    for(QChar ch : chars) {
+        QPushButton *b = new QPushButton(QString(ch));
+        b->setFixedSize(35,35);
+        connect(b, &QPushButton::clicked, this, &WisielecWindow::onLetterClicked);
+        letterButtons[ch] = b;
+        grid->addWidget(b, r, c++);
+        if(c>8) { c=0; r++; }
+    }
+    right->addWidget(kbd);
+
+    QHBoxLayout *assistLay = new QHBoxLayout();
+    hintButton = new QPushButton("Podpowiedź", this);
+    connect(hintButton, &QPushButton::clicked, this, &WisielecWindow::onHintClicked);
+    assistLay->addWidget(hintButton);
+    botButton = new QPushButton("Bot zgaduje", this);
+    connect(botButton, &QPushButton::clicked, this, &WisielecWindow::onBotClicked);
+    assistLay->addWidget(botButton);
+    right->addLayout(assistLay);
+
+    botTimer = new QTimer(this);
+    botTimer->setInterval(600);
+    connect(botTimer, &QTimer::timeout, this, &WisielecWindow::onBotStep);
+
+    gameLay->addLayout(right, 1);
+
+    stack->addWidget(pageGame);
+}
+
+void WisielecWindow::initGame() {
+    if(config.mode == GameMode::Solo) {
+        amISetter = false;
+        stack->setCurrentWidget(pageGame);
+        logic->generateRandomWord();
+        resetBoard();
+    }
+    else if(config.mode == GameMode::LocalDuo) {
+        amISetter = true;
+        stack->setCurrentWidget(pageSetup);
+    }
+    else if(config.mode == GameMode::NetHost) {
+        stack->setCurrentWidget(pageWait);
+        waitLabel->setText("Serwer startuje na porcie " + QString::number(config.port));
+        if(!session->listen(config.port)) {
+            QMessageBox::critical(this, "Błąd", "Nie można uruchomić serwera!");
+            emit gameClosed();
+        }
+    }
+    else if(config.mode == GameMode::NetClient) {
+        stack->setCurrentWidget(pageWait);
+        waitLabel->setText("Łączenie...");
+        session->connectToHost(config.hostIp, config.port);
+    }
+}
+
+void WisielecWindow::confirmWord() {
+    QString w = wordInput->text().trimmed();
+    if(!WisielecLogic::isValidWord(w.toUpper())) {
+        QMessageBox::warning(this, "Błąd", "Tylko litery!");
+        return;
+    }
+    if(w.length() > WisielecSession::MaxWordLength) {
+        QMessageBox::warning(this, "Błąd", "Hasło jest za długie!");
+        return;
+    }
+
+    if(config.mode == GameMode::NetClient && amISetter) {
+        if(!session->submitWord(w)) return;
+        stack->setCurrentWidget(pageGame);
+        for(auto b : letterButtons) b->setEnabled(false);
+        statusLabel->setText("Czekam na ruch Hosta...");
+    } else {
+        session->submitWord(w);
+    }
+}
+
+void WisielecWindow::onLetterClicked() {
+    QPushButton *b = qobject_cast<QPushButton*>(sender());
+    if(!b) return;
+    QChar c = b->text()[0];
+
+    if(amISetter && config.mode != GameMode::LocalDuo) return;
+
+    if(session->guess(c)) b->setEnabled(false);
+}
+
+void WisielecWindow::onHintClicked() {
+    if(!logic || logic->getState() != WisielecLogic::GameState::Playing) return;
+
+    WisielecSolver::Suggestion s = logic->suggestLetter();
+    if(s.letter.isNull()) return;
+
+    if(s.candidates > 0)
+        statusLabel->setText(QString("Podpowiedź: %1 (pasujących haseł: %2)").arg(s.letter).arg(s.candidates));
+    else
+        statusLabel->setText(QString("Podpowiedź: %1").arg(s.letter));
+}
+
+void WisielecWindow::onBotClicked() {
+    if(botTimer->isActive()) {
+        stopBot();
+        return;
+    }
+    if(!logic || logic->getState() != WisielecLogic::GameState::Playing) return;
+
+    botButton->setText("Zatrzymaj bota");
+    botTimer->start();
+}
+
+void WisielecWindow::onBotStep() {
+    if(logic->getState() != WisielecLogic::GameState::Playing) {
+        stopBot();
+        return;
+    }
+
+    WisielecSolver::Suggestion s = logic->suggestLetter();
+    if(s.letter.isNull() || !session->guess(s.letter)) stopBot();
+}
+
+void WisielecWindow::stopBot() {
+    botTimer->stop();
+    botButton->setText("Bot zgaduje");
+}
+
+bool WisielecWindow::isLocal() const {
+    return config.mode == GameMode::Solo || config.mode == GameMode::LocalDuo;
+}
+
+void WisielecWindow::onSaveClicked() {
+    if(!logic || logic->getState() != WisielecLogic::GameState::Playing) {
+        statusLabel->setText("Nie ma trwającej gry do zapisania.");
+        return;
+    }
+
+    QString path = QFileDialog::getSaveFileName(this, "Zapisz grę", GameSave::directory() + "/wisielec.gsav", GameSave::fileFilter());
+    if(path.isEmpty()) return;
+
+    QString error;
+    if(!GameSave::write(path, GameSave::pack(GameType::Wisielec, WisielecLogic::StateVersion, logic->saveState()), &error))
+        QMessageBox::warning(this, "Zapis gry", error);
+}
+
+void WisielecWindow::onLoadClicked() {
+    QString path = QFileDialog::getOpenFileName(this, "Wczytaj grę", GameSave::directory(), GameSave::fileFilter());
+    if(path.isEmpty()) return;
+
+    QString error;
+    if(!loadGame(path, &error)) QMessageBox::warning(this, "Wczytanie gry", error);
+}
+
+bool WisielecWindow::loadGame(const QString &path, QString *error) {
+    QByteArray data;
+    if(!logic || !GameSave::read(path, GameType::Wisielec, WisielecLogic::StateVersion, &data, error)) return false;
+
+    if(!restoreGame(data)) {
+        if(error) *error = "Plik zapisu zawiera niepoprawny stan gry.";
+        return false;
+    }
+    return true;
+}
+
+// Przywrocenie emituje sygnaly jak setWord, wiec onWordSet odswieza plansze raz, razem z uzytymi literami.
+bool WisielecWindow::restoreGame(const QByteArray &data) {
+    stopBot();
+    amISetter = config.mode == GameMode::LocalDuo;
+    return logic->restoreState(data);
+}
+
+void WisielecWindow::resumeAutosave() {
+    QByteArray data;
+    if(!logic || !GameSave::readAutosave(GameType::Wisielec, WisielecLogic::StateVersion, config, &data)) return;
+
+    if(QMessageBox::question(this, "Przerwana gra", "Wznowić przerwaną grę?") != QMessageBox::Yes) return;
+    if(!restoreGame(data)) return;
+
+    GameSave::removeAutosave(GameType::Wisielec);
+    statusBar()->showMessage("Wznowiono przerwaną grę.", 5000);
+}
+
+void WisielecWindow::autosave() {
+    if(!isLocal() || !logic || logic->getState() != WisielecLogic::GameState::Playing) return;
+    GameSave::writeAutosave(GameType::Wisielec, WisielecLogic::StateVersion, config, logic->saveState());
+}
+
+void WisielecWindow::onWordSet(const QString &m) {
+    if(config.mode == GameMode::NetHost || config.mode == GameMode::NetClient) amISetter = session->localIsSetter();
+
+    // Nowe haslo (albo wczytany zapis) zawsze zaczyna od czystej klawiatury; uzyte litery nizej.
+    stack->setCurrentWidget(pageGame);
+    resetBoard();
+
+    if (config.mode != GameMode::LocalDuo && amISetter) {
+        for(auto b : letterButtons) b->setEnabled(false);
+        statusLabel->setText("Przeciwnik zgaduje Twoje hasło...");
+    } else {
+        statusLabel->setText("Zgaduj hasło!");
+    }
+
+    // Dolaczenie w trakcie rundy: litery zgadniete przed nami sa od razu zablokowane.
+    WisielecLogic::LetterMask used = session->usedLetters();
+    for(auto it = letterButtons.begin(); it != letterButtons.end(); ++it) {
+        int idx = WisielecLogic::letterIndex(it.key());
+        if(idx < 0 || !(used & (WisielecLogic::LetterMask(1) << idx))) continue;
+        it.value()->setEnabled(false);
+        setGuessState(it.value(), m.contains(it.key()) ? "correct" : "wrong");
+    }
+
+    maskedWordLabel->setText(m);
+    updateHangmanImage();
+}
+
+void WisielecWindow::onLetterGuessed(QChar c, bool ok) {
+    if(letterButtons.contains(c)) {
+        QPushButton *btn = letterButtons[c];
+        btn->setEnabled(false);
+        setGuessState(btn, ok ? "correct" : "wrong");
+    }
+
+    maskedWordLabel->setText(session->maskedWord());
+    updateHangmanImage();
+}
+
+void WisielecWindow::onGameStateChanged(WisielecLogic::GameState s) {
+    if(s==WisielecLogic::GameState::Won || s==WisielecLogic::GameState::Lost) {
+        const bool won = s==WisielecLogic::GameState::Won;
+        recordResult(won);
+        stopBot();
+        handleGameOver(won);
+    }
+}
+
+void WisielecWindow::onErrorsChanged(int e) {
+    errorsLabel->setText(QString("Błędy: %1/%2").arg(e).arg(session->maxErrors()));
+    updateHangmanImage();
+}
+
+// Statystyki zgadujacego: lokalnie gracz przy klawiaturze, w sieci tylko gdy to nie on ustawial haslo.
+void WisielecWindow::recordResult(bool won) {
+    GameStats *stats = GameStats::instance();
+    if(!stats || (amISetter && config.mode != GameMode::LocalDuo)) return;
+
+    const QString name = config.playerName.isEmpty() ? "Gracz" : config.playerName;
+    stats->record({ GameType::Wisielec, name, won, session->errors() });
+}
+
+void WisielecWindow::updateHangmanImage() {
+    hangmanView->setErrors(session->errors(), session->maxErrors());
+}
+
+void WisielecWindow::startNextRound() {
+    if(config.mode == GameMode::NetClient) {
+        // Nowa runde i role ustala host; jego komunikat mogl juz przyjsc w trakcie okna dialogowego.
+        WisielecLogic::GameState st = session->state();
+        if(st == WisielecLogic::GameState::WaitingForWord) onRoundWaiting(session->localIsSetter());
+        else if(st != WisielecLogic::GameState::Playing) {
+            stack->setCurrentWidget(pageWait);
+            waitLabel->setText("Czekam na hosta...");
+        }
+        return;
+    }
+    if(config.mode == GameMode::NetHost) {
+        session->startNextRound();
+        return;
+    }
+
+    session->startNextRound();
+    if(config.mode == GameMode::Solo) {
+        logic->generateRandomWord();
+    }
+
+    wordInput->clear();
+    resetBoard();
+
+    if(config.mode == GameMode::Solo) {
+        stack->setCurrentWidget(pageGame);
+    } else {
+        stack->setCurrentWidget(amISetter ? pageSetup : pageWait);
+        if(!amISetter) waitLabel->setText("Przeciwnik ustawia słowo...");
+    }
+}
+
+void WisielecWindow::resetBoard() {
+    for(auto b : letterButtons) {
+        b->setEnabled(true);
+        setGuessState(b, "");
+    }
+    updateHangmanImage();
+}
+
+void WisielecWindow::handleGameOver(bool won) {
+    QMessageBox::StandardButton r = QMessageBox::information(this, won?"Wygrana":"Przegrana",
+                                                             "Koniec gry. Rewanż?", QMessageBox::Yes|QMessageBox::No);
+    if(r == QMessageBox::Yes) startNextRound();
+    else emit gameClosed();
+}
+
+void WisielecWindow::onRoundWaiting(bool setter) {
+    amISetter = setter;
+    wordInput->clear();
+    resetBoard();
+    stack->setCurrentWidget(amISetter ? pageSetup : pageWait);
+    if(!amISetter) waitLabel->setText("Przeciwnik ustawia słowo...");
+}
+
+void WisielecWindow::onPeerConnected() { waitLabel->setText("Połączono."); }
+
+void WisielecWindow::onPlayersChanged(int guests) {
+    setWindowTitle(QString("Wisielec - graczy w pokoju: %1").arg(guests + 1));
+
+    // Pierwszy gosc odblokowuje ustawianie hasla; kolejni dolaczaja do trwajacej rundy.
+    if(guests > 0 && stack->currentWidget() == pageWait
+        && session->state() == WisielecLogic::GameState::WaitingForWord && session->localIsSetter())
+        onRoundWaiting(true);
+}
+
+void WisielecWindow::onPeerDisconnected() {
+    QMessageBox::warning(this, "Rozłączono", "Połączenie zostało zerwane.");
+    emit gameClosed();
+}
+
+void WisielecWindow::onConnectionFailed() {
+    QMessageBox::warning(this, "Błąd", "Błąd połączenia.");
+    emit gameClosed();
+}
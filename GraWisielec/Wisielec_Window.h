@@ -1,83 +1,98 @@
-#ifndef WISIELEC_WINDOW_H
-#define WISIELEC_WINDOW_H
-
-#include <QMainWindow>
-#include <QLabel>
-#include <QLineEdit>
-#include <QPushButton>
-#include <QStackedWidget>
-#include <QTcpServer>
-#include <QTcpSocket>
-#include <QMap>
-#include "game_logic.h"
-#include "game_config.h"
-
-class WisielecWindow : public QMainWindow
-{
-    Q_OBJECT
-
-public:
-    explicit WisielecWindow(const GameLaunchConfig &config, QWidget *parent = nullptr);
-    ~WisielecWindow();
-
-signals:
-    void gameClosed();
-
-protected:
-    void closeEvent(QCloseEvent *event) override;
-
-private slots:
-    void onNewConnection();
-    void onSocketReadyRead();
-    void onSocketDisconnected();
-    void onConnected();
-    void onConnectionError(QAbstractSocket::SocketError err);
-
-    void confirmWord();
-    void onLetterClicked();
-    void onBackToMenu();
-
-    void onWordSet(const QString &masked);
-    void onLetterGuessed(QChar c, bool correct);
-    void onGameStateChanged(WisielecLogic::GameState newState);
-    void onErrorsChanged(int err);
-
-private:
-    void initGame();
-    void setupUI();
-    void createHangmanImages();
-    void updateHangmanImage();
-
-    void processNetworkPacket(const QString &type, const QString &payload);
-    void sendNetworkPacket(const QString &type, const QString &payload);
-    void updateNetworkUI(const QString &payload);
-
-    void resetBoard();
-    void startNextRound();
-    void handleGameOver(bool won);
-
-    GameLaunchConfig config;
-    WisielecLogic *logic;
-
-    QTcpServer *server;
-    QTcpSocket *socket;
-
-    bool amISetter;
-
-    QStackedWidget *stack;
-    QWidget *pageSetup;
-    QWidget *pageGame;
-    QWidget *pageWait;
-
-    QLineEdit *wordInput;
-    QLabel *statusLabel;
-    QLabel *waitLabel;
-
-    QLabel *hangmanLabel;
-    QLabel *maskedWordLabel;
-    QLabel *errorsLabel;
-    QMap<QChar, QPushButton*> letterButtons;
-    QMap<int, QPixmap> hangmanImages;
-};
-
-#endif
+#ifndef WISIELEC_WINDOW_H
+#define WISIELEC_WINDOW_H
+
+#include <QMainWindow>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QStackedWidget>
+#include <QMap>
+#include <QTimer>
+#include "game_logic.h"
+#include "session.h"
+#include "hangman_widget.h"
+#include "game_config.h"
+
+class WisielecWindow : public QMainWindow
+{
+    Q_OBJECT
+
+public:
+    explicit WisielecWindow(const GameLaunchConfig &config, QWidget *parent = nullptr);
+    ~WisielecWindow();
+
+    // Okno z puli launchera: nowa sesja i plansza bez ponownego budowania UI.
+    void reset(const GameLaunchConfig &config);
+    void suspend();
+
+signals:
+    void gameClosed();
+
+protected:
+    void closeEvent(QCloseEvent *event) override;
+
+private slots:
+    void onPeerConnected();
+    void onPeerDisconnected();
+    void onConnectionFailed();
+    void onRoundWaiting(bool setter);
+    void onPlayersChanged(int guests);
+
+    void confirmWord();
+    void onLetterClicked();
+    void onBackToMenu();
+    void onHintClicked();
+    void onBotClicked();
+    void onBotStep();
+    void onSaveClicked();
+    void onLoadClicked();
+
+    void onWordSet(const QString &masked);
+    void onLetterGuessed(QChar c, bool correct);
+    void onGameStateChanged(WisielecLogic::GameState newState);
+    void onErrorsChanged(int err);
+
+private:
+    void createSession();
+    void initGame();
+    void setupUI();
+    void updateHangmanImage();
+
+    void resetBoard();
+    void startNextRound();
+    void handleGameOver(bool won);
+    void stopBot();
+    bool isLocal() const;
+    bool loadGame(const QString &path, QString *error);
+    bool restoreGame(const QByteArray &data);
+    void resumeAutosave();
+    void autosave();
+    void recordResult(bool won);
+
+    GameLaunchConfig config;
+    WisielecSession *session;
+    WisielecLogic *logic;
+
+    bool amISetter;
+
+    QStackedWidget *stack;
+    QWidget *pageSetup;
+    QWidget *pageGame;
+    QWidget *pageWait;
+
+    QLineEdit *wordInput;
+    QLabel *statusLabel;
+    QLabel *waitLabel;
+
+    HangmanWidget *hangmanView;
+    QLabel *maskedWordLabel;
+    QLabel *errorsLabel;
+    QPushButton *hintButton;
+    QPushButton *botButton;
+    QPushButton *saveButton;
+    QPushButton *loadButton;
+    QTimer *botTimer;
+    QMap<QChar, QPushButton*> letterButtons;
+};
+
+#endif
@@ -0,0 +1,293 @@
+#include "dictionary.h"
+#include "game_logic.h"
+#include <QTextStream>
+#include <QSaveFile>
+#include <QSet>
+#include <QSysInfo>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+static const char MAGIC[4] = { 'W', 'D', 'I', 'C' };
+static const quint32 FORMAT_VERSION = 1;
+static const int HEADER_SIZE = 32;
+static const int BUCKETS = WisielecDictionary::DifficultyCount * (WisielecDictionary::MaxLength + 1);
+static const int OFFSETS_POS = HEADER_SIZE + BUCKETS * 8;
+
+static void appendU32(QByteArray &out, quint32 value)
+{
+    char tmp[4];
+    qToLittleEndian(value, tmp);
+    out.append(tmp, 4);
+}
+
+WisielecDictionary::WisielecDictionary()
+    : data(nullptr), wordCount(0), buckets(nullptr), offsets(nullptr), pool(nullptr), poolLength(0)
+{
+}
+
+WisielecDictionary::~WisielecDictionary()
+{
+    close();
+}
+
+bool WisielecDictionary::open(const QString &path)
+{
+    close();
+
+    // Pula jest czytana bezposrednio jako char16_t, bez konwersji bajtow.
+    if (QSysInfo::ByteOrder != QSysInfo::LittleEndian) return false;
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    const qint64 fileSize = file.size();
+    if (fileSize < OFFSETS_POS + 4) {
+        close();
+        return false;
+    }
+
+    uchar *mapped = file.map(0, fileSize);
+    if (!mapped) {
+        close();
+        return false;
+    }
+    data = mapped;
+
+    const quint32 version = qFromLittleEndian<quint32>(data + 4);
+    const quint32 count = qFromLittleEndian<quint32>(data + 8);
+    const quint32 maxLength = qFromLittleEndian<quint32>(data + 12);
+    const quint32 bucketTotal = qFromLittleEndian<quint32>(data + 16);
+    const quint32 poolOffset = qFromLittleEndian<quint32>(data + 20);
+    const quint32 poolChars = qFromLittleEndian<quint32>(data + 24);
+
+    const qint64 offsetsEnd = OFFSETS_POS + (qint64(count) + 1) * 4;
+    bool valid = std::memcmp(data, MAGIC, 4) == 0
+                 && version == FORMAT_VERSION
+                 && maxLength == (quint32)MaxLength
+                 && bucketTotal == (quint32)BUCKETS
+                 && offsetsEnd <= poolOffset
+                 && poolOffset % 2 == 0
+                 && qint64(poolOffset) + qint64(poolChars) * 2 <= fileSize;
+
+    if (!valid) {
+        close();
+        return false;
+    }
+
+    // Tylko naglowek jest sprawdzany przy otwarciu - czas startu nie zalezy od liczby slow.
+    wordCount = count;
+    buckets = data + HEADER_SIZE;
+    offsets = data + OFFSETS_POS;
+    pool = reinterpret_cast<const char16_t *>(data + poolOffset);
+    poolLength = poolChars;
+    return true;
+}
+
+void WisielecDictionary::close()
+{
+    if (data) file.unmap(const_cast<uchar *>(data));
+    if (file.isOpen()) file.close();
+
+    data = nullptr;
+    wordCount = 0;
+    buckets = nullptr;
+    offsets = nullptr;
+    pool = nullptr;
+    poolLength = 0;
+}
+
+bool WisielecDictionary::isOpen() const
+{
+    return data != nullptr;
+}
+
+int WisielecDictionary::size() const
+{
+    return (int)wordCount;
+}
+
+int WisielecDictionary::wordLength(int index) const
+{
+    if (index < 0 || (quint32)index >= wordCount) return 0;
+    quint32 begin = qFromLittleEndian<quint32>(offsets + index * 4);
+    quint32 end = qFromLittleEndian<quint32>(offsets + (index + 1) * 4);
+    if (end < begin || end > poolLength) return 0;
+    return (int)(end - begin);
+}
+
+QString WisielecDictionary::wordAt(int index) const
+{
+    int length = wordLength(index);
+    if (length <= 0) return QString();
+
+    quint32 begin = qFromLittleEndian<quint32>(offsets + index * 4);
+    return QString(reinterpret_cast<const QChar *>(pool + begin), length);
+}
+
+quint32 WisielecDictionary::bucketStart(int difficulty, int length) const
+{
+    int bucket = difficulty * (MaxLength + 1) + length;
+    return qFromLittleEndian<quint32>(buckets + bucket * 8);
+}
+
+quint32 WisielecDictionary::bucketCount(int difficulty, int length) const
+{
+    int bucket = difficulty * (MaxLength + 1) + length;
+    return qFromLittleEndian<quint32>(buckets + bucket * 8 + 4);
+}
+
+int WisielecDictionary::countMatching(int minLength, int maxLength, Difficulty difficulty) const
+{
+    if (!isOpen()) return 0;
+
+    minLength = std::max(minLength, 1);
+    maxLength = std::min(maxLength, (int)MaxLength);
+
+    int firstDiff = (difficulty == Difficulty::Any) ? 0 : (int)difficulty;
+    int lastDiff = (difficulty == Difficulty::Any) ? DifficultyCount - 1 : (int)difficulty;
+
+    qint64 total = 0;
+    for (int d = firstDiff; d <= lastDiff; ++d)
+        for (int len = minLength; len <= maxLength; ++len)
+            total += bucketCount(d, len);
+
+    return (int)std::min<qint64>(total, wordCount);
+}
+
+int WisielecDictionary::randomIndex(GameRng &rng, int minLength, int maxLength, Difficulty difficulty) const
+{
+    int total = countMatching(minLength, maxLength, difficulty);
+    if (total <= 0) return -1;
+
+    minLength = std::max(minLength, 1);
+    maxLength = std::min(maxLength, (int)MaxLength);
+
+    int firstDiff = (difficulty == Difficulty::Any) ? 0 : (int)difficulty;
+    int lastDiff = (difficulty == Difficulty::Any) ? DifficultyCount - 1 : (int)difficulty;
+
+    // Losujemy pozycje w sumie kubelkow - koszt zalezy od liczby kubelkow, nie slow.
+    quint32 r = (quint32)rng.bounded(0, total);
+    for (int d = firstDiff; d <= lastDiff; ++d) {
+        for (int len = minLength; len <= maxLength; ++len) {
+            quint32 count = bucketCount(d, len);
+            if (r < count) {
+                quint32 index = bucketStart(d, len) + r;
+                return index < wordCount ? (int)index : -1;
+            }
+            r -= count;
+        }
+    }
+    return -1;
+}
+
+WisielecDictionary::Difficulty WisielecDictionary::classify(const QString &word)
+{
+    // Wiecej roznych liter i rzadkie litery = wiecej strzalow potrzebnych do odgadniecia.
+    static const QString rare = QStringLiteral("ĄĆĘŁŃÓŚŹŻFHJQVX");
+
+    QSet<QChar> distinct;
+    int rareCount = 0;
+    for (QChar c : word) {
+        if (c == ' ' || distinct.contains(c)) continue;
+        distinct.insert(c);
+        if (rare.contains(c)) rareCount++;
+    }
+
+    int score = distinct.size() + 2 * rareCount;
+    if (score <= 6) return Difficulty::Easy;
+    if (score <= 9) return Difficulty::Medium;
+    return Difficulty::Hard;
+}
+
+bool WisielecDictionary::build(const QString &textPath, const QString &outPath, QString *error)
+{
+    auto fail = [error](const QString &text) {
+        if (error) *error = text;
+        return false;
+    };
+
+    QFile in(textPath);
+    if (!in.open(QIODevice::ReadOnly | QIODevice::Text))
+        return fail("Nie można otworzyć listy słów.");
+
+    struct Entry
+    {
+        QString word;
+        int bucket;
+    };
+    std::vector<Entry> entries;
+    QSet<QString> seen;
+
+    QTextStream ts(&in);
+    ts.setEncoding(QStringConverter::Utf8);
+    QString line;
+    while (ts.readLineInto(&line)) {
+        QString w = line.trimmed().toUpper();
+        if (w.length() > MaxLength || !WisielecLogic::isValidWord(w)) continue;
+        if (seen.contains(w)) continue;
+        seen.insert(w);
+
+        int bucket = (int)classify(w) * (MaxLength + 1) + w.length();
+        entries.push_back({ w, bucket });
+    }
+    seen.clear();
+
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.bucket < b.bucket;
+    });
+
+    std::vector<quint32> bucketStarts(BUCKETS, 0), bucketCounts(BUCKETS, 0);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        int b = entries[i].bucket;
+        if (bucketCounts[b] == 0) bucketStarts[b] = (quint32)i;
+        bucketCounts[b]++;
+    }
+
+    const quint32 count = (quint32)entries.size();
+    const quint32 poolOffset = OFFSETS_POS + (count + 1) * 4;
+
+    QByteArray header;
+    header.append(MAGIC, 4);
+    appendU32(header, FORMAT_VERSION);
+    appendU32(header, count);
+    appendU32(header, MaxLength);
+    appendU32(header, BUCKETS);
+    appendU32(header, poolOffset);
+
+    QByteArray table;
+    table.reserve(BUCKETS * 8 + (count + 1) * 4);
+    for (int b = 0; b < BUCKETS; ++b) {
+        appendU32(table, bucketStarts[b]);
+        appendU32(table, bucketCounts[b]);
+    }
+
+    QByteArray poolBytes;
+    quint32 offset = 0;
+    for (const Entry &e : entries) {
+        appendU32(table, offset);
+        for (QChar c : e.word) {
+            char tmp[2];
+            qToLittleEndian<quint16>(c.unicode(), tmp);
+            poolBytes.append(tmp, 2);
+        }
+        offset += (quint32)e.word.length();
+    }
+    appendU32(table, offset);
+
+    appendU32(header, offset);
+    appendU32(header, 0);
+
+    QSaveFile out(outPath);
+    if (!out.open(QIODevice::WriteOnly))
+        return fail("Nie można zapisać słownika.");
+
+    out.write(header);
+    out.write(table);
+    out.write(poolBytes);
+    if (!out.commit())
+        return fail("Nie można zapisać słownika.");
+
+    return true;
+}
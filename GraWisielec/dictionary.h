@@ -0,0 +1,59 @@
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+#include <QString>
+#include <QFile>
+#include "game_rng.h"
+
+// Slownik hasel w formacie .wdic, mapowany z pliku zamiast wczytywany do QStringList.
+// Uklad (little-endian): naglowek 32 B, kubelki (start, liczba) po [trudnosc][dlugosc],
+// tablica offsetow quint32[liczbaSlow + 1] i pula znakow UTF-16 (wielkie litery).
+// Slowa sa posortowane po (trudnosc, dlugosc), wiec kazdy kubelek to ciagly zakres.
+class WisielecDictionary
+{
+public:
+    enum class Difficulty
+    {
+        Easy,
+        Medium,
+        Hard,
+        Any
+    };
+
+    static constexpr int MaxLength = 32;
+    static constexpr int DifficultyCount = 3;
+
+    WisielecDictionary();
+    ~WisielecDictionary();
+
+    WisielecDictionary(const WisielecDictionary &) = delete;
+    WisielecDictionary &operator=(const WisielecDictionary &) = delete;
+
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const;
+
+    static bool build(const QString &textPath, const QString &outPath, QString *error = nullptr);
+    static Difficulty classify(const QString &word);
+
+    int size() const;
+    int wordLength(int index) const;
+    QString wordAt(int index) const;
+
+    int countMatching(int minLength, int maxLength, Difficulty difficulty) const;
+    int randomIndex(GameRng &rng, int minLength, int maxLength, Difficulty difficulty) const;
+
+private:
+    quint32 bucketStart(int difficulty, int length) const;
+    quint32 bucketCount(int difficulty, int length) const;
+
+    QFile file;
+    const uchar *data;
+    quint32 wordCount;
+    const uchar *buckets;
+    const uchar *offsets;
+    const char16_t *pool;
+    quint32 poolLength;
+};
+
+#endif
@@ -1,169 +1,377 @@
-#include "game_logic.h"
-#include <QRegularExpression>
-#include <QRandomGenerator>
-
-WisielecLogic::WisielecLogic(QObject *parent)
-    : QObject(parent),
-    errors(0),
-    maxErrors(8),
-    state(GameState::WaitingForWord)
-{
-    dictionary << "PROGRAMOWANIE" << "KOMPUTER" << "INTERNET" << "KLAWIATURA"
-               << "RZEKA" << "SAMOCHÓD" << "KSIĄŻKA" << "TELEFON"
-               << "WARSZAWA" << "KRAKÓW" << "PROGRAMISTA" << "APLIKACJA"
-               << "MONITOR" << "MYSZKA" << "GŁOŚNIKI" << "SŁUCHAWKI"
-               << "ŻÓŁĆ" << "GĘŚ" << "CHRZĄSZCZ" << "SZCZĘŚCIE";
-}
-
-void WisielecLogic::generateRandomWord()
-{
-    if (dictionary.isEmpty()) return;
-    int index = QRandomGenerator::global()->bounded(dictionary.size());
-    setWord(dictionary[index]);
-}
-
-bool WisielecLogic::setWord(const QString &newWord)
-{
-    QString trimmed = newWord.trimmed().toUpper();
-
-    if (!isValidWord(trimmed)) {
-        return false;
-    }
-
-    word = trimmed;
-    usedLetters.clear();
-    errors = 0;
-
-    int calculatedMax = word.length() + 2;
-    if (calculatedMax < 5) calculatedMax = 5;
-    if (calculatedMax > 15) calculatedMax = 15;
-    maxErrors = calculatedMax;
-
-    state = GameState::Playing;
-
-    emit wordSet(getMaskedWord());
-    emit gameStateChanged(state);
-    emit errorsChanged(errors);
-
-    return true;
-}
-
-bool WisielecLogic::guessLetter(QChar letter)
-{
-    if (state != GameState::Playing) {
-        return false;
-    }
-
-    QChar upperLetter = letter.toUpper();
-
-    if (!isValidLetter(upperLetter)) {
-        return false;
-    }
-
-    if (usedLetters.contains(upperLetter)) {
-        return false;
-    }
-
-    usedLetters.insert(upperLetter);
-
-    bool correct = word.contains(upperLetter);
-
-    if (!correct) {
-        errors++;
-        emit errorsChanged(errors);
-    }
-
-    emit letterGuessed(upperLetter, correct);
-    checkWinCondition();
-
-    return true;
-}
-
-void WisielecLogic::resetGame()
-{
-    word.clear();
-    usedLetters.clear();
-    errors = 0;
-    state = GameState::WaitingForWord;
-
-    emit gameStateChanged(state);
-    emit errorsChanged(errors);
-}
-
-QString WisielecLogic::getMaskedWord() const
-{
-    return createMask();
-}
-
-WisielecLogic::GameState WisielecLogic::getState() const
-{
-    return state;
-}
-
-int WisielecLogic::getErrors() const
-{
-    return errors;
-}
-
-int WisielecLogic::getMaxErrors() const
-{
-    return maxErrors;
-}
-
-QSet<QChar> WisielecLogic::getUsedLetters() const
-{
-    return usedLetters;
-}
-
-QString WisielecLogic::getWord() const
-{
-    return word;
-}
-
-bool WisielecLogic::isValidWord(const QString &word)
-{
-    if (word.isEmpty()) return false;
-    static QRegularExpression regex("^[A-ZĄĆĘŁŃÓŚŹŻ ]+$");
-    QRegularExpressionMatch match = regex.match(word);
-    return match.hasMatch();
-}
-
-bool WisielecLogic::isValidLetter(QChar letter)
-{
-    return letter.isLetter();
-}
-
-void WisielecLogic::checkWinCondition()
-{
-    if (errors >= maxErrors) {
-        state = GameState::Lost;
-        emit gameStateChanged(state);
-        return;
-    }
-
-    for (QChar c : word) {
-        if (c == ' ') continue;
-        if (!usedLetters.contains(c)) {
-            return;
-        }
-    }
-
-    state = GameState::Won;
-    emit gameStateChanged(state);
-}
-
-QString WisielecLogic::createMask() const
-{
-    QString mask;
-    for (QChar c : word) {
-        if (c == ' ') {
-            mask += "  ";
-        } else if (usedLetters.contains(c)) {
-            mask += c;
-            mask += ' ';
-        } else {
-            mask += "_ ";
-        }
-    }
-    return mask.trimmed();
-}
+#include "game_logic.h"
+#include <QDataStream>
+#include <QFileInfo>
+#include <algorithm>
+#include <array>
+
+const QString WisielecLogic::ALPHABET = "AĄBCĆDEĘFGHIJKLŁMNŃOÓPQRSŚTUVWXYZŹŻ";
+
+// Indeks litery po kodzie znaku; wszystkie litery alfabetu mieszcza sie ponizej U+0180.
+static const int LETTER_TABLE_SIZE = 0x180;
+
+static const std::array<qint8, LETTER_TABLE_SIZE> &letterTable()
+{
+    static const std::array<qint8, LETTER_TABLE_SIZE> table = [] {
+        std::array<qint8, LETTER_TABLE_SIZE> t;
+        t.fill(-1);
+        for (int i = 0; i < WisielecLogic::ALPHABET.size(); ++i)
+            t[WisielecLogic::ALPHABET[i].unicode()] = (qint8)i;
+        return t;
+    }();
+    return table;
+}
+
+WisielecLogic::WisielecLogic(QObject *parent)
+    : QObject(parent),
+    usedMask(0),
+    wordMask(0),
+    remainingLetters(0),
+    errors(0),
+    maxErrors(8),
+    state(GameState::WaitingForWord),
+    solverReady(false),
+    filterMinLength(1),
+    filterMaxLength(WisielecDictionary::MaxLength),
+    filterDifficulty(WisielecDictionary::Difficulty::Any)
+{
+    std::fill(positionStart, positionStart + AlphabetSize + 1, 0);
+
+    dictionary << "PROGRAMOWANIE" << "KOMPUTER" << "INTERNET" << "KLAWIATURA"
+               << "RZEKA" << "SAMOCHÓD" << "KSIĄŻKA" << "TELEFON"
+               << "WARSZAWA" << "KRAKÓW" << "PROGRAMISTA" << "APLIKACJA"
+               << "MONITOR" << "MYSZKA" << "GŁOŚNIKI" << "SŁUCHAWKI"
+               << "ŻÓŁĆ" << "GĘŚ" << "CHRZĄSZCZ" << "SZCZĘŚCIE";
+}
+
+void WisielecLogic::generateRandomWord()
+{
+    if (externalDictionary.isOpen()) {
+        int index = externalDictionary.randomIndex(rng, filterMinLength, filterMaxLength, filterDifficulty);
+        if (index >= 0 && setWord(externalDictionary.wordAt(index))) return;
+    }
+
+    if (dictionary.isEmpty()) return;
+    int index = rng.bounded(0, dictionary.size());
+    setWord(dictionary[index]);
+}
+
+bool WisielecLogic::loadDictionary(const QString &path)
+{
+    // Lista tekstowa jest kompilowana raz do .wdic obok pliku i odswiezana, gdy zrodlo jest nowsze.
+    QString mappedPath = path;
+    if (!path.endsWith(".wdic", Qt::CaseInsensitive)) {
+        mappedPath = path + ".wdic";
+        QFileInfo source(path);
+        QFileInfo cache(mappedPath);
+        if (!cache.exists() || cache.lastModified() < source.lastModified()) {
+            if (!WisielecDictionary::build(path, mappedPath)) return false;
+        }
+    }
+
+    solverReady = false;
+    return externalDictionary.open(mappedPath);
+}
+
+void WisielecLogic::setWordFilter(int minLength, int maxLength, WisielecDictionary::Difficulty difficulty)
+{
+    filterMinLength = minLength;
+    filterMaxLength = maxLength;
+    filterDifficulty = difficulty;
+}
+
+bool WisielecLogic::hasExternalDictionary() const
+{
+    return externalDictionary.isOpen();
+}
+
+WisielecSolver::Suggestion WisielecLogic::suggestLetter()
+{
+    // Indeks budujemy przy pierwszej podpowiedzi, a nie przy starcie okna.
+    if (!solverReady) {
+        if (externalDictionary.isOpen()) solver.build(externalDictionary);
+        else solver.build(dictionary);
+        solverReady = true;
+    }
+
+    return solver.suggest(maskedWord, usedMask);
+}
+
+bool WisielecLogic::setWord(const QString &newWord)
+{
+    QString trimmed = newWord.trimmed().toUpper();
+
+    if (!isValidWord(trimmed)) {
+        return false;
+    }
+
+    word = trimmed;
+    usedMask = 0;
+    errors = 0;
+    indexWord();
+    maskedWord = createMask();
+
+    int calculatedMax = word.length() + 2;
+    if (calculatedMax < 5) calculatedMax = 5;
+    if (calculatedMax > 15) calculatedMax = 15;
+    maxErrors = calculatedMax;
+
+    state = GameState::Playing;
+
+    emit wordSet(getMaskedWord());
+    emit gameStateChanged(state);
+    emit errorsChanged(errors);
+
+    return true;
+}
+
+bool WisielecLogic::guessLetter(QChar letter)
+{
+    if (state != GameState::Playing) {
+        return false;
+    }
+
+    QChar upperLetter = letter.toUpper();
+    int index = letterIndex(upperLetter);
+
+    if (index < 0) {
+        return false;
+    }
+
+    LetterMask bit = LetterMask(1) << index;
+    if (usedMask & bit) {
+        return false;
+    }
+
+    usedMask |= bit;
+
+    bool correct = (wordMask & bit) != 0;
+
+    if (correct) {
+        // Odslaniamy tylko pozycje tej litery; znak i hasla stoi w masce pod indeksem 2 * i.
+        for (int i = positionStart[index]; i < positionStart[index + 1]; ++i)
+            maskedWord[2 * positionList[i]] = upperLetter;
+        remainingLetters -= positionStart[index + 1] - positionStart[index];
+    } else {
+        errors++;
+        emit errorsChanged(errors);
+    }
+
+    emit letterGuessed(upperLetter, correct);
+    checkWinCondition();
+
+    return true;
+}
+
+void WisielecLogic::resetGame()
+{
+    word.clear();
+    maskedWord.clear();
+    usedMask = 0;
+    wordMask = 0;
+    remainingLetters = 0;
+    positionList.clear();
+    std::fill(positionStart, positionStart + AlphabetSize + 1, 0);
+    errors = 0;
+    state = GameState::WaitingForWord;
+
+    emit gameStateChanged(state);
+    emit errorsChanged(errors);
+}
+
+QByteArray WisielecLogic::saveState() const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << (quint8)state << (quint8)errors << (quint8)maxErrors << (quint64)usedMask
+        << (quint64)rng.seed() << (quint64)rng.state()
+        << (quint8)filterMinLength << (quint8)filterMaxLength << (quint8)filterDifficulty
+        << word.toUtf8();
+    return data;
+}
+
+bool WisielecLogic::restoreState(const QByteArray &data)
+{
+    QDataStream in(data);
+    in.setByteOrder(QDataStream::LittleEndian);
+
+    quint8 savedState = 0, savedErrors = 0, savedMaxErrors = 0;
+    quint8 minLength = 0, maxLength = 0, difficulty = 0;
+    quint64 savedUsed = 0, seed = 0, rngState = 0;
+    QByteArray savedWord;
+    in >> savedState >> savedErrors >> savedMaxErrors >> savedUsed >> seed >> rngState
+       >> minLength >> maxLength >> difficulty >> savedWord;
+
+    QString restored = QString::fromUtf8(savedWord);
+    if (in.status() != QDataStream::Ok || (GameState)savedState != GameState::Playing) return false;
+    if (!isValidWord(restored) || savedErrors >= savedMaxErrors) return false;
+    if (savedUsed >> AlphabetSize || difficulty > (quint8)WisielecDictionary::Difficulty::Any) return false;
+
+    word = restored;
+    indexWord();
+    usedMask = savedUsed;
+    for (int i = 0; i < AlphabetSize; ++i) {
+        if (usedMask & wordMask & (LetterMask(1) << i))
+            remainingLetters -= positionStart[i + 1] - positionStart[i];
+    }
+
+    maskedWord = createMask();
+    errors = savedErrors;
+    maxErrors = savedMaxErrors;
+    state = GameState::Playing;
+    rng.restore(seed, rngState);
+    setWordFilter(minLength, maxLength, (WisielecDictionary::Difficulty)difficulty);
+
+    emit wordSet(getMaskedWord());
+    emit gameStateChanged(state);
+    emit errorsChanged(errors);
+    return true;
+}
+
+const QString &WisielecLogic::getMaskedWord() const
+{
+    return maskedWord;
+}
+
+WisielecLogic::GameState WisielecLogic::getState() const
+{
+    return state;
+}
+
+int WisielecLogic::getErrors() const
+{
+    return errors;
+}
+
+int WisielecLogic::getMaxErrors() const
+{
+    return maxErrors;
+}
+
+WisielecLogic::LetterMask WisielecLogic::getUsedLetters() const
+{
+    return usedMask;
+}
+
+WisielecLogic::LetterMask WisielecLogic::getWordLetters() const
+{
+    return wordMask;
+}
+
+QString WisielecLogic::getUsedLettersString() const
+{
+    return lettersFromMask(usedMask);
+}
+
+bool WisielecLogic::isLetterUsed(QChar letter) const
+{
+    int index = letterIndex(letter);
+    return index >= 0 && (usedMask & (LetterMask(1) << index));
+}
+
+int WisielecLogic::getRemainingLetters() const
+{
+    return remainingLetters;
+}
+
+QVector<int> WisielecLogic::getLetterPositions(QChar letter) const
+{
+    int index = letterIndex(letter);
+    if (index < 0) return QVector<int>();
+    return positionList.mid(positionStart[index], positionStart[index + 1] - positionStart[index]);
+}
+
+QString WisielecLogic::getWord() const
+{
+    return word;
+}
+
+bool WisielecLogic::isValidWord(const QString &word)
+{
+    if (word.isEmpty()) return false;
+    for (QChar c : word) {
+        if (c != ' ' && letterIndex(c) < 0) return false;
+    }
+    return true;
+}
+
+bool WisielecLogic::isValidLetter(QChar letter)
+{
+    return letterIndex(letter) >= 0;
+}
+
+int WisielecLogic::letterIndex(QChar letter)
+{
+    ushort code = letter.unicode();
+    if (code >= LETTER_TABLE_SIZE) return -1;
+    return letterTable()[code];
+}
+
+QString WisielecLogic::lettersFromMask(LetterMask mask)
+{
+    QString letters;
+    for (int i = 0; i < AlphabetSize; ++i) {
+        if (mask & (LetterMask(1) << i)) letters += ALPHABET[i];
+    }
+    return letters;
+}
+
+void WisielecLogic::checkWinCondition()
+{
+    if (errors >= maxErrors) {
+        state = GameState::Lost;
+        emit gameStateChanged(state);
+        return;
+    }
+
+    if (remainingLetters > 0) {
+        return;
+    }
+
+    state = GameState::Won;
+    emit gameStateChanged(state);
+}
+
+void WisielecLogic::indexWord()
+{
+    // Sortowanie przez zliczanie: jedno przejscie liczy litery, drugie rozklada pozycje.
+    int counts[AlphabetSize] = {};
+    wordMask = 0;
+    remainingLetters = 0;
+
+    for (QChar c : word) {
+        int index = letterIndex(c);
+        if (index < 0) continue;
+        counts[index]++;
+        wordMask |= LetterMask(1) << index;
+        remainingLetters++;
+    }
+
+    positionStart[0] = 0;
+    for (int i = 0; i < AlphabetSize; ++i)
+        positionStart[i + 1] = positionStart[i] + counts[i];
+
+    positionList.resize(remainingLetters);
+    int fill[AlphabetSize];
+    std::copy(positionStart, positionStart + AlphabetSize, fill);
+    for (int pos = 0; pos < word.length(); ++pos) {
+        int index = letterIndex(word[pos]);
+        if (index >= 0) positionList[fill[index]++] = pos;
+    }
+}
+
+QString WisielecLogic::createMask() const
+{
+    QString mask;
+    for (QChar c : word) {
+        if (c == ' ') {
+            mask += "  ";
+        } else if (isLetterUsed(c)) {
+            mask += c;
+            mask += ' ';
+        } else {
+            mask += "_ ";
+        }
+    }
+    return mask.trimmed();
+}
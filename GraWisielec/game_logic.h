@@ -1,57 +1,97 @@
-#ifndef GAME_LOGIC_H
-#define GAME_LOGIC_H
-
-#include <QString>
-#include <QSet>
-#include <QObject>
-#include <QStringList>
-
-class WisielecLogic : public QObject
-{
-    Q_OBJECT
-
-public:
-    enum class GameState
-    {
-        WaitingForWord,
-        Playing,
-        Won,
-        Lost
-    };
-
-    explicit WisielecLogic(QObject *parent = nullptr);
-
-    bool setWord(const QString &word);
-    void generateRandomWord();
-    bool guessLetter(QChar letter);
-    void resetGame();
-
-    QString getMaskedWord() const;
-    GameState getState() const;
-    int getErrors() const;
-    int getMaxErrors() const;
-    QSet<QChar> getUsedLetters() const;
-    QString getWord() const;
-
-    static bool isValidWord(const QString &word);
-    static bool isValidLetter(QChar letter);
-
-signals:
-    void wordSet(const QString &maskedWord);
-    void letterGuessed(QChar letter, bool correct);
-    void gameStateChanged(GameState newState);
-    void errorsChanged(int errors);
-
-private:
-    QString word;
-    QSet<QChar> usedLetters;
-    int errors;
-    int maxErrors;
-    GameState state;
-    QStringList dictionary;
-
-    void checkWinCondition();
-    QString createMask() const;
-};
-
-#endif
+#ifndef GAME_LOGIC_H
+#define GAME_LOGIC_H
+
+#include <QString>
+#include <QVector>
+#include <QObject>
+#include <QStringList>
+#include "dictionary.h"
+#include "solver.h"
+#include "game_rng.h"
+
+class WisielecLogic : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class GameState
+    {
+        WaitingForWord,
+        Playing,
+        Won,
+        Lost
+    };
+
+    // Zestawy liter jako maski bitowe: bit i = litera ALPHABET[i].
+    typedef quint64 LetterMask;
+    static constexpr int AlphabetSize = 35;
+    static const QString ALPHABET;
+
+    explicit WisielecLogic(QObject *parent = nullptr);
+
+    bool setWord(const QString &word);
+    void generateRandomWord();
+    bool loadDictionary(const QString &path);
+    void setWordFilter(int minLength, int maxLength, WisielecDictionary::Difficulty difficulty);
+    bool hasExternalDictionary() const;
+    WisielecSolver::Suggestion suggestLetter();
+    bool guessLetter(QChar letter);
+    void resetGame();
+
+    const QString &getMaskedWord() const;
+    GameState getState() const;
+    int getErrors() const;
+    int getMaxErrors() const;
+    LetterMask getUsedLetters() const;
+    LetterMask getWordLetters() const;
+    QString getUsedLettersString() const;
+    bool isLetterUsed(QChar letter) const;
+    int getRemainingLetters() const;
+    QVector<int> getLetterPositions(QChar letter) const;
+    QString getWord() const;
+
+    // Stan rozgrywki do pliku zapisu (GameSave): haslo, uzyte litery, bledy, filtr i generator.
+    // Wczytac mozna tylko trwajaca gre; sygnaly ida jak po setWord, wiec okno odswieza sie raz.
+    static constexpr quint8 StateVersion = 1;
+    QByteArray saveState() const;
+    bool restoreState(const QByteArray &data);
+
+    static bool isValidWord(const QString &word);
+    static bool isValidLetter(QChar letter);
+    static int letterIndex(QChar letter);
+    static QString lettersFromMask(LetterMask mask);
+
+signals:
+    void wordSet(const QString &maskedWord);
+    void letterGuessed(QChar letter, bool correct);
+    void gameStateChanged(GameState newState);
+    void errorsChanged(int errors);
+
+private:
+    QString word;
+    QString maskedWord;
+    LetterMask usedMask;
+    LetterMask wordMask;
+    int remainingLetters;
+
+    // Pozycje liter w hasle: pozycje litery i to positionList[positionStart[i] .. positionStart[i + 1]).
+    QVector<int> positionList;
+    int positionStart[AlphabetSize + 1];
+    int errors;
+    int maxErrors;
+    GameState state;
+    QStringList dictionary;
+    WisielecDictionary externalDictionary;
+    WisielecSolver solver;
+    bool solverReady;
+    GameRng rng;
+    int filterMinLength;
+    int filterMaxLength;
+    WisielecDictionary::Difficulty filterDifficulty;
+
+    void checkWinCondition();
+    void indexWord();
+    QString createMask() const;
+};
+
+#endif
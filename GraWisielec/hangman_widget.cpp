@@ -0,0 +1,104 @@
+#include "hangman_widget.h"
+#include <QPainter>
+#include <QResizeEvent>
+#include <algorithm>
+
+// Rysunek jest projektowany w ukladzie 300x400 i skalowany z zachowaniem proporcji.
+static const qreal DESIGN_WIDTH = 300.0;
+static const qreal DESIGN_HEIGHT = 400.0;
+
+HangmanWidget::HangmanWidget(QWidget *parent)
+    : QWidget(parent),
+    currentStage(0),
+    cacheDpr(0.0)
+{
+    setMinimumSize(150, 200);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+}
+
+QSize HangmanWidget::sizeHint() const
+{
+    return QSize(300, 400);
+}
+
+int HangmanWidget::stage() const
+{
+    return currentStage;
+}
+
+void HangmanWidget::setErrors(int errors, int maxErrors)
+{
+    // Etapy rozkladaja sie na caly limit bledow, wiec ostatni zawsze oznacza przegrana.
+    int stage = 0;
+    if (maxErrors > 0 && errors > 0) {
+        stage = (std::min(errors, maxErrors) * StageCount + maxErrors - 1) / maxErrors;
+    }
+
+    if (stage == currentStage) return;
+    currentStage = stage;
+    update();
+}
+
+void HangmanWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    cache.clear();
+}
+
+void HangmanWidget::paintEvent(QPaintEvent *)
+{
+    qreal dpr = devicePixelRatioF();
+    if (size() != cacheSize || dpr != cacheDpr) {
+        cache.clear();
+        cacheSize = size();
+        cacheDpr = dpr;
+    }
+
+    auto it = cache.find(currentStage);
+    if (it == cache.end()) it = cache.insert(currentStage, renderStage(currentStage, dpr));
+
+    QPainter p(this);
+    p.drawPixmap(0, 0, it.value());
+}
+
+QPixmap HangmanWidget::renderStage(int stage, qreal dpr) const
+{
+    QPixmap pm(size() * dpr);
+    pm.setDevicePixelRatio(dpr);
+    pm.fill(Qt::white);
+
+    QPainter p(&pm);
+    p.setRenderHint(QPainter::Antialiasing);
+
+    p.setPen(QPen(QColor("#ccc"), 2));
+    p.drawRect(QRectF(1, 1, width() - 2, height() - 2));
+
+    qreal scale = std::min(width() / DESIGN_WIDTH, height() / DESIGN_HEIGHT);
+    p.translate((width() - DESIGN_WIDTH * scale) / 2.0, (height() - DESIGN_HEIGHT * scale) / 2.0);
+    p.scale(scale, scale);
+
+    drawStage(p, stage);
+    return pm;
+}
+
+void HangmanWidget::drawStage(QPainter &p, int stage)
+{
+    QPen pen(Qt::black, 3);
+    pen.setCapStyle(Qt::RoundCap);
+    p.setPen(pen);
+
+    if (stage >= 1) p.drawLine(QPointF(50, 380), QPointF(250, 380));
+    if (stage >= 2) p.drawLine(QPointF(100, 380), QPointF(100, 50));
+    if (stage >= 3) p.drawLine(QPointF(100, 50), QPointF(200, 50));
+    if (stage >= 4) p.drawLine(QPointF(200, 50), QPointF(200, 100));
+    if (stage >= 5) p.drawEllipse(QRectF(175, 100, 50, 50));
+    if (stage >= 6) p.drawLine(QPointF(200, 150), QPointF(200, 250));
+    if (stage >= 7) {
+        p.drawLine(QPointF(200, 170), QPointF(160, 210));
+        p.drawLine(QPointF(200, 170), QPointF(240, 210));
+    }
+    if (stage >= 8) {
+        p.drawLine(QPointF(200, 250), QPointF(170, 320));
+        p.drawLine(QPointF(200, 250), QPointF(230, 320));
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef HANGMAN_WIDGET_H
+#define HANGMAN_WIDGET_H
+
+#include <QWidget>
+#include <QHash>
+#include <QPixmap>
+
+// Szubienica rysowana wektorowo: etapy 0..StageCount skalowane do rozmiaru widgetu.
+// Wyrenderowany etap trafia do pamieci podrecznej dla biezacego rozmiaru i DPR.
+class HangmanWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static constexpr int StageCount = 8;
+
+    explicit HangmanWidget(QWidget *parent = nullptr);
+
+    void setErrors(int errors, int maxErrors);
+    int stage() const;
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    QPixmap renderStage(int stage, qreal dpr) const;
+    static void drawStage(QPainter &p, int stage);
+
+    int currentStage;
+    QHash<int, QPixmap> cache;
+    QSize cacheSize;
+    qreal cacheDpr;
+};
+
+#endif
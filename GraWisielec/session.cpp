@@ -0,0 +1,645 @@
+#include "session.h"
+#include "game_trace.h"
+#include "game_save.h"
+#include <QDataStream>
+#include <QtEndian>
+
+static QByteArray encodeFrame(WisielecSession::MessageType type, const QByteArray &payload)
+{
+    QByteArray out;
+    out.reserve(3 + payload.size());
+    char length[2];
+    qToLittleEndian<quint16>((quint16)(1 + payload.size()), length);
+    out.append(length, 2);
+    out.append((char)type);
+    out.append(payload);
+    return out;
+}
+
+static QString typeName(quint8 type)
+{
+    switch ((WisielecSession::MessageType)type) {
+    case WisielecSession::MessageType::SetWord: return "SetWord";
+    case WisielecSession::MessageType::Guess: return "Guess";
+    case WisielecSession::MessageType::Waiting: return "Waiting";
+    case WisielecSession::MessageType::Start: return "Start";
+    case WisielecSession::MessageType::Letter: return "Letter";
+    case WisielecSession::MessageType::Sync: return "Sync";
+    }
+    return "other";
+}
+
+const QStringList WisielecSession::MessageTypeNames = { "SetWord", "Guess", "Waiting", "Start", "Letter", "Sync" };
+
+static Histogram &turnHistogram()
+{
+    static Histogram &h = MetricsRegistry::instance().histogram(
+        "game_turn_seconds", MetricsRegistry::labels({ { "game", "wisielec" } }));
+    return h;
+}
+
+WisielecSession::WisielecSession(Role role, QObject *parent)
+    : QObject(parent),
+    sessionRole(role),
+    gameLogic(nullptr),
+    server(nullptr),
+    setterPeer(nullptr),
+    departedSetterIndex(-1),
+    pendingMask(0),
+    socket(nullptr),
+    setter(role != Role::Client),
+    mirrorErrors(0),
+    mirrorMaxErrors(0),
+    mirrorState(WisielecLogic::GameState::WaitingForWord),
+    mirrorUsed(0),
+    snapshotId(0)
+{
+    guessTimer.setSingleShot(true);
+    guessTimer.setInterval(GuessTickMs);
+    connect(&guessTimer, &QTimer::timeout, this, &WisielecSession::onGuessTick);
+
+    if (sessionRole == Role::Client) return;
+
+    if (sessionRole == Role::Host) {
+        MetricsRegistry &r = MetricsRegistry::instance();
+        const QString game = MetricsRegistry::labels({ { "game", "wisielec" } });
+        gauges << r.addGauge("game_rooms_active", game, [this]() { return server && server->isListening() ? 1.0 : 0.0; });
+        gauges << r.addGauge("game_connections", game, [this]() { return (double)peers.size(); });
+        gauges << r.addGauge("game_outbound_queue_bytes", game, [this]() {
+            qint64 total = 0;
+            for (QTcpSocket *peer : std::as_const(peers)) total += peer->bytesToWrite();
+            return (double)total;
+        });
+    }
+
+    gameLogic = new WisielecLogic(this);
+    connect(gameLogic, &WisielecLogic::wordSet, this, &WisielecSession::wordSet);
+    connect(gameLogic, &WisielecLogic::letterGuessed, this, &WisielecSession::letterGuessed);
+    connect(gameLogic, &WisielecLogic::gameStateChanged, this, &WisielecSession::gameStateChanged);
+    connect(gameLogic, &WisielecLogic::errorsChanged, this, &WisielecSession::errorsChanged);
+}
+
+WisielecSession::~WisielecSession()
+{
+    for (int id : std::as_const(gauges)) MetricsRegistry::instance().removeGauge(id);
+    close();
+}
+
+WisielecSession::Role WisielecSession::role() const
+{
+    return sessionRole;
+}
+
+WisielecLogic *WisielecSession::logic() const
+{
+    return gameLogic;
+}
+
+bool WisielecSession::listen(quint16 port)
+{
+    if (sessionRole != Role::Host) return false;
+
+    server = new QTcpServer(this);
+    connect(server, &QTcpServer::newConnection, this, &WisielecSession::onNewConnection);
+    if (!server->listen(QHostAddress::Any, port)) return false;
+
+    // Snapshot pokoju tylko w trakcie rundy; miedzy rundami nie ma czego wznawiac.
+    if (GameSnapshots *snapshots = GameSnapshots::instance()) {
+        snapshotId = snapshots->add(QString("wisielec_%1").arg(port), [this]() {
+            if (gameLogic->getState() != WisielecLogic::GameState::Playing) return QByteArray();
+            return GameSave::pack(GameType::Wisielec, WisielecLogic::StateVersion, gameLogic->saveState());
+        });
+    }
+    return true;
+}
+
+void WisielecSession::connectToHost(const QString &host, quint16 port)
+{
+    if (sessionRole != Role::Client) return;
+
+    socket = new QTcpSocket(this);
+    connect(socket, &QTcpSocket::connected, this, &WisielecSession::peerConnected);
+    connect(socket, &QTcpSocket::readyRead, this, [this]() {
+        readFrames(socket, readBuffer);
+    });
+    connect(socket, &QTcpSocket::disconnected, this, [this]() {
+        readBuffer.clear();
+        emit peerDisconnected();
+    });
+    connect(socket, &QTcpSocket::errorOccurred, this, [this](QAbstractSocket::SocketError) {
+        if (socket->state() != QAbstractSocket::ConnectedState) emit connectionFailed();
+    });
+    socket->connectToHost(host, port);
+}
+
+void WisielecSession::close()
+{
+    guessTimer.stop();
+
+    if (snapshotId && GameSnapshots::instance()) GameSnapshots::instance()->remove(snapshotId);
+    snapshotId = 0;
+
+    if (socket) {
+        socket->disconnect(this);
+        socket->close();
+    }
+
+    for (QTcpSocket *peer : std::as_const(peers)) {
+        peer->disconnect(this);
+        peer->close();
+        peer->deleteLater();
+    }
+    peers.clear();
+    peerBuffers.clear();
+    setterPeer = nullptr;
+    departedSetterIndex = -1;
+
+    if (server) server->close();
+}
+
+void WisielecSession::onNewConnection()
+{
+    while (server->hasPendingConnections()) {
+        QTcpSocket *peer = server->nextPendingConnection();
+        if (peers.size() >= MaxGuests) {
+            peer->close();
+            peer->deleteLater();
+            continue;
+        }
+
+        peers.append(peer);
+        peerBuffers.insert(peer, QByteArray());
+        connect(peer, &QTcpSocket::readyRead, this, [this, peer]() {
+            auto it = peerBuffers.find(peer);
+            if (it != peerBuffers.end()) readFrames(peer, it.value());
+        });
+        connect(peer, &QTcpSocket::disconnected, this, [this, peer]() {
+            onPeerDisconnected(peer);
+        });
+
+        // Dolaczajacy dostaje pelny stan tylko dla siebie; reszta pokoju nic nie odbiera.
+        if (gameLogic->getState() == WisielecLogic::GameState::Playing) sendTo(peer, syncFrame(false));
+        else sendTo(peer, waitingFrame(false));
+
+        emit playersChanged(peers.size());
+    }
+}
+
+void WisielecSession::onPeerDisconnected(QTcpSocket *peer)
+{
+    const int index = peers.indexOf(peer);
+    if (index < 0) return;
+    peers.removeAt(index);
+    peerBuffers.remove(peer);
+    peer->deleteLater();
+    if (departedSetterIndex > index) departedSetterIndex--;
+
+    if (peer == setterPeer) {
+        // Nastepca kata siedzi teraz pod jego indeksem; w trakcie rundy przejmie role przy kolejnej.
+        setterPeer = nullptr;
+        departedSetterIndex = index;
+        if (gameLogic->getState() == WisielecLogic::GameState::WaitingForWord) {
+            rotateSetter();
+            sendWaiting();
+            emit roundWaiting(localIsSetter());
+        }
+    }
+
+    emit playersChanged(peers.size());
+}
+
+void WisielecSession::readFrames(QTcpSocket *from, QByteArray &buffer)
+{
+    GAME_TRACE("WisielecSession::readFrames", "net");
+    buffer.append(from->readAll());
+
+    while (buffer.size() >= 2) {
+        quint16 length = qFromLittleEndian<quint16>(buffer.constData());
+        if (length == 0 || length > MaxFrameSize) {
+            // Zepsuty strumien - nie da sie odnalezc granicy kolejnej ramki.
+            static Counter &parseErrors = MetricsRegistry::instance().counter(
+                "game_parse_errors_total", MetricsRegistry::labels({ { "game", "wisielec" } }));
+            parseErrors.add();
+            buffer.clear();
+            from->abort();
+            return;
+        }
+        if (buffer.size() < 2 + length) break;
+
+        MessageType type = (MessageType)(quint8)buffer[2];
+        if (sessionRole == Role::Host) inCounters.count(typeName((quint8)type), 2 + length);
+        QByteArray payload = buffer.mid(3, length - 1);
+        buffer.remove(0, 2 + length);
+
+        if (sessionRole == Role::Host) handleHostFrame(from, type, payload);
+        else handleClientFrame(type, payload);
+    }
+}
+
+void WisielecSession::sendTo(QTcpSocket *peer, const QByteArray &frames)
+{
+    GAME_TRACE("WisielecSession::sendTo", "net");
+    if (!peer || peer->state() != QAbstractSocket::ConnectedState) return;
+    peer->write(frames);
+
+    if (sessionRole != Role::Host) return;
+    for (int at = 0; at + 3 <= frames.size();) {
+        int length = qFromLittleEndian<quint16>(frames.constData() + at);
+        outCounters.count(typeName((quint8)frames[at + 2]), 2 + length);
+        at += 2 + length;
+    }
+}
+
+void WisielecSession::broadcast(const QByteArray &frames)
+{
+    // Te same bajty dla kazdego goscia - koszt rozgloszenia to jedno kodowanie i N zapisow.
+    for (QTcpSocket *peer : std::as_const(peers)) sendTo(peer, frames);
+}
+
+void WisielecSession::handleHostFrame(QTcpSocket *from, MessageType type, const QByteArray &payload)
+{
+    ScopedTimer timer(turnHistogram());
+    QDataStream in(payload);
+    in.setByteOrder(QDataStream::LittleEndian);
+
+    if (type == MessageType::SetWord) {
+        quint8 n = 0;
+        in >> n;
+        if (n == 0 || n > MaxWordLength) return;
+
+        QString word;
+        word.reserve(n);
+        for (int i = 0; i < n; ++i) {
+            quint16 c = 0;
+            in >> c;
+            word += QChar(c);
+        }
+        if (in.status() != QDataStream::Ok) return;
+
+        // Haslo ustawia tylko ten, kto ma teraz role kata.
+        if (from != setterPeer || gameLogic->getState() != WisielecLogic::GameState::WaitingForWord) return;
+        if (gameLogic->setWord(word)) sendStart();
+    }
+    else if (type == MessageType::Guess) {
+        quint16 c = 0;
+        in >> c;
+        if (in.status() != QDataStream::Ok) return;
+
+        if (from == setterPeer || gameLogic->getState() != WisielecLogic::GameState::Playing) return;
+        queueGuess(QChar(c));
+    }
+}
+
+void WisielecSession::queueGuess(QChar letter)
+{
+    QChar upper = letter.toUpper();
+    int index = WisielecLogic::letterIndex(upper);
+    if (index < 0) return;
+
+    // Ta sama litera od kilku graczy w jednym takcie liczy sie raz.
+    WisielecLogic::LetterMask bit = WisielecLogic::LetterMask(1) << index;
+    if (pendingMask & bit) return;
+    pendingMask |= bit;
+    pendingGuesses.append(upper);
+
+    if (!guessTimer.isActive()) guessTimer.start();
+}
+
+void WisielecSession::onGuessTick()
+{
+    ScopedTimer timer(turnHistogram());
+    QVector<QChar> guesses;
+    guesses.swap(pendingGuesses);
+    pendingMask = 0;
+
+    // Wszystkie delty z taktu ida jednym zapisem na goscia.
+    QByteArray frames;
+    for (QChar letter : std::as_const(guesses)) {
+        if (gameLogic->getState() != WisielecLogic::GameState::Playing) break;
+        if (!gameLogic->guessLetter(letter)) continue;
+
+        WisielecLogic::LetterMask bit = WisielecLogic::LetterMask(1) << WisielecLogic::letterIndex(letter);
+        frames += letterFrame(letter, (gameLogic->getWordLetters() & bit) != 0);
+    }
+
+    if (!frames.isEmpty()) broadcast(frames);
+}
+
+void WisielecSession::handleClientFrame(MessageType type, const QByteArray &payload)
+{
+    QDataStream in(payload);
+    in.setByteOrder(QDataStream::LittleEndian);
+
+    if (type == MessageType::Waiting) {
+        quint8 receiverSets = 0;
+        in >> receiverSets;
+        if (in.status() != QDataStream::Ok) return;
+
+        setter = receiverSets != 0;
+        mirrorMask.clear();
+        mirrorUsed = 0;
+        mirrorErrors = 0;
+        mirrorState = WisielecLogic::GameState::WaitingForWord;
+
+        emit gameStateChanged(mirrorState);
+        emit errorsChanged(mirrorErrors);
+        emit roundWaiting(setter);
+    }
+    else if (type == MessageType::Start) {
+        quint8 length = 0, maxErrors = 0, receiverSets = 0, spaces = 0;
+        in >> length >> maxErrors >> receiverSets >> spaces;
+        if (in.status() != QDataStream::Ok || length == 0 || length > MaxWordLength) return;
+
+        QString pattern(length, '_');
+        for (int i = 0; i < spaces; ++i) {
+            quint8 pos = 0;
+            in >> pos;
+            if (pos < length) pattern[pos] = ' ';
+        }
+        if (in.status() != QDataStream::Ok) return;
+
+        setter = receiverSets != 0;
+        applyMirror(pattern, maxErrors, 0, WisielecLogic::GameState::Playing, 0);
+    }
+    else if (type == MessageType::Sync) {
+        quint8 length = 0, maxErrors = 0, errors = 0, state = 0, receiverSets = 0;
+        quint64 used = 0;
+        in >> length >> maxErrors >> errors >> state >> receiverSets >> used;
+        if (in.status() != QDataStream::Ok || length == 0 || length > MaxWordLength) return;
+        if (state > (quint8)WisielecLogic::GameState::Lost) return;
+
+        QString pattern;
+        pattern.reserve(length);
+        for (int i = 0; i < length; ++i) {
+            quint16 c = 0;
+            in >> c;
+            pattern += QChar(c);
+        }
+        if (in.status() != QDataStream::Ok) return;
+
+        setter = receiverSets != 0;
+        applyMirror(pattern, maxErrors, errors, (WisielecLogic::GameState)state, used);
+    }
+    else if (type == MessageType::Letter) {
+        quint16 c = 0;
+        quint8 correct = 0, errors = 0, state = 0, count = 0;
+        in >> c >> correct >> errors >> state >> count;
+        if (in.status() != QDataStream::Ok) return;
+
+        QChar letter(c);
+        int index = WisielecLogic::letterIndex(letter);
+        if (index < 0 || state > (quint8)WisielecLogic::GameState::Lost) return;
+
+        for (int i = 0; i < count; ++i) {
+            quint8 pos = 0;
+            in >> pos;
+            if (in.status() != QDataStream::Ok) return;
+            if (2 * pos < mirrorMask.size()) mirrorMask[2 * pos] = letter;
+        }
+
+        mirrorUsed |= WisielecLogic::LetterMask(1) << index;
+
+        if (errors != mirrorErrors) {
+            mirrorErrors = errors;
+            emit errorsChanged(mirrorErrors);
+        }
+        emit letterGuessed(letter, correct != 0);
+
+        WisielecLogic::GameState newState = (WisielecLogic::GameState)state;
+        if (newState != mirrorState) {
+            mirrorState = newState;
+            emit gameStateChanged(mirrorState);
+        }
+    }
+}
+
+QByteArray WisielecSession::waitingFrame(bool receiverSets) const
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << (quint8)(receiverSets ? 1 : 0);
+    return encodeFrame(MessageType::Waiting, payload);
+}
+
+QByteArray WisielecSession::startFrame(bool receiverSets) const
+{
+    const QString word = gameLogic->getWord();
+
+    QByteArray spaces;
+    for (int i = 0; i < word.length(); ++i) {
+        if (word[i] == ' ') spaces.append((char)i);
+    }
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << (quint8)word.length() << (quint8)gameLogic->getMaxErrors()
+        << (quint8)(receiverSets ? 1 : 0) << (quint8)spaces.size();
+    out.writeRawData(spaces.constData(), spaces.size());
+    return encodeFrame(MessageType::Start, payload);
+}
+
+QByteArray WisielecSession::letterFrame(QChar letter, bool correct) const
+{
+    // Delta: tylko nowa litera i odsloniete przez nia pozycje, nie cala maska.
+    QVector<int> positions = gameLogic->getLetterPositions(letter);
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << (quint16)letter.unicode() << (quint8)(correct ? 1 : 0)
+        << (quint8)gameLogic->getErrors() << (quint8)gameLogic->getState()
+        << (quint8)(correct ? positions.size() : 0);
+    if (correct) {
+        for (int pos : positions) out << (quint8)pos;
+    }
+    return encodeFrame(MessageType::Letter, payload);
+}
+
+QByteArray WisielecSession::syncFrame(bool receiverSets) const
+{
+    const QString word = gameLogic->getWord();
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << (quint8)word.length() << (quint8)gameLogic->getMaxErrors() << (quint8)gameLogic->getErrors()
+        << (quint8)gameLogic->getState() << (quint8)(receiverSets ? 1 : 0)
+        << (quint64)gameLogic->getUsedLetters();
+    for (QChar c : word) {
+        bool shown = c == ' ' || gameLogic->isLetterUsed(c);
+        out << (quint16)(shown ? c.unicode() : '_');
+    }
+    return encodeFrame(MessageType::Sync, payload);
+}
+
+void WisielecSession::sendWaiting()
+{
+    // Ramka rozni sie tylko bajtem roli, wiec kodujemy dwa warianty zamiast N.
+    QByteArray guesser = waitingFrame(false);
+    for (QTcpSocket *peer : std::as_const(peers)) sendTo(peer, peer == setterPeer ? waitingFrame(true) : guesser);
+}
+
+void WisielecSession::sendStart()
+{
+    QByteArray guesser = startFrame(false);
+    for (QTcpSocket *peer : std::as_const(peers)) sendTo(peer, peer == setterPeer ? startFrame(true) : guesser);
+}
+
+void WisielecSession::rotateSetter()
+{
+    // Kolejnosc: host, potem goscie w kolejnosci dolaczenia.
+    if (peers.isEmpty()) {
+        setterPeer = nullptr;
+        departedSetterIndex = -1;
+        return;
+    }
+
+    if (departedSetterIndex >= 0) {
+        setterPeer = departedSetterIndex < peers.size() ? peers[departedSetterIndex] : nullptr;
+        departedSetterIndex = -1;
+        return;
+    }
+
+    if (!setterPeer) {
+        setterPeer = peers.first();
+        return;
+    }
+
+    int i = peers.indexOf(setterPeer);
+    setterPeer = (i >= 0 && i + 1 < peers.size()) ? peers[i + 1] : nullptr;
+}
+
+bool WisielecSession::submitWord(const QString &word)
+{
+    QString trimmed = word.trimmed().toUpper();
+    if (trimmed.length() > MaxWordLength || !WisielecLogic::isValidWord(trimmed)) return false;
+
+    if (sessionRole == Role::Client) {
+        if (!setter) return false;
+
+        QByteArray payload;
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setByteOrder(QDataStream::LittleEndian);
+        out << (quint8)trimmed.length();
+        for (QChar c : trimmed) out << (quint16)c.unicode();
+        sendTo(socket, encodeFrame(MessageType::SetWord, payload));
+        return true;
+    }
+
+    if (sessionRole == Role::Host && !localIsSetter()) return false;
+    if (!gameLogic->setWord(trimmed)) return false;
+    if (sessionRole == Role::Host) sendStart();
+    return true;
+}
+
+bool WisielecSession::guess(QChar letter)
+{
+    QChar upper = letter.toUpper();
+    int index = WisielecLogic::letterIndex(upper);
+    if (index < 0) return false;
+
+    if (sessionRole == Role::Client) {
+        if (setter || mirrorState != WisielecLogic::GameState::Playing) return false;
+        if (mirrorUsed & (WisielecLogic::LetterMask(1) << index)) return false;
+
+        QByteArray payload;
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setByteOrder(QDataStream::LittleEndian);
+        out << (quint16)upper.unicode();
+        sendTo(socket, encodeFrame(MessageType::Guess, payload));
+        return true;
+    }
+
+    if (sessionRole == Role::Host) {
+        // Host zgaduje na rowni z goscmi - przez ten sam takt.
+        if (localIsSetter() || gameLogic->getState() != WisielecLogic::GameState::Playing) return false;
+        if (gameLogic->getUsedLetters() & (WisielecLogic::LetterMask(1) << index)) return false;
+        queueGuess(upper);
+        return true;
+    }
+
+    return gameLogic->guessLetter(upper);
+}
+
+void WisielecSession::startNextRound()
+{
+    if (sessionRole == Role::Client) return;
+
+    guessTimer.stop();
+    pendingGuesses.clear();
+    pendingMask = 0;
+    gameLogic->resetGame();
+
+    if (sessionRole == Role::Host) {
+        rotateSetter();
+        sendWaiting();
+        emit roundWaiting(localIsSetter());
+    }
+}
+
+const QString &WisielecSession::maskedWord() const
+{
+    return gameLogic ? gameLogic->getMaskedWord() : mirrorMask;
+}
+
+int WisielecSession::errors() const
+{
+    return gameLogic ? gameLogic->getErrors() : mirrorErrors;
+}
+
+int WisielecSession::maxErrors() const
+{
+    return gameLogic ? gameLogic->getMaxErrors() : mirrorMaxErrors;
+}
+
+WisielecLogic::GameState WisielecSession::state() const
+{
+    return gameLogic ? gameLogic->getState() : mirrorState;
+}
+
+WisielecLogic::LetterMask WisielecSession::usedLetters() const
+{
+    return gameLogic ? gameLogic->getUsedLetters() : mirrorUsed;
+}
+
+bool WisielecSession::localIsSetter() const
+{
+    // Kat-gosc, ktory wyszedl w trakcie rundy, zostawia setterPeer pusty, ale host dalej zgaduje.
+    if (sessionRole == Role::Host) return setterPeer == nullptr && departedSetterIndex < 0;
+    return setter;
+}
+
+int WisielecSession::guestCount() const
+{
+    return peers.size();
+}
+
+void WisielecSession::applyMirror(const QString &pattern, int maxErrors, int errors,
+                                  WisielecLogic::GameState state, WisielecLogic::LetterMask used)
+{
+    mirrorUsed = used;
+    mirrorErrors = errors;
+    mirrorMaxErrors = maxErrors;
+    mirrorState = state;
+    rebuildMask(pattern);
+
+    emit wordSet(mirrorMask);
+    emit gameStateChanged(mirrorState);
+    emit errorsChanged(mirrorErrors);
+}
+
+void WisielecSession::rebuildMask(const QString &pattern)
+{
+    // Ten sam format co WisielecLogic::getMaskedWord(): znak i pod indeksem 2 * i.
+    mirrorMask.clear();
+    for (QChar c : pattern) {
+        if (c == ' ') mirrorMask += "  ";
+        else {
+            mirrorMask += c;
+            mirrorMask += ' ';
+        }
+    }
+    mirrorMask = mirrorMask.trimmed();
+}
@@ -0,0 +1,150 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QTimer>
+#include <QVector>
+#include "game_logic.h"
+#include "game_metrics.h"
+
+// Sesja Wisielca: wlasciciel logiki i protokolu sieciowego, okno zostaje samym widokiem.
+// Host (i gra lokalna) trzyma autorytatywny WisielecLogic, klient - lustro odtwarzane z delt.
+// Host prowadzi pokoj: jeden kat i dowolnie wielu zgadujacych; rola kata przechodzi po kolei.
+//
+// Ramka: quint16 dlugosc (little-endian, bez tych 2 bajtow) | quint8 typ | dane.
+//   SetWord  klient->host  quint8 n, n x quint16 znak
+//   Guess    klient->host  quint16 litera
+//   Waiting  host->klient  quint8 odbiorcaUstawia
+//   Start    host->klient  quint8 dlugosc, quint8 maxBledow, quint8 odbiorcaUstawia, quint8 k, k x quint8 pozycjaSpacji
+//   Letter   host->klient  quint16 litera, quint8 trafiona, quint8 bledy, quint8 stan, quint8 k, k x quint8 pozycja
+//   Sync     host->klient  quint8 dlugosc, quint8 maxBledow, quint8 bledy, quint8 stan, quint8 odbiorcaUstawia,
+//                          quint64 uzyteLitery, dlugosc x quint16 znak ('_' = zakryty) - tylko dla dolaczajacego
+class WisielecSession : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Role
+    {
+        Local,
+        Host,
+        Client
+    };
+
+    enum class MessageType : quint8
+    {
+        SetWord = 1,
+        Guess = 2,
+        Waiting = 3,
+        Start = 4,
+        Letter = 5,
+        Sync = 6
+    };
+
+    static constexpr int MaxWordLength = 64;
+    static constexpr int MaxFrameSize = 256;
+    static constexpr int MaxGuests = 100;
+    static constexpr int GuessTickMs = 40;
+
+    explicit WisielecSession(Role role, QObject *parent = nullptr);
+    ~WisielecSession();
+
+    Role role() const;
+    WisielecLogic *logic() const;
+
+    bool listen(quint16 port);
+    void connectToHost(const QString &host, quint16 port);
+    void close();
+
+    bool submitWord(const QString &word);
+    bool guess(QChar letter);
+    void startNextRound();
+
+    const QString &maskedWord() const;
+    int errors() const;
+    int maxErrors() const;
+    WisielecLogic::GameState state() const;
+    WisielecLogic::LetterMask usedLetters() const;
+    bool localIsSetter() const;
+    int guestCount() const;
+
+signals:
+    void peerConnected();
+    void peerDisconnected();
+    void connectionFailed();
+    void playersChanged(int guests);
+    void roundWaiting(bool localIsSetter);
+
+    void wordSet(const QString &maskedWord);
+    void letterGuessed(QChar letter, bool correct);
+    void gameStateChanged(WisielecLogic::GameState newState);
+    void errorsChanged(int errors);
+
+private slots:
+    void onNewConnection();
+    void onGuessTick();
+
+private:
+    void readFrames(QTcpSocket *from, QByteArray &buffer);
+    void handleHostFrame(QTcpSocket *from, MessageType type, const QByteArray &payload);
+    void handleClientFrame(MessageType type, const QByteArray &payload);
+    void onPeerDisconnected(QTcpSocket *peer);
+
+    void sendTo(QTcpSocket *peer, const QByteArray &frames);
+    void broadcast(const QByteArray &frames);
+    void queueGuess(QChar letter);
+
+    QByteArray waitingFrame(bool receiverSets) const;
+    QByteArray startFrame(bool receiverSets) const;
+    QByteArray letterFrame(QChar letter, bool correct) const;
+    QByteArray syncFrame(bool receiverSets) const;
+
+    void sendWaiting();
+    void sendStart();
+    void rotateSetter();
+
+    void applyMirror(const QString &pattern, int maxErrors, int errors,
+                     WisielecLogic::GameState state, WisielecLogic::LetterMask used);
+    void rebuildMask(const QString &pattern);
+
+    Role sessionRole;
+    WisielecLogic *gameLogic;
+
+    // Host: goscie w kolejnosci dolaczenia; setterPeer == nullptr oznacza, ze katem jest host.
+    QTcpServer *server;
+    QList<QTcpSocket *> peers;
+    QHash<QTcpSocket *, QByteArray> peerBuffers;
+    QTcpSocket *setterPeer;
+    // Pozycja kata, ktory wyszedl: rola przechodzi na gracza, ktory byl po nim w kolejce.
+    // Do konca rundy (>= 0) nikt nie jest katem, wiec host zgaduje dalej.
+    int departedSetterIndex;
+
+    // Zgadywania z jednego taktu: kolejnosc przyjscia, duplikaty liter scalone.
+    QVector<QChar> pendingGuesses;
+    WisielecLogic::LetterMask pendingMask;
+    QTimer guessTimer;
+
+    // Klient: polaczenie z hostem i lustro stanu.
+    QTcpSocket *socket;
+    QByteArray readBuffer;
+    bool setter;
+    QString mirrorMask;
+    int mirrorErrors;
+    int mirrorMaxErrors;
+    WisielecLogic::GameState mirrorState;
+    WisielecLogic::LetterMask mirrorUsed;
+
+    // Host: liczniki ramek per typ i mierniki pokoju w rejestrze metryk.
+    static const QStringList MessageTypeNames;
+    MessageCounters inCounters{ "wisielec", "in", MessageTypeNames };
+    MessageCounters outCounters{ "wisielec", "out", MessageTypeNames };
+    QVector<int> gauges;
+    int snapshotId;
+};
+
+#endif
@@ -0,0 +1,277 @@
+#include "solver.h"
+#include "dictionary.h"
+#include "game_logic.h"
+#include <QHash>
+#include <QtAlgorithms>
+#include <cmath>
+#include <utility>
+
+static_assert(WisielecLogic::AlphabetSize == 35, "Solver zaklada alfabet klawiatury Wisielca");
+
+// Kolejnosc wg czestosci liter w polszczyznie - gdy hasla nie ma w slowniku.
+static const QString FREQUENCY_ORDER = "AIOEZNRWSCTYKDPMUJLŁBGĘHĄÓŻŚĆFŃQŹVX";
+
+// Ponizej tej liczby kandydatow liczymy pelny rozklad wzorcow odsloniec, powyzej tylko trafienie/pudlo.
+static const int EXACT_SPLIT_LIMIT = 4096;
+
+WisielecSolver::WisielecSolver()
+{
+}
+
+void WisielecSolver::clear()
+{
+    for (Group &g : groups)
+        g = Group();
+}
+
+bool WisielecSolver::isEmpty() const
+{
+    for (const Group &g : groups) {
+        if (g.count > 0) return false;
+    }
+    return true;
+}
+
+void WisielecSolver::build(const QStringList &words)
+{
+    buildIndex(words.size(), [&words](int i) { return (int)words[i].length(); }, [&words](int i) { return words[i]; });
+}
+
+void WisielecSolver::build(const WisielecDictionary &dictionary)
+{
+    buildIndex(dictionary.size(), [&dictionary](int i) { return dictionary.wordLength(i); },
+               [&dictionary](int i) { return dictionary.wordAt(i); });
+}
+
+void WisielecSolver::buildIndex(int count, const std::function<int(int)> &lengthAt, const std::function<QString(int)> &wordAt)
+{
+    clear();
+
+    // Pierwsze przejscie liczy slowa w grupach, zeby kazdy bitset zaalokowac raz;
+    // dlugosc slowa ze slownika to roznica offsetow, bez dekodowania znakow.
+    for (int i = 0; i < count; ++i) {
+        int len = lengthAt(i);
+        if (len > 0 && len <= MaxLength) groups[len].count++;
+    }
+
+    for (int len = 1; len <= MaxLength; ++len) {
+        Group &g = groups[len];
+        g.length = len;
+        g.blocks = (g.count + 63) / 64;
+        g.letters.resize(g.count * len);
+        g.positionBits.fill(0, len * Symbols * g.blocks);
+        g.containsBits.fill(0, Letters * g.blocks);
+        g.count = 0;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        QString w = wordAt(i);
+        int len = w.length();
+        if (len <= 0 || len > MaxLength) continue;
+
+        Group &g = groups[len];
+        int slot = g.count;
+        quint8 *letters = g.letters.data() + slot * len;
+
+        bool valid = true;
+        for (int pos = 0; pos < len && valid; ++pos) {
+            int symbol = (w[pos] == ' ') ? SpaceSymbol : WisielecLogic::letterIndex(w[pos]);
+            valid = symbol >= 0;
+            letters[pos] = (quint8)symbol;
+        }
+        if (!valid) continue;
+
+        int block = slot >> 6;
+        quint64 bit = quint64(1) << (slot & 63);
+        for (int pos = 0; pos < len; ++pos) {
+            int symbol = letters[pos];
+            g.positionBits[(pos * Symbols + symbol) * g.blocks + block] |= bit;
+            if (symbol != SpaceSymbol)
+                g.containsBits[symbol * g.blocks + block] |= bit;
+        }
+        g.count++;
+    }
+
+    for (Group &g : groups)
+        g.letters.resize(g.count * g.length);
+}
+
+bool WisielecSolver::filter(const QString &masked, LetterMask used, const Group *&group, QVector<quint64> &result) const
+{
+    // Znak i hasla stoi w masce pod indeksem 2 * i; ' ' to spacja hasla, '_' nieodgadnieta litera.
+    if (masked.isEmpty()) return false;
+    int len = (masked.length() + 1) / 2;
+    if (len > MaxLength) return false;
+
+    const Group &g = groups[len];
+    group = &g;
+    result.fill(~quint64(0), g.blocks);
+    if (g.blocks == 0) return true;
+    if (g.count & 63)
+        result[g.blocks - 1] = (quint64(1) << (g.count & 63)) - 1;
+
+    int symbols[MaxLength];
+    LetterMask revealed = 0;
+    for (int pos = 0; pos < len; ++pos) {
+        QChar c = masked[2 * pos];
+        if (c == '_') {
+            symbols[pos] = -1;
+        } else if (c == ' ') {
+            symbols[pos] = SpaceSymbol;
+        } else {
+            int index = WisielecLogic::letterIndex(c);
+            if (index < 0) return false;
+            symbols[pos] = index;
+            revealed |= LetterMask(1) << index;
+        }
+    }
+
+    quint64 *r = result.data();
+    for (int pos = 0; pos < len; ++pos) {
+        if (symbols[pos] >= 0) {
+            const quint64 *bits = g.position(pos, symbols[pos]);
+            for (int b = 0; b < g.blocks; ++b) r[b] &= bits[b];
+            continue;
+        }
+
+        // Zakryta pozycja: nie spacja i nie zadna z odslonietych liter (te sa odslaniane wszedzie).
+        const quint64 *space = g.position(pos, SpaceSymbol);
+        for (int b = 0; b < g.blocks; ++b) r[b] &= ~space[b];
+        for (LetterMask m = revealed; m; m &= m - 1) {
+            const quint64 *bits = g.position(pos, qCountTrailingZeroBits(m));
+            for (int b = 0; b < g.blocks; ++b) r[b] &= ~bits[b];
+        }
+    }
+
+    for (LetterMask m = used & ~revealed; m; m &= m - 1) {
+        int letter = qCountTrailingZeroBits(m);
+        if (letter >= Letters) break;
+        const quint64 *bits = g.contains(letter);
+        for (int b = 0; b < g.blocks; ++b) r[b] &= ~bits[b];
+    }
+    return true;
+}
+
+int WisielecSolver::candidateCount(const QString &masked, LetterMask used) const
+{
+    const Group *g = nullptr;
+    QVector<quint64> bits;
+    if (!filter(masked, used, g, bits)) return 0;
+
+    int n = 0;
+    for (quint64 b : bits) n += qPopulationCount(b);
+    return n;
+}
+
+QStringList WisielecSolver::candidates(const QString &masked, LetterMask used, int limit) const
+{
+    QStringList out;
+    const Group *g = nullptr;
+    QVector<quint64> bits;
+    if (!filter(masked, used, g, bits)) return out;
+
+    for (int b = 0; b < bits.size() && out.size() < limit; ++b) {
+        for (quint64 m = bits[b]; m && out.size() < limit; m &= m - 1) {
+            int slot = b * 64 + qCountTrailingZeroBits(m);
+            const quint8 *letters = g->letters.constData() + slot * g->length;
+            QString w;
+            w.reserve(g->length);
+            for (int pos = 0; pos < g->length; ++pos)
+                w += (letters[pos] == SpaceSymbol) ? QChar(' ') : WisielecLogic::ALPHABET[letters[pos]];
+            out << w;
+        }
+    }
+    return out;
+}
+
+static double entropy(const int *counts, int size, int total)
+{
+    double h = 0.0;
+    for (int i = 0; i < size; ++i) {
+        if (counts[i] <= 0) continue;
+        double p = double(counts[i]) / total;
+        h -= p * std::log2(p);
+    }
+    return h;
+}
+
+WisielecSolver::Suggestion WisielecSolver::suggest(const QString &masked, LetterMask used) const
+{
+    Suggestion best;
+
+    const Group *g = nullptr;
+    QVector<quint64> bits;
+    int total = 0;
+    if (filter(masked, used, g, bits)) {
+        for (quint64 b : bits) total += qPopulationCount(b);
+    }
+    best.candidates = total;
+
+    auto byFrequency = [used]() {
+        for (QChar c : FREQUENCY_ORDER) {
+            if (!(used & (LetterMask(1) << WisielecLogic::letterIndex(c)))) return c;
+        }
+        return QChar();
+    };
+
+    if (total == 0) {
+        best.letter = byFrequency();
+        return best;
+    }
+
+    int hits[Letters] = {};
+    for (int letter = 0; letter < Letters; ++letter) {
+        if (used & (LetterMask(1) << letter)) continue;
+        const quint64 *c = g->contains(letter);
+        for (int b = 0; b < g->blocks; ++b) hits[letter] += qPopulationCount(bits[b] & c[b]);
+    }
+
+    double info[Letters] = {};
+    if (total <= EXACT_SPLIT_LIMIT) {
+        // Wzorzec odsloniecia litery = maska pozycji; odpowiedz dzieli kandydatow na klasy wzorcow.
+        QHash<quint32, int> splits[Letters];
+        for (int b = 0; b < bits.size(); ++b) {
+            for (quint64 m = bits[b]; m; m &= m - 1) {
+                int slot = b * 64 + qCountTrailingZeroBits(m);
+                const quint8 *letters = g->letters.constData() + slot * g->length;
+                quint32 patterns[Letters] = {};
+                for (int pos = 0; pos < g->length; ++pos) {
+                    if (letters[pos] != SpaceSymbol) patterns[letters[pos]] |= quint32(1) << pos;
+                }
+                for (int letter = 0; letter < Letters; ++letter) {
+                    if (hits[letter] > 0) splits[letter][patterns[letter]]++;
+                }
+            }
+        }
+        for (int letter = 0; letter < Letters; ++letter) {
+            if (hits[letter] == 0) continue;
+            QVector<int> counts;
+            counts.reserve(splits[letter].size());
+            for (int n : std::as_const(splits[letter])) counts << n;
+            info[letter] = entropy(counts.constData(), counts.size(), total);
+        }
+    } else {
+        for (int letter = 0; letter < Letters; ++letter) {
+            int counts[2] = { hits[letter], total - hits[letter] };
+            info[letter] = entropy(counts, 2, total);
+        }
+    }
+
+    // Przy rownej informacji wolimy litere, ktora czesciej trafia (mniej bledow).
+    int bestLetter = -1;
+    for (int letter = 0; letter < Letters; ++letter) {
+        if (hits[letter] == 0) continue;
+        if (bestLetter < 0 || info[letter] > info[bestLetter] + 1e-9
+            || (std::abs(info[letter] - info[bestLetter]) <= 1e-9 && hits[letter] > hits[bestLetter]))
+            bestLetter = letter;
+    }
+
+    if (bestLetter < 0) {
+        best.letter = byFrequency();
+        return best;
+    }
+
+    best.letter = WisielecLogic::ALPHABET[bestLetter];
+    best.information = info[bestLetter];
+    return best;
+}
@@ -0,0 +1,63 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+
+class WisielecDictionary;
+
+// Podpowiedzi i bot zgadujacy. Indeks jest budowany raz dla slownika: slowa pogrupowane
+// po dlugosci, dla kazdej grupy bitsety "litera X na pozycji p" i "slowo zawiera X"
+// (bit = slowo w grupie). Filtrowanie wzorca to AND/ANDNOT na 64-bitowych blokach.
+class WisielecSolver
+{
+public:
+    typedef quint64 LetterMask;
+
+    struct Suggestion
+    {
+        QChar letter;
+        int candidates = 0;
+        double information = 0.0;
+    };
+
+    WisielecSolver();
+
+    void build(const QStringList &words);
+    void build(const WisielecDictionary &dictionary);
+    void clear();
+    bool isEmpty() const;
+
+    // masked w formacie WisielecLogic::getMaskedWord(), used = WisielecLogic::getUsedLetters().
+    int candidateCount(const QString &masked, LetterMask used) const;
+    QStringList candidates(const QString &masked, LetterMask used, int limit = 20) const;
+    Suggestion suggest(const QString &masked, LetterMask used) const;
+
+private:
+    struct Group
+    {
+        int length = 0;
+        int count = 0;
+        int blocks = 0;
+        QVector<quint8> letters;         // [slowo * length + pozycja] = symbol
+        QVector<quint64> positionBits;   // [(pozycja * Symbols + symbol) * blocks + blok]
+        QVector<quint64> containsBits;   // [litera * blocks + blok]
+
+        const quint64 *position(int pos, int symbol) const { return positionBits.constData() + (pos * Symbols + symbol) * blocks; }
+        const quint64 *contains(int letter) const { return containsBits.constData() + letter * blocks; }
+    };
+
+    static constexpr int MaxLength = 32;
+    static constexpr int Letters = 35;
+    static constexpr int SpaceSymbol = Letters;
+    static constexpr int Symbols = Letters + 1;
+
+    void buildIndex(int count, const std::function<int(int)> &lengthAt, const std::function<QString(int)> &wordAt);
+    bool filter(const QString &masked, LetterMask used, const Group *&group, QVector<quint64> &result) const;
+
+    Group groups[MaxLength + 1];
+};
+
+#endif
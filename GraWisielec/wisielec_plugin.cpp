@@ -0,0 +1,17 @@
+#include "wisielec_plugin.h"
+#include "wisielec_window.h"
+
+QMainWindow *WisielecPlugin::createWindow(const GameLaunchConfig &config)
+{
+    return new WisielecWindow(config);
+}
+
+void WisielecPlugin::resetWindow(QMainWindow *window, const GameLaunchConfig &config)
+{
+    static_cast<WisielecWindow *>(window)->reset(config);
+}
+
+void WisielecPlugin::suspendWindow(QMainWindow *window)
+{
+    static_cast<WisielecWindow *>(window)->suspend();
+}
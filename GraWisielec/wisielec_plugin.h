@@ -0,0 +1,19 @@
+#ifndef WISIELEC_PLUGIN_H
+#define WISIELEC_PLUGIN_H
+
+#include <QObject>
+#include "game_plugin.h"
+
+class WisielecPlugin : public QObject, public GamePlugin
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID GamePlugin_iid FILE "wisielec_plugin.json")
+    Q_INTERFACES(GamePlugin)
+
+public:
+    QMainWindow *createWindow(const GameLaunchConfig &config) override;
+    void resetWindow(QMainWindow *window, const GameLaunchConfig &config) override;
+    void suspendWindow(QMainWindow *window) override;
+};
+
+#endif
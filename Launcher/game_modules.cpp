@@ -0,0 +1,161 @@
+#include "game_modules.h"
+#include "game_plugin.h"
+#include "game_metrics.h"
+#include "game_trace.h"
+#include "startup_profile.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QJsonObject>
+#include <QLibrary>
+#include <QPluginLoader>
+#include <algorithm>
+
+static QString gameLabel(GameType type)
+{
+    switch (type) {
+    case GameType::Wisielec: return "wisielec";
+    case GameType::Kosci: return "kosci";
+    case GameType::Chinczyk: return "ludo";
+    }
+    return "?";
+}
+
+static bool parseGameType(const QString &text, GameType &type)
+{
+    if (text == "Wisielec") type = GameType::Wisielec;
+    else if (text == "Kosci") type = GameType::Kosci;
+    else if (text == "Chinczyk") type = GameType::Chinczyk;
+    else return false;
+    return true;
+}
+
+GameModules::GameModules(QObject *parent) : QObject(parent)
+{
+}
+
+GameModules::~GameModules()
+{
+    // Okna sa kodem z wtyczek, wiec znikaja przed loaderami; bibliotek i tak nie odladowujemy.
+    // Wstrzymanie przed usunieciem zamyka siec i robi autozapis gry przerwanej wyjsciem z aplikacji.
+    for (auto it = pool.constBegin(); it != pool.constEnd(); ++it) {
+        if (!it.value()) continue;
+        if (GamePlugin *p = plugin((GameType)it.key(), nullptr)) p->suspendWindow(it.value());
+        delete it.value().data();
+    }
+    pool.clear();
+    qDeleteAll(loaders);
+}
+
+QString GameModules::directory()
+{
+    return QCoreApplication::applicationDirPath() + "/gry";
+}
+
+const QList<GameModules::Info> &GameModules::discover()
+{
+    StartupStage stage("GameModules::discover");
+    found.clear();
+
+    QDir dir(directory());
+    for (const QString &file : dir.entryList(QDir::Files)) {
+        const QString path = dir.absoluteFilePath(file);
+        if (!QLibrary::isLibrary(path)) continue;
+
+        // metaData() nie laduje biblioteki - czyta sekcje metadanych z pliku.
+        QPluginLoader probe(path);
+        const QJsonObject meta = probe.metaData();
+        if (meta.value("IID").toString() != GamePlugin_iid) continue;
+
+        const QJsonObject data = meta.value("MetaData").toObject();
+        Info info;
+        if (!parseGameType(data.value("gameType").toString(), info.type)) continue;
+        info.name = data.value("name").toString();
+        info.order = data.value("order").toInt(100);
+        info.path = path;
+        found.append(info);
+    }
+
+    std::sort(found.begin(), found.end(), [](const Info &a, const Info &b) { return a.order < b.order; });
+    return found;
+}
+
+const QList<GameModules::Info> &GameModules::modules() const
+{
+    return found;
+}
+
+GamePlugin *GameModules::plugin(GameType type, QString *error)
+{
+    QPluginLoader *loader = loaders.value((int)type);
+    if (!loader) {
+        auto it = std::find_if(found.begin(), found.end(), [&](const Info &i) { return i.type == type; });
+        if (it == found.end()) {
+            if (error) *error = "Brak modulu gry.";
+            return nullptr;
+        }
+        loader = new QPluginLoader(it->path);
+        loaders.insert((int)type, loader);
+    }
+
+    // Pierwsze instance() laduje biblioteke i rejestruje jej zasoby (gra_kosci: zasoby.qrc).
+    StartupStage stage(loader->isLoaded() ? "QPluginLoader::instance" : "QPluginLoader::instance (ladowanie)");
+    GamePlugin *p = qobject_cast<GamePlugin *>(loader->instance());
+    if (!p && error) *error = loader->errorString();
+    return p;
+}
+
+QMainWindow *GameModules::acquireWindow(const GameLaunchConfig &config, bool *created, QString *error)
+{
+    const qint64 start = GameTrace::now();
+    QMainWindow *window = pool.value((int)config.gameType);
+    const bool warm = window != nullptr;
+    StartupProfile::section(QString("gra %1 (%2 okno)").arg(gameLabel(config.gameType), warm ? "cieple" : "zimne"));
+
+    GamePlugin *p = plugin(config.gameType, error);
+    if (!p) return nullptr;
+
+    if (warm) {
+        StartupStage stage("GamePlugin::resetWindow");
+        p->resetWindow(window, config);
+    } else {
+        StartupStage stage("GamePlugin::createWindow");
+        window = p->createWindow(config);
+        if (!window) {
+            if (error) *error = "Modul nie utworzyl okna.";
+            return nullptr;
+        }
+        pool.insert((int)config.gameType, window);
+
+        // Wszystkie okna gier maja sygnal gameClosed() - laczymy po nazwie, bez naglowkow gier.
+        connect(window, SIGNAL(gameClosed()), this, SLOT(onGameClosed()), Qt::QueuedConnection);
+    }
+    if (created) *created = !warm;
+
+    // Czas do pierwszej klatki: histogram zawsze, rozbicie na etapy przy --profile-startup.
+    Histogram &launch = MetricsRegistry::instance().histogram("game_launch_seconds",
+        MetricsRegistry::labels({{"game", gameLabel(config.gameType)}, {"window", warm ? "warm" : "cold"}}),
+        "Czas od startu gry w launcherze do pierwszej klatki okna");
+    StartupProfile::onFirstFrame(window, [&launch, warm, start](qint64 frameNs) {
+        launch.observe((frameNs - start) / 1e9);
+        if (GameTrace::recording())
+            GameTrace::complete(warm ? "GameModules::launch(warm)" : "GameModules::launch(cold)", "ui", start, frameNs);
+        StartupProfile::finish(frameNs);
+    });
+    return window;
+}
+
+void GameModules::onGameClosed()
+{
+    if (QMainWindow *window = qobject_cast<QMainWindow *>(sender()))
+        emit gameClosed(window);
+}
+
+void GameModules::releaseWindow(QMainWindow *window)
+{
+    for (auto it = pool.constBegin(); it != pool.constEnd(); ++it) {
+        if (it.value() != window) continue;
+        if (GamePlugin *p = plugin((GameType)it.key(), nullptr)) p->suspendWindow(window);
+        break;
+    }
+    window->hide();
+}
@@ -0,0 +1,64 @@
+#ifndef GAME_MODULES_H
+#define GAME_MODULES_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QPointer>
+#include <QMainWindow>
+#include "game_config.h"
+
+class QPluginLoader;
+class GamePlugin;
+
+// Katalog wtyczek gier obok pliku wykonywalnego (podkatalog "gry").
+// discover() czyta tylko metadane; biblioteka jest ladowana przy pierwszym acquireWindow()
+// i zostaje zaladowana do konca. Okna gier sa w puli - jedno na gre, resetowane przy kolejnym starcie.
+class GameModules : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Info
+    {
+        GameType type;
+        QString name;
+        QString path;
+        int order;
+    };
+
+    explicit GameModules(QObject *parent = nullptr);
+    ~GameModules();
+
+    GameModules(const GameModules &) = delete;
+    GameModules &operator=(const GameModules &) = delete;
+
+    static QString directory();
+
+    const QList<Info> &discover();
+    const QList<Info> &modules() const;
+
+    // Cieple okno z puli (reset nowa konfiguracja) albo nowe z wtyczki. Czas do pierwszej
+    // klatki trafia do histogramu game_launch_seconds{game,window="cold"|"warm"}.
+    QMainWindow *acquireWindow(const GameLaunchConfig &config, bool *created = nullptr, QString *error = nullptr);
+    // Wstrzymuje gre (siec, timery) i chowa okno; zostaje w puli.
+    void releaseWindow(QMainWindow *window);
+
+signals:
+    // Okno gry emitowalo gameClosed(); dostarczane w kolejnej iteracji petli zdarzen,
+    // bo okno moze zglosic zamkniecie juz w trakcie resetu (np. zajety port hosta).
+    void gameClosed(QMainWindow *window);
+
+private slots:
+    void onGameClosed();
+
+private:
+    GamePlugin *plugin(GameType type, QString *error);
+
+    QList<Info> found;
+    QHash<int, QPluginLoader *> loaders;
+    QHash<int, QPointer<QMainWindow>> pool;
+};
+
+#endif
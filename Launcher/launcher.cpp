@@ -1,108 +1,181 @@
-#include "launcher.h"
-#include <QVBoxLayout>
-#include <QHBoxLayout>
-#include <QLabel>
-#include <QGroupBox>
-#include <QStandardItemModel>
-
-Launcher::Launcher(QWidget *parent) : QWidget(parent)
-{
-    setupUI();
-    setWindowTitle("Multi Game Launcher");
-    resize(400, 600);
-}
-
-void Launcher::setupUI()
-{
-    QVBoxLayout *mainLayout = new QVBoxLayout(this);
-    mainLayout->setSpacing(15);
-
-    QLabel *title = new QLabel("CENTRUM GIER", this);
-    title->setAlignment(Qt::AlignCenter);
-    title->setStyleSheet("font-size: 24px; font-weight: bold; color: #333;");
-    mainLayout->addWidget(title);
-
-    QGroupBox *nickGroup = new QGroupBox("Twój Nick", this);
-    QVBoxLayout *nickLay = new QVBoxLayout(nickGroup);
-    QLineEdit *nickInput = new QLineEdit(this);
-    nickInput->setPlaceholderText("Wpisz swoją ksywę...");
-    nickInput->setText("Gracz");
-    this->nameInput = nickInput;
-    nickLay->addWidget(nickInput);
-    mainLayout->addWidget(nickGroup);
-
-    QGroupBox *gameGroup = new QGroupBox("Wybierz Grę", this);
-    QVBoxLayout *gameLay = new QVBoxLayout(gameGroup);
-    gameSelector = new QComboBox(this);
-    gameSelector->addItem("Wisielec", (int)GameType::Wisielec);
-    gameSelector->addItem("Kości (Yahtzee)", (int)GameType::Kosci);
-    gameSelector->addItem("Chinczyk (Ludo)", (int)GameType::Chinczyk);
-    gameSelector->setStyleSheet("padding: 5px; font-size: 14px;");
-    gameLay->addWidget(gameSelector);
-    mainLayout->addWidget(gameGroup);
-
-    QGroupBox *modeGroup = new QGroupBox("Tryb Gry", this);
-    QVBoxLayout *modeLayout = new QVBoxLayout(modeGroup);
-    modeSolo = new QRadioButton("Solo / Z Botem", this);
-    modeLocal = new QRadioButton("Lokalnie (2 Graczy)", this);
-    modeHost = new QRadioButton("Sieć: Hostuj", this);
-    modeClient = new QRadioButton("Sieć: Dołącz", this);
-
-    modeSolo->setChecked(true);
-    modeLayout->addWidget(modeSolo);
-    modeLayout->addWidget(modeLocal);
-    modeLayout->addWidget(modeHost);
-    modeLayout->addWidget(modeClient);
-    mainLayout->addWidget(modeGroup);
-
-    QGroupBox *netGroup = new QGroupBox("Ustawienia Sieciowe", this);
-    QVBoxLayout *netLayout = new QVBoxLayout(netGroup);
-
-    netLayout->addWidget(new QLabel("Adres IP:"));
-    ipInput = new QLineEdit("127.0.0.1", this);
-    netLayout->addWidget(ipInput);
-
-    netLayout->addWidget(new QLabel("Port:"));
-    portInput = new QLineEdit("5000", this);
-    netLayout->addWidget(portInput);
-
-    mainLayout->addWidget(netGroup);
-
-    startBtn = new QPushButton("GRAJ", this);
-    startBtn->setMinimumHeight(50);
-    startBtn->setStyleSheet("background-color: #2196F3; color: white; font-weight: bold; font-size: 16px; border-radius: 5px;");
-    mainLayout->addWidget(startBtn);
-
-    connect(startBtn, &QPushButton::clicked, this, &Launcher::onStartClicked);
-    connect(modeSolo, &QRadioButton::toggled, this, &Launcher::updateUIState);
-    connect(modeLocal, &QRadioButton::toggled, this, &Launcher::updateUIState);
-    connect(modeHost, &QRadioButton::toggled, this, &Launcher::updateUIState);
-    connect(modeClient, &QRadioButton::toggled, this, &Launcher::updateUIState);
-
-    updateUIState();
-}
-
-void Launcher::updateUIState()
-{
-    bool isNet = modeClient->isChecked() || modeHost->isChecked();
-    bool isClient = modeClient->isChecked();
-
-    ipInput->setEnabled(isClient);
-    portInput->setEnabled(isNet);
-}
-
-void Launcher::onStartClicked()
-{
-    GameLaunchConfig config;
-    config.gameType = (GameType)gameSelector->currentData().toInt();
-    config.hostIp = ipInput->text();
-    config.port = portInput->text().toInt();
-    config.playerName = nameInput->text().isEmpty() ? "Gracz" : nameInput->text();
-
-    if (modeSolo->isChecked()) config.mode = GameMode::Solo;
-    else if (modeLocal->isChecked()) config.mode = GameMode::LocalDuo;
-    else if (modeHost->isChecked()) config.mode = GameMode::NetHost;
-    else if (modeClient->isChecked()) config.mode = GameMode::NetClient;
-
-    emit launchGame(config);
-}
+#include "launcher.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QGroupBox>
+#include <QStandardItemModel>
+#include <QCloseEvent>
+#include "startup_profile.h"
+#include "game_stats.h"
+
+Launcher::Launcher(const QList<GameModules::Info> &games, QWidget *parent) : QWidget(parent)
+{
+    {
+        StartupStage stage("Launcher::setupUI");
+        setupUI(games);
+    }
+    setWindowTitle("Multi Game Launcher");
+    resize(400, 600);
+}
+
+void Launcher::setupUI(const QList<GameModules::Info> &games)
+{
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setSpacing(15);
+
+    QLabel *title = new QLabel("CENTRUM GIER", this);
+    title->setAlignment(Qt::AlignCenter);
+    title->setStyleSheet("font-size: 24px; font-weight: bold; color: #333;");
+    mainLayout->addWidget(title);
+
+    QGroupBox *nickGroup = new QGroupBox("Twój Nick", this);
+    QVBoxLayout *nickLay = new QVBoxLayout(nickGroup);
+    QLineEdit *nickInput = new QLineEdit(this);
+    nickInput->setPlaceholderText("Wpisz swoją ksywę...");
+    nickInput->setText("Gracz");
+    this->nameInput = nickInput;
+    nickLay->addWidget(nickInput);
+    mainLayout->addWidget(nickGroup);
+
+    QGroupBox *gameGroup = new QGroupBox("Wybierz Grę", this);
+    QVBoxLayout *gameLay = new QVBoxLayout(gameGroup);
+    gameSelector = new QComboBox(this);
+    // Lista z metadanych wtyczek - zadna gra nie jest ladowana, dopoki nie klikniemy "GRAJ".
+    for (const GameModules::Info &g : games)
+        gameSelector->addItem(g.name, (int)g.type);
+    if (games.isEmpty())
+        gameSelector->addItem("Brak modułów gier w " + GameModules::directory());
+    gameSelector->setStyleSheet("padding: 5px; font-size: 14px;");
+    gameLay->addWidget(gameSelector);
+    mainLayout->addWidget(gameGroup);
+
+    QGroupBox *modeGroup = new QGroupBox("Tryb Gry", this);
+    QVBoxLayout *modeLayout = new QVBoxLayout(modeGroup);
+    modeSolo = new QRadioButton("Solo / Z Botem", this);
+    modeLocal = new QRadioButton("Lokalnie (2 Graczy)", this);
+    modeHost = new QRadioButton("Sieć: Hostuj", this);
+    modeClient = new QRadioButton("Sieć: Dołącz", this);
+
+    modeSolo->setChecked(true);
+    modeLayout->addWidget(modeSolo);
+    modeLayout->addWidget(modeLocal);
+    modeLayout->addWidget(modeHost);
+    modeLayout->addWidget(modeClient);
+    mainLayout->addWidget(modeGroup);
+
+    QGroupBox *netGroup = new QGroupBox("Ustawienia Sieciowe", this);
+    QVBoxLayout *netLayout = new QVBoxLayout(netGroup);
+
+    netLayout->addWidget(new QLabel("Adres IP:"));
+    ipInput = new QLineEdit("127.0.0.1", this);
+    netLayout->addWidget(ipInput);
+
+    netLayout->addWidget(new QLabel("Port:"));
+    portInput = new QLineEdit("5000", this);
+    netLayout->addWidget(portInput);
+
+    mainLayout->addWidget(netGroup);
+
+    QGroupBox *statsGroup = new QGroupBox("Statystyki", this);
+    QVBoxLayout *statsLayout = new QVBoxLayout(statsGroup);
+    statsLabel = new QLabel(this);
+    statsLabel->setWordWrap(true);
+    statsLayout->addWidget(statsLabel);
+    mainLayout->addWidget(statsGroup);
+
+    startBtn = new QPushButton("GRAJ", this);
+    startBtn->setMinimumHeight(50);
+    startBtn->setStyleSheet("background-color: #2196F3; color: white; font-weight: bold; font-size: 16px; border-radius: 5px;");
+    mainLayout->addWidget(startBtn);
+
+    startBtn->setEnabled(!games.isEmpty());
+    connect(startBtn, &QPushButton::clicked, this, &Launcher::onStartClicked);
+    connect(modeSolo, &QRadioButton::toggled, this, &Launcher::updateUIState);
+    connect(modeLocal, &QRadioButton::toggled, this, &Launcher::updateUIState);
+    connect(modeHost, &QRadioButton::toggled, this, &Launcher::updateUIState);
+    connect(modeClient, &QRadioButton::toggled, this, &Launcher::updateUIState);
+    connect(gameSelector, &QComboBox::currentIndexChanged, this, &Launcher::updateStats);
+    connect(nameInput, &QLineEdit::textChanged, this, &Launcher::updateStats);
+
+    updateUIState();
+}
+
+void Launcher::updateUIState()
+{
+    bool isNet = modeClient->isChecked() || modeHost->isChecked();
+    bool isClient = modeClient->isChecked();
+
+    ipInput->setEnabled(isClient);
+    portInput->setEnabled(isNet);
+}
+
+// Po powrocie z gry ranking ma juz jej wynik.
+void Launcher::showEvent(QShowEvent *event)
+{
+    updateStats();
+    QWidget::showEvent(event);
+}
+
+void Launcher::closeEvent(QCloseEvent *event)
+{
+    emit closed();
+    QWidget::closeEvent(event);
+}
+
+// Liczniki sa zagregowane w indeksie statystyk, wiec odswiezenie nie zalezy od liczby rozegranych gier.
+void Launcher::updateStats()
+{
+    GameStats *stats = GameStats::instance();
+    if (!stats || !stats->isOpen() || gameSelector->currentData().isNull()) {
+        statsLabel->setText("Brak statystyk.");
+        return;
+    }
+
+    const GameType type = (GameType)gameSelector->currentData().toInt();
+    const int t = (int)type;
+    QString text;
+
+    const int me = stats->findPlayer(nameInput->text().isEmpty() ? "Gracz" : nameInput->text());
+    if (me >= 0 && stats->player(me).games[t] > 0) {
+        const GameStats::PlayerStats &p = stats->player(me);
+        text += QString("Ty: %1 gier, %2 wygranych").arg(p.games[t]).arg(p.wins[t]);
+
+        if (type == GameType::Kosci) {
+            int common = 0;
+            for (int b = 1; b < GameStats::ScoreBuckets; ++b)
+                if (p.scoreBuckets[b] > p.scoreBuckets[common]) common = b;
+            text += QString(", rekord %1 pkt, średnio %2 pkt, najczęściej %3+ pkt")
+                        .arg(p.bestScore)
+                        .arg(p.scoreSum / p.games[t])
+                        .arg(common * GameStats::ScoreBucketWidth);
+        } else if (type == GameType::Chinczyk) {
+            text += QString(", miejsca 1-4: %1 / %2 / %3 / %4")
+                        .arg(p.places[0]).arg(p.places[1]).arg(p.places[2]).arg(p.places[3]);
+        } else {
+            text += QString(", odgadnięte %1%").arg(100 * p.wins[t] / p.games[t]);
+        }
+        text += "\n";
+    }
+
+    const QVector<const GameStats::PlayerStats *> top = stats->leaderboard(type, 5);
+    for (int i = 0; i < top.size(); ++i)
+        text += QString("\n%1. %2 - %3 wygr. / %4 gier").arg(i + 1).arg(top[i]->name).arg(top[i]->wins[t]).arg(top[i]->games[t]);
+
+    statsLabel->setText(text.isEmpty() ? "Brak rozegranych gier." : text);
+}
+
+void Launcher::onStartClicked()
+{
+    GameLaunchConfig config;
+    config.gameType = (GameType)gameSelector->currentData().toInt();
+    config.hostIp = ipInput->text();
+    config.port = portInput->text().toInt();
+    config.playerName = nameInput->text().isEmpty() ? "Gracz" : nameInput->text();
+
+    if (modeSolo->isChecked()) config.mode = GameMode::Solo;
+    else if (modeLocal->isChecked()) config.mode = GameMode::LocalDuo;
+    else if (modeHost->isChecked()) config.mode = GameMode::NetHost;
+    else if (modeClient->isChecked()) config.mode = GameMode::NetClient;
+
+    emit launchGame(config);
+}
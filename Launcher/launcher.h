@@ -1,39 +1,49 @@
-#ifndef LAUNCHER_H
-#define LAUNCHER_H
-
-#include <QWidget>
-#include <QComboBox>
-#include <QRadioButton>
-#include <QLineEdit>
-#include <QPushButton>
-#include "game_config.h"
-
-class Launcher : public QWidget
-{
-    Q_OBJECT
-
-public:
-    explicit Launcher(QWidget *parent = nullptr);
-
-signals:
-    void launchGame(const GameLaunchConfig &config);
-
-private slots:
-    void onStartClicked();
-    void updateUIState();
-
-private:
-    void setupUI();
-
-    QComboBox *gameSelector;
-    QRadioButton *modeSolo;
-    QRadioButton *modeLocal;
-    QRadioButton *modeHost;
-    QRadioButton *modeClient;
-    QLineEdit *ipInput;
-    QLineEdit *nameInput;
-    QLineEdit *portInput;
-    QPushButton *startBtn;
-};
-
-#endif
+#ifndef LAUNCHER_H
+#define LAUNCHER_H
+
+#include <QWidget>
+#include <QComboBox>
+#include <QRadioButton>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QLabel>
+#include "game_config.h"
+#include "game_modules.h"
+
+class Launcher : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit Launcher(const QList<GameModules::Info> &games, QWidget *parent = nullptr);
+
+signals:
+    void launchGame(const GameLaunchConfig &config);
+    // Zamkniecie launchera konczy aplikacje (zamkniecie okna gry wraca do menu).
+    void closed();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void closeEvent(QCloseEvent *event) override;
+
+private slots:
+    void onStartClicked();
+    void updateUIState();
+    void updateStats();
+
+private:
+    void setupUI(const QList<GameModules::Info> &games);
+
+    QComboBox *gameSelector;
+    QRadioButton *modeSolo;
+    QRadioButton *modeLocal;
+    QRadioButton *modeHost;
+    QRadioButton *modeClient;
+    QLineEdit *ipInput;
+    QLineEdit *nameInput;
+    QLineEdit *portInput;
+    QPushButton *startBtn;
+    QLabel *statsLabel;
+};
+
+#endif
@@ -0,0 +1,183 @@
+#include "event_loop_watchdog.h"
+#include "game_trace.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QStandardPaths>
+#include <algorithm>
+
+static const qint64 MaxLogBytes = 1024 * 1024;
+static const int KeptLogs = 3;
+
+static EventLoopWatchdog *currentWatchdog = nullptr;
+
+// Watek monitora: wykrywa zablokowana petle i jako jedyny pisze do pliku logu.
+class WatchdogMonitor : public QThread
+{
+public:
+    explicit WatchdogMonitor(EventLoopWatchdog *owner) : owner(owner) {}
+
+protected:
+    void run() override
+    {
+        bool stalled = false;
+        qint64 stallStart = 0;
+        QByteArray span;
+
+        while (!isInterruptionRequested()) {
+            msleep(EventLoopWatchdog::TickMs);
+
+            const qint64 now = GameTrace::now();
+            const qint64 beat = owner->lastBeatNs.load(std::memory_order_relaxed);
+            const qint64 silentMs = (now - beat) / 1000000;
+
+            if (!stalled && silentMs >= EventLoopWatchdog::StallMs) {
+                stalled = true;
+                stallStart = beat;
+                const char *active = GameTrace::activeSpan(owner->guiThread);
+                span = active ? QByteArray(active) : QByteArray("(brak spanu)");
+            } else if (stalled && silentMs < EventLoopWatchdog::StallMs) {
+                stalled = false;
+                const qint64 stallMs = (beat - stallStart) / 1000000;
+                owner->alert(QString("STALL %1 ms, aktywny span: %2").arg(stallMs).arg(QString::fromLatin1(span)));
+            }
+
+            flush();
+        }
+        flush();
+    }
+
+private:
+    void flush()
+    {
+        QStringList lines;
+        {
+            QMutexLocker lock(&owner->pendingMutex);
+            lines.swap(owner->pending);
+        }
+        if (lines.isEmpty() || owner->logFile.isEmpty()) return;
+
+        rotate();
+        QFile f(owner->logFile);
+        if (!f.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) return;
+        for (const QString &line : std::as_const(lines)) f.write(line.toUtf8() + '\n');
+    }
+
+    void rotate()
+    {
+        QFileInfo info(owner->logFile);
+        if (!info.exists() || info.size() < MaxLogBytes) return;
+
+        QFile::remove(owner->logFile + "." + QString::number(KeptLogs));
+        for (int i = KeptLogs - 1; i >= 1; --i)
+            QFile::rename(owner->logFile + "." + QString::number(i), owner->logFile + "." + QString::number(i + 1));
+        QFile::rename(owner->logFile, owner->logFile + ".1");
+    }
+
+    EventLoopWatchdog *owner;
+};
+
+EventLoopWatchdog::EventLoopWatchdog(QObject *parent)
+    : QObject(parent),
+    samples(SampleCount, 0.0f),
+    nextSample(0),
+    sampleTotal(0),
+    lastBeatNs(0),
+    guiThread(nullptr),
+    monitor(nullptr)
+{
+    tick.setInterval(TickMs);
+    tick.setTimerType(Qt::PreciseTimer);
+    connect(&tick, &QTimer::timeout, this, &EventLoopWatchdog::onTick);
+    if (!currentWatchdog) currentWatchdog = this;
+}
+
+EventLoopWatchdog::~EventLoopWatchdog()
+{
+    stop();
+    if (currentWatchdog == this) currentWatchdog = nullptr;
+}
+
+EventLoopWatchdog *EventLoopWatchdog::instance()
+{
+    return currentWatchdog;
+}
+
+void EventLoopWatchdog::start(const QString &logDirectory)
+{
+    if (monitor) return;
+
+    QString dir = logDirectory.isEmpty() ? QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) : logDirectory;
+    QDir().mkpath(dir);
+    logFile = dir + "/watchdog.log";
+
+    // Spany zapisuja nazwe otwartego bloku, nawet gdy nagrywanie przebiegu jest wylaczone.
+    GameTrace::setAttribution(true);
+    guiThread = GameTrace::currentThread();
+    lastBeatNs.store(GameTrace::now(), std::memory_order_relaxed);
+
+    sinceTick.start();
+    tick.start();
+
+    monitor = new WatchdogMonitor(this);
+    monitor->start(QThread::LowPriority);
+}
+
+void EventLoopWatchdog::stop()
+{
+    if (!monitor) return;
+
+    tick.stop();
+    monitor->requestInterruption();
+    monitor->wait();
+    delete monitor;
+    monitor = nullptr;
+    GameTrace::setAttribution(false);
+}
+
+bool EventLoopWatchdog::isRunning() const
+{
+    return monitor != nullptr;
+}
+
+QString EventLoopWatchdog::logPath() const
+{
+    return logFile;
+}
+
+void EventLoopWatchdog::onTick()
+{
+    const qint64 elapsed = sinceTick.restart();
+    const qint64 lag = std::max<qint64>(0, elapsed - TickMs);
+
+    lastBeatNs.store(GameTrace::now(), std::memory_order_relaxed);
+    samples[nextSample] = (float)lag;
+    nextSample = (nextSample + 1) % SampleCount;
+    if (sampleTotal < SampleCount) sampleTotal++;
+
+    if (lag >= LagAlertMs && lag < StallMs) alert(QString("LAG %1 ms").arg(lag));
+}
+
+void EventLoopWatchdog::alert(const QString &line)
+{
+    const QString stamped = QDateTime::currentDateTime().toString(Qt::ISODateWithMs) + ' ' + line;
+    QMutexLocker lock(&pendingMutex);
+    if (pending.size() < 1000) pending.append(stamped);
+}
+
+EventLoopWatchdog::Percentiles EventLoopWatchdog::lagPercentiles() const
+{
+    Percentiles p;
+    if (sampleTotal == 0) return p;
+
+    std::vector<float> sorted(samples.begin(), samples.begin() + sampleTotal);
+    std::sort(sorted.begin(), sorted.end());
+    auto at = [&](double q) { return (double)sorted[std::min<size_t>(sorted.size() - 1, (size_t)(q * sorted.size()))]; };
+    p.p50 = at(0.50);
+    p.p95 = at(0.95);
+    p.p99 = at(0.99);
+    p.max = sorted.back();
+    return p;
+}
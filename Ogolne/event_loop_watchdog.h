@@ -0,0 +1,74 @@
+#ifndef EVENT_LOOP_WATCHDOG_H
+#define EVENT_LOOP_WATCHDOG_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QStringList>
+#include <QThread>
+#include <QTimer>
+#include <atomic>
+#include <vector>
+#include "gry_export.h"
+
+class WatchdogMonitor;
+
+// Watchdog petli zdarzen watku GUI (tego samego, ktory obsluguje gniazda).
+// - opoznienie obslugi: spoznienie timera co TickMs, ostatnie probki do percentyli,
+// - zablokowana petla: osobny watek widzi brak taktu dluzej niz StallMs i zapamietuje
+//   otwarty span GameTrace watku GUI (atrybucja bez stosu),
+// - alerty trafiaja do rotowanego logu watchdog.log w katalogu danych aplikacji.
+class GRY_WSPOLNE_EXPORT EventLoopWatchdog : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int TickMs = 50;
+    static constexpr int LagAlertMs = 100;
+    static constexpr int StallMs = 250;
+    static constexpr int SampleCount = 512;
+
+    explicit EventLoopWatchdog(QObject *parent = nullptr);
+    ~EventLoopWatchdog();
+
+    static EventLoopWatchdog *instance();
+
+    void start(const QString &logDirectory = QString());
+    void stop();
+    bool isRunning() const;
+
+    struct Percentiles
+    {
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+    Percentiles lagPercentiles() const;       // ms, z ostatnich SampleCount probek
+    QString logPath() const;
+
+private slots:
+    void onTick();
+
+private:
+    friend class WatchdogMonitor;
+
+    void alert(const QString &line);
+
+    QTimer tick;
+    QElapsedTimer sinceTick;
+    std::vector<float> samples;
+    int nextSample;
+    int sampleTotal;
+
+    // Czytane przez watek monitora.
+    std::atomic<qint64> lastBeatNs;
+    const void *guiThread;
+
+    WatchdogMonitor *monitor;
+    QString logFile;
+    QMutex pendingMutex;
+    QStringList pending;
+};
+
+#endif
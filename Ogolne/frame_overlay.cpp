@@ -0,0 +1,100 @@
+#include "frame_overlay.h"
+#include "event_loop_watchdog.h"
+#include <QEvent>
+#include <QPainter>
+#include <QShortcut>
+#include <algorithm>
+
+FrameOverlay *FrameOverlay::attach(QWidget *window, bool visible)
+{
+    FrameOverlay *overlay = new FrameOverlay(window);
+    overlay->setVisible(visible);
+
+    QShortcut *toggle = new QShortcut(QKeySequence(Qt::Key_F12), window);
+    connect(toggle, &QShortcut::activated, overlay, [overlay]() {
+        overlay->setVisible(!overlay->isVisible());
+        overlay->raise();
+    });
+    return overlay;
+}
+
+FrameOverlay::FrameOverlay(QWidget *window)
+    : QWidget(window),
+    window(window),
+    frames(FrameSamples, 0.0f),
+    nextFrame(0),
+    frameTotal(0)
+{
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setFocusPolicy(Qt::NoFocus);
+    resize(330, 44);
+
+    window->installEventFilter(this);
+    sinceFrame.start();
+
+    refresh.setInterval(500);
+    connect(&refresh, &QTimer::timeout, this, &FrameOverlay::refreshText);
+    refresh.start();
+
+    place();
+    raise();
+}
+
+void FrameOverlay::place()
+{
+    move(window->width() - width() - 8, 8);
+}
+
+bool FrameOverlay::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == window) {
+        if (event->type() == QEvent::UpdateRequest) {
+            const qint64 ms = sinceFrame.restart();
+            if (ms <= MaxFrameMs) {
+                frames[nextFrame] = (float)ms;
+                nextFrame = (nextFrame + 1) % FrameSamples;
+                if (frameTotal < FrameSamples) frameTotal++;
+            }
+        } else if (event->type() == QEvent::Resize) {
+            place();
+        }
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+void FrameOverlay::refreshText()
+{
+    if (!isVisible()) return;
+
+    QString frameText = "klatka: -";
+    if (frameTotal > 0) {
+        std::vector<float> sorted(frames.begin(), frames.begin() + frameTotal);
+        std::sort(sorted.begin(), sorted.end());
+        double p50 = sorted[sorted.size() / 2];
+        double p95 = sorted[std::min<size_t>(sorted.size() - 1, sorted.size() * 95 / 100)];
+        frameText = QString("klatka p50/p95: %1 / %2 ms").arg(p50, 0, 'f', 1).arg(p95, 0, 'f', 1);
+    }
+
+    QString lagText = "lag: watchdog wylaczony";
+    EventLoopWatchdog *w = EventLoopWatchdog::instance();
+    if (w && w->isRunning()) {
+        EventLoopWatchdog::Percentiles p = w->lagPercentiles();
+        lagText = QString("lag p50/p95/p99: %1 / %2 / %3 ms (max %4)")
+                      .arg(p.p50, 0, 'f', 0).arg(p.p95, 0, 'f', 0).arg(p.p99, 0, 'f', 0).arg(p.max, 0, 'f', 0);
+    }
+
+    text = frameText + '\n' + lagText;
+    update();
+}
+
+void FrameOverlay::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(0, 0, 0, 170));
+    painter.setPen(QColor("#7CFC00"));
+    QFont f = painter.font();
+    f.setFamily("monospace");
+    f.setPointSize(9);
+    painter.setFont(f);
+    painter.drawText(rect().adjusted(6, 4, -6, -4), Qt::AlignLeft | Qt::AlignVCenter, text);
+}
@@ -0,0 +1,41 @@
+#ifndef FRAME_OVERLAY_H
+#define FRAME_OVERLAY_H
+
+#include <QWidget>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <vector>
+
+// Nakladka w rogu okna gry: czas klatki (odstep miedzy kolejnymi UpdateRequest okna)
+// i percentyle opoznienia petli zdarzen z EventLoopWatchdog. F12 pokazuje/ukrywa.
+class FrameOverlay : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static FrameOverlay *attach(QWidget *window, bool visible);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+
+private slots:
+    void refreshText();
+
+private:
+    explicit FrameOverlay(QWidget *window);
+    void place();
+
+    static constexpr int FrameSamples = 120;
+    static constexpr int MaxFrameMs = 250;      // dluzsze przerwy to bezczynnosc, nie klatka
+
+    QWidget *window;
+    QElapsedTimer sinceFrame;
+    std::vector<float> frames;
+    int nextFrame;
+    int frameTotal;
+    QTimer refresh;
+    QString text;
+};
+
+#endif
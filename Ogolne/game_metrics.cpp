@@ -0,0 +1,209 @@
+#include "game_metrics.h"
+#include <QTcpSocket>
+#include <QMutexLocker>
+#include <algorithm>
+
+Histogram::Histogram(const std::vector<double> &bounds)
+    : m_bounds(bounds),
+    m_buckets(new std::atomic<quint64>[bounds.size() + 1])
+{
+    for (size_t i = 0; i <= m_bounds.size(); ++i) m_buckets[i].store(0, std::memory_order_relaxed);
+}
+
+void Histogram::observe(double seconds)
+{
+    size_t i = std::lower_bound(m_bounds.begin(), m_bounds.end(), seconds) - m_bounds.begin();
+    m_buckets[i].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sumNanos.fetch_add((quint64)std::max(0.0, seconds * 1e9), std::memory_order_relaxed);
+}
+
+MetricsRegistry &MetricsRegistry::instance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+const std::vector<double> &MetricsRegistry::latencyBuckets()
+{
+    static const std::vector<double> bounds = {
+        0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0
+    };
+    return bounds;
+}
+
+QString MetricsRegistry::labels(std::initializer_list<std::pair<const char *, QString>> pairs)
+{
+    QString out;
+    for (const auto &p : pairs) {
+        QString v = p.second;
+        v.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n");
+        if (!out.isEmpty()) out += ',';
+        out += QLatin1String(p.first) + "=\"" + v + '"';
+    }
+    return out;
+}
+
+Counter &MetricsRegistry::counter(const QString &name, const QString &labels, const QString &help)
+{
+    QMutexLocker lock(&m_mutex);
+    if (!help.isEmpty()) m_help.insert(name, help);
+    std::unique_ptr<Counter> &c = m_counters[name][labels];
+    if (!c) c.reset(new Counter);
+    return *c;
+}
+
+Histogram &MetricsRegistry::histogram(const QString &name, const QString &labels, const QString &help)
+{
+    QMutexLocker lock(&m_mutex);
+    if (!help.isEmpty()) m_help.insert(name, help);
+    std::unique_ptr<Histogram> &h = m_histograms[name][labels];
+    if (!h) h.reset(new Histogram(latencyBuckets()));
+    return *h;
+}
+
+int MetricsRegistry::addGauge(const QString &name, const QString &labels, std::function<double()> read, const QString &help)
+{
+    QMutexLocker lock(&m_mutex);
+    if (!help.isEmpty()) m_help.insert(name, help);
+    int id = m_nextGauge++;
+    m_gauges[id] = Gauge{ name, labels, std::move(read) };
+    return id;
+}
+
+void MetricsRegistry::removeGauge(int id)
+{
+    QMutexLocker lock(&m_mutex);
+    m_gauges.erase(id);
+}
+
+static QString series(const QString &name, const QString &labels)
+{
+    return labels.isEmpty() ? name : name + '{' + labels + '}';
+}
+
+QByteArray MetricsRegistry::exposition() const
+{
+    QMutexLocker lock(&m_mutex);
+    QString out;
+
+    auto header = [&](const QString &name, const char *type) {
+        const QString help = m_help.value(name);
+        if (!help.isEmpty()) out += "# HELP " + name + ' ' + help + '\n';
+        out += "# TYPE " + name + ' ' + QLatin1String(type) + '\n';
+    };
+
+    for (const auto &byName : m_counters) {
+        header(byName.first, "counter");
+        for (const auto &c : byName.second)
+            out += series(byName.first, c.first) + ' ' + QString::number(c.second->value()) + '\n';
+    }
+
+    std::map<QString, std::map<QString, double>> gauges;
+    for (const auto &g : m_gauges) gauges[g.second.name][g.second.labels] += g.second.read();
+    for (const auto &byName : gauges) {
+        header(byName.first, "gauge");
+        for (const auto &g : byName.second)
+            out += series(byName.first, g.first) + ' ' + QString::number(g.second) + '\n';
+    }
+
+    for (const auto &byName : m_histograms) {
+        header(byName.first, "histogram");
+        for (const auto &h : byName.second) {
+            const Histogram &hist = *h.second;
+            const QString sep = h.first.isEmpty() ? QString() : QString(',');
+            quint64 cumulative = 0;
+            for (size_t i = 0; i <= hist.bounds().size(); ++i) {
+                cumulative += hist.bucketCount((int)i);
+                const QString le = i < hist.bounds().size() ? QString::number(hist.bounds()[i]) : QString("+Inf");
+                out += byName.first + "_bucket{" + h.first + sep + "le=\"" + le + "\"} " + QString::number(cumulative) + '\n';
+            }
+            out += series(byName.first + "_sum", h.first) + ' ' + QString::number(hist.sum(), 'g', 9) + '\n';
+            out += series(byName.first + "_count", h.first) + ' ' + QString::number(hist.count()) + '\n';
+        }
+    }
+
+    return out.toUtf8();
+}
+
+MessageCounters::MessageCounters(const QString &game, const QString &direction, const QStringList &types)
+    : m_messages("game_messages_" + direction + "_total"),
+    m_bytes("game_bytes_" + direction + "_total")
+{
+    for (const QString &type : types)
+        m_byType.insert(type, pair(game, type));
+    m_other = pair(game, "other");
+}
+
+MessageCounters::Pair MessageCounters::pair(const QString &game, const QString &type) const
+{
+    MetricsRegistry &r = MetricsRegistry::instance();
+    const QString l = MetricsRegistry::labels({ { "game", game }, { "type", type } });
+    return { &r.counter(m_messages, l, "Wiadomosci wedlug typu."),
+             &r.counter(m_bytes, l, "Bajty wiadomosci wedlug typu.") };
+}
+
+void MessageCounters::count(const QString &type, qint64 bytes, int copies)
+{
+    const Pair counters = m_byType.value(type, m_other);
+    counters.first->add((quint64)copies);
+    counters.second->add((quint64)(bytes * copies));
+}
+
+MetricsServer::MetricsServer(QObject *parent)
+    : QObject(parent),
+    m_lag(MetricsRegistry::instance().histogram("game_event_loop_lag_seconds", QString(),
+                                                "Spoznienie timera 100 ms w petli zdarzen."))
+{
+    connect(&m_server, &QTcpServer::newConnection, this, &MetricsServer::onNewConnection);
+
+    m_lagTimer.setInterval(LagTickMs);
+    m_lagTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_lagTimer, &QTimer::timeout, this, &MetricsServer::onLagTick);
+}
+
+bool MetricsServer::start(quint16 port)
+{
+    if (!m_server.listen(QHostAddress::LocalHost, port)) return false;
+    m_sinceTick.start();
+    m_lagTimer.start();
+    return true;
+}
+
+void MetricsServer::onLagTick()
+{
+    qint64 elapsed = m_sinceTick.restart();
+    m_lag.observe(std::max<qint64>(0, elapsed - LagTickMs) / 1000.0);
+}
+
+void MetricsServer::onNewConnection()
+{
+    while (m_server.hasPendingConnections()) {
+        QTcpSocket *s = m_server.nextPendingConnection();
+        connect(s, &QTcpSocket::disconnected, s, &QObject::deleteLater);
+        connect(s, &QTcpSocket::readyRead, s, [s]() {
+            // Wystarczy linia zadania; reszta naglowkow nie jest potrzebna.
+            if (!s->canReadLine()) {
+                if (s->bytesAvailable() > 4096) s->abort();
+                return;
+            }
+            const QByteArray line = s->readLine();
+            QByteArray body;
+            QByteArray status;
+            if (line.startsWith("GET /metrics ") || line.startsWith("GET / ")) {
+                status = "200 OK";
+                body = MetricsRegistry::instance().exposition();
+            } else {
+                status = "404 Not Found";
+                body = "not found\n";
+            }
+
+            s->write("HTTP/1.1 " + status + "\r\n"
+                     "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                     "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                     "Connection: close\r\n\r\n" + body);
+            QObject::disconnect(s, &QTcpSocket::readyRead, nullptr, nullptr);
+            s->disconnectFromHost();
+        });
+    }
+}
@@ -0,0 +1,146 @@
+#ifndef GAME_METRICS_H
+#define GAME_METRICS_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QTcpServer>
+#include <QTimer>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+#include "gry_export.h"
+
+// Liczniki hosta w formacie tekstowym Prometheusa.
+// Gorace sciezki trzymaja referencje do Counter/Histogram i tylko inkrementuja atomiki (relaxed);
+// mutex rejestru jest brany przy pierwszym pobraniu metryki i przy eksporcie.
+class Counter
+{
+public:
+    void add(quint64 n = 1) { m_value.fetch_add(n, std::memory_order_relaxed); }
+    quint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<quint64> m_value{ 0 };
+};
+
+class GRY_METRYKI_EXPORT Histogram
+{
+public:
+    explicit Histogram(const std::vector<double> &bounds);
+
+    void observe(double seconds);
+
+    const std::vector<double> &bounds() const { return m_bounds; }
+    quint64 bucketCount(int i) const { return m_buckets[i].load(std::memory_order_relaxed); }
+    quint64 count() const { return m_count.load(std::memory_order_relaxed); }
+    double sum() const { return m_sumNanos.load(std::memory_order_relaxed) / 1e9; }
+
+private:
+    std::vector<double> m_bounds;
+    std::unique_ptr<std::atomic<quint64>[]> m_buckets;   // bounds.size() + 1 (ostatni = +Inf), bez kumulacji
+    std::atomic<quint64> m_count{ 0 };
+    std::atomic<quint64> m_sumNanos{ 0 };
+};
+
+class GRY_METRYKI_EXPORT MetricsRegistry
+{
+public:
+    static MetricsRegistry &instance();
+
+    // Etykiety w postaci gotowej do eksportu: game="ludo",type="CH_MOVE" (zob. labels()).
+    Counter &counter(const QString &name, const QString &labels = QString(), const QString &help = QString());
+    Histogram &histogram(const QString &name, const QString &labels = QString(), const QString &help = QString());
+
+    // Wartosc liczona w chwili eksportu, w watku serwera metryk. Mierniki o tej samej nazwie
+    // i etykietach sa sumowane (np. kilka hostow tej samej gry w jednym procesie).
+    int addGauge(const QString &name, const QString &labels, std::function<double()> read, const QString &help = QString());
+    void removeGauge(int id);
+
+    QByteArray exposition() const;
+
+    static QString labels(std::initializer_list<std::pair<const char *, QString>> pairs);
+    static const std::vector<double> &latencyBuckets();
+
+private:
+    MetricsRegistry() = default;
+
+    struct Gauge
+    {
+        QString name;
+        QString labels;
+        std::function<double()> read;
+    };
+
+    mutable QMutex m_mutex;
+    std::map<QString, std::map<QString, std::unique_ptr<Counter>>> m_counters;
+    std::map<QString, std::map<QString, std::unique_ptr<Histogram>>> m_histograms;
+    std::map<int, Gauge> m_gauges;
+    QHash<QString, QString> m_help;
+    int m_nextGauge = 1;
+};
+
+// Liczniki wiadomosci/bajtow per typ dla jednego kierunku jednej gry.
+// Typ przychodzi od peera, wiec etykiety sa zamkniete: znane typy rejestrujemy w konstruktorze,
+// a kazdy inny trafia do type="other" - klient nie moze dopisywac serii do rejestru.
+class GRY_METRYKI_EXPORT MessageCounters
+{
+public:
+    MessageCounters(const QString &game, const QString &direction, const QStringList &types);
+
+    void count(const QString &type, qint64 bytes, int copies = 1);
+
+private:
+    using Pair = std::pair<Counter *, Counter *>;
+
+    Pair pair(const QString &game, const QString &type) const;
+
+    QString m_messages;
+    QString m_bytes;
+    QHash<QString, Pair> m_byType;
+    Pair m_other;
+};
+
+// Mierzy czas zycia obiektu i wpisuje go do histogramu.
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(Histogram &h) : m_histogram(h) { m_timer.start(); }
+    ~ScopedTimer() { m_histogram.observe(m_timer.nsecsElapsed() / 1e9); }
+
+private:
+    Histogram &m_histogram;
+    QElapsedTimer m_timer;
+};
+
+// GET /metrics na 127.0.0.1:port; mierzy tez opoznienie petli zdarzen watku, w ktorym zyje.
+class GRY_METRYKI_EXPORT MetricsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsServer(QObject *parent = nullptr);
+
+    bool start(quint16 port);
+    quint16 port() const { return m_server.serverPort(); }
+
+private slots:
+    void onNewConnection();
+    void onLagTick();
+
+private:
+    static constexpr int LagTickMs = 100;
+
+    QTcpServer m_server;
+    QTimer m_lagTimer;
+    QElapsedTimer m_sinceTick;
+    Histogram &m_lag;
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef GAME_PLUGIN_H
+#define GAME_PLUGIN_H
+
+#include <QtPlugin>
+#include "game_config.h"
+
+class QMainWindow;
+
+// Modul gry ladowany przez QPluginLoader dopiero po kliknieciu "GRAJ".
+// Metadane z pliku .json przy Q_PLUGIN_METADATA launcher czyta bez ladowania biblioteki:
+//   { "gameType": "Kosci", "name": "Kosci (Yahtzee)", "order": 1 }
+class GamePlugin
+{
+public:
+    virtual ~GamePlugin() = default;
+
+    // Okno nalezy do wywolujacego; emituje sygnal gameClosed(), gdy gracz wraca do launchera.
+    virtual QMainWindow *createWindow(const GameLaunchConfig &config) = 0;
+
+    // Launcher trzyma jedno okno na gre: po powrocie do menu jest wstrzymywane (siec, timery),
+    // a przy kolejnym starcie resetowane nowa konfiguracja zamiast budowania UI od nowa.
+    virtual void resetWindow(QMainWindow *window, const GameLaunchConfig &config) = 0;
+    virtual void suspendWindow(QMainWindow *window) = 0;
+};
+
+#define GamePlugin_iid "pl.multigame.GamePlugin/1.1"
+Q_DECLARE_INTERFACE(GamePlugin, GamePlugin_iid)
+
+#endif
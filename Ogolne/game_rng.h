@@ -0,0 +1,75 @@
+#ifndef GAME_RNG_H
+#define GAME_RNG_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QRandomGenerator>
+
+// PCG32 (XSH-RR): 8 bajtow stanu, bez blokad, deterministyczny dla danego ziarna.
+// Kazda gra/pokoj/watek symulacji trzyma wlasna instancje zamiast QRandomGenerator::global().
+class GameRng
+{
+public:
+    explicit GameRng(quint64 seed = randomSeed()) { reseed(seed); }
+
+    void reseed(quint64 seed)
+    {
+        m_seed = seed;
+        m_state = 0;
+        next();
+        m_state += seed;
+        next();
+    }
+
+    quint64 seed() const { return m_seed; }
+    quint64 state() const { return m_state; }
+    void restore(quint64 seed, quint64 state) { m_seed = seed; m_state = state; }
+
+    quint32 next()
+    {
+        quint64 old = m_state;
+        m_state = old * 6364136223846793005ULL + INC;
+        quint32 xorshifted = (quint32)(((old >> 18u) ^ old) >> 27u);
+        quint32 rot = (quint32)(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((0u - rot) & 31u));
+    }
+
+    // Jak QRandomGenerator::bounded(lo, hi): wynik w [lo, hi), bez obciazenia modulo.
+    int bounded(int lo, int hi)
+    {
+        quint32 range = (quint32)(hi - lo);
+        quint32 threshold = (0u - range) % range;
+        for (;;)
+        {
+            quint32 r = next();
+            if (r >= threshold)
+                return lo + (int)(r % range);
+        }
+    }
+
+    static quint64 randomSeed()
+    {
+        quint64 s = 0;
+        while (s == 0)
+            s = QRandomGenerator::system()->generate64();
+        return s;
+    }
+
+    // Zobowiazanie hosta: SHA-256 ziarna wysylane na starcie, ziarno ujawniane po grze.
+    static QByteArray commitment(quint64 seed)
+    {
+        QByteArray bytes(8, 0);
+        for (int i = 0; i < 8; ++i)
+            bytes[i] = (char)((seed >> (8 * i)) & 0xFF);
+        return QCryptographicHash::hash(bytes, QCryptographicHash::Sha256).toHex();
+    }
+
+private:
+    static constexpr quint64 INC = 1442695040888963407ULL;
+
+    quint64 m_seed = 0;
+    quint64 m_state = 0;
+};
+
+#endif
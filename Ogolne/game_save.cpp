@@ -0,0 +1,221 @@
+#include "game_save.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+static const char MAGIC[4] = { 'G', 'S', 'A', 'V' };
+
+QByteArray GameSave::pack(GameType type, quint8 dataVersion, const QByteArray &data)
+{
+    QByteArray file;
+    file.reserve(HeaderSize + data.size());
+
+    QDataStream out(&file, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.writeRawData(MAGIC, 4);
+    out << FormatVersion << (quint8)type << dataVersion << (quint32)data.size()
+        << (quint16)qChecksum(data) << (quint16)0;
+
+    file.append(data);
+    return file;
+}
+
+bool GameSave::unpack(const QByteArray &file, GameType type, quint8 dataVersion, QByteArray *data, QString *error)
+{
+    auto fail = [error](const QString &text) {
+        if (error) *error = text;
+        return false;
+    };
+
+    if (file.size() < HeaderSize || std::memcmp(file.constData(), MAGIC, 4) != 0)
+        return fail("To nie jest plik zapisu gry.");
+
+    QDataStream in(file);
+    in.setByteOrder(QDataStream::LittleEndian);
+    in.skipRawData(4);
+
+    quint16 format = 0, crc = 0, reserved = 0;
+    quint8 fileType = 0, fileDataVersion = 0;
+    quint32 length = 0;
+    in >> format >> fileType >> fileDataVersion >> length >> crc >> reserved;
+
+    if (format != FormatVersion)
+        return fail("Nieobslugiwana wersja pliku zapisu.");
+    if (fileType != (quint8)type)
+        return fail("Zapis pochodzi z innej gry.");
+    if (fileDataVersion != dataVersion)
+        return fail("Nieobslugiwana wersja zapisu tej gry.");
+    if ((qint64)length != file.size() - HeaderSize)
+        return fail("Plik zapisu jest niekompletny.");
+
+    QByteArray payload = file.mid(HeaderSize);
+    if ((quint16)qChecksum(payload) != crc)
+        return fail("Plik zapisu jest uszkodzony.");
+
+    *data = payload;
+    return true;
+}
+
+bool GameSave::write(const QString &path, const QByteArray &packed, QString *error)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(packed) != packed.size() || !file.commit()) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool GameSave::read(const QString &path, GameType type, quint8 dataVersion, QByteArray *data, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = "Nie mozna otworzyc pliku zapisu.";
+        return false;
+    }
+    return unpack(file.readAll(), type, dataVersion, data, error);
+}
+
+QString GameSave::directory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/zapisy";
+}
+
+QString GameSave::autosavePath(GameType type)
+{
+    static const char *const names[] = { "wisielec", "kosci", "ludo" };
+    return directory() + "/" + names[(int)type] + "_autozapis.gsav";
+}
+
+QString GameSave::fileFilter()
+{
+    return "Zapisy gier (*.gsav)";
+}
+
+bool GameSave::writeAutosave(GameType type, quint8 dataVersion, const GameLaunchConfig &config, const QByteArray &data)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << (quint8)config.mode << config.playerName.toUtf8() << data;
+    return write(autosavePath(type), pack(type, dataVersion, payload));
+}
+
+bool GameSave::readAutosave(GameType type, quint8 dataVersion, const GameLaunchConfig &config, QByteArray *data)
+{
+    const QString path = autosavePath(type);
+    if (!QFile::exists(path)) return false;
+
+    QByteArray payload;
+    quint8 mode = 0;
+    QByteArray name, saved;
+    if (read(path, type, dataVersion, &payload)) {
+        QDataStream in(payload);
+        in.setByteOrder(QDataStream::LittleEndian);
+        in >> mode >> name >> saved;
+    }
+
+    // Uszkodzony albo ze starej wersji autozapis znika - nie ma sensu probowac go przy kazdym starcie.
+    if (saved.isEmpty()) {
+        QFile::remove(path);
+        return false;
+    }
+    if ((GameMode)mode != config.mode || QString::fromUtf8(name) != config.playerName) return false;
+
+    *data = saved;
+    return true;
+}
+
+void GameSave::removeAutosave(GameType type)
+{
+    QFile::remove(autosavePath(type));
+}
+
+static GameSnapshots *currentSnapshots = nullptr;
+
+GameSnapshots::GameSnapshots(QObject *parent)
+    : QObject(parent),
+    nextId(1),
+    writing(false)
+{
+    writer.setMaxThreadCount(1);
+    connect(&timer, &QTimer::timeout, this, &GameSnapshots::snapshotNow);
+    currentSnapshots = this;
+}
+
+GameSnapshots::~GameSnapshots()
+{
+    if (currentSnapshots == this) currentSnapshots = nullptr;
+    timer.stop();
+    writer.waitForDone();
+}
+
+GameSnapshots *GameSnapshots::instance()
+{
+    return currentSnapshots;
+}
+
+void GameSnapshots::start(const QString &directory, int intervalMs)
+{
+    dir = directory;
+    QDir().mkpath(dir);
+    timer.start(intervalMs);
+}
+
+void GameSnapshots::stop()
+{
+    timer.stop();
+}
+
+bool GameSnapshots::isActive() const
+{
+    return timer.isActive();
+}
+
+int GameSnapshots::add(const QString &name, std::function<QByteArray()> snapshot)
+{
+    const int id = nextId++;
+    rooms.insert(id, Room{ name, std::move(snapshot) });
+    return id;
+}
+
+void GameSnapshots::remove(int id)
+{
+    rooms.remove(id);
+}
+
+void GameSnapshots::snapshotNow()
+{
+    if (dir.isEmpty() || rooms.isEmpty()) return;
+
+    // Poprzednia partia jeszcze sie zapisuje (wolny dysk) - pomijamy takt zamiast kolejkowac.
+    if (writing.exchange(true)) return;
+
+    std::vector<std::pair<QString, QByteArray>> batch;
+    batch.reserve(rooms.size());
+    for (const Room &room : std::as_const(rooms)) {
+        QByteArray packed = room.snapshot();
+        if (!packed.isEmpty()) batch.emplace_back(dir + "/" + room.name + ".gsav", packed);
+    }
+    if (batch.empty()) {
+        writing.store(false);
+        return;
+    }
+
+    writer.start([this, batch = std::move(batch)]() {
+        for (const auto &file : batch) {
+            QString error;
+            if (!GameSave::write(file.first, file.second, &error))
+                qWarning("Snapshot %s: %s", qPrintable(file.first), qPrintable(error));
+        }
+        writing.store(false);
+    });
+}
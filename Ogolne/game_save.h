@@ -0,0 +1,83 @@
+#ifndef GAME_SAVE_H
+#define GAME_SAVE_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+#include <functional>
+#include "game_config.h"
+#include "gry_export.h"
+
+// Plik zapisu gry: naglowek 16 B (little-endian) + dane gry w jej wlasnym formacie binarnym.
+//   "GSAV" | wersja formatu u16 | typ gry u8 | wersja danych gry u8 | dlugosc danych u32 | CRC-16 u16 | 0 u16
+// Zapis przez QSaveFile: po awarii zostaje stary plik albo nowy, nigdy polowa.
+class GRY_WSPOLNE_EXPORT GameSave
+{
+public:
+    static constexpr quint16 FormatVersion = 1;
+    static constexpr int HeaderSize = 16;
+
+    static QByteArray pack(GameType type, quint8 dataVersion, const QByteArray &data);
+    static bool unpack(const QByteArray &file, GameType type, quint8 dataVersion, QByteArray *data, QString *error = nullptr);
+
+    static bool write(const QString &path, const QByteArray &packed, QString *error = nullptr);
+    static bool read(const QString &path, GameType type, quint8 dataVersion, QByteArray *data, QString *error = nullptr);
+
+    static QString directory();
+    static QString fileFilter();
+
+    // Autozapis gry lokalnej przy wstrzymaniu okna, jeden plik na gre. Zapamietuje tryb i nick
+    // z launchera: readAutosave oddaje dane tylko przy starcie z tymi samymi. Plik usuwa dopiero
+    // removeAutosave po udanym wznowieniu, wiec odmowa albo awaria w trakcie pytania go nie gubi.
+    static QString autosavePath(GameType type);
+    static bool writeAutosave(GameType type, quint8 dataVersion, const GameLaunchConfig &config, const QByteArray &data);
+    static bool readAutosave(GameType type, quint8 dataVersion, const GameLaunchConfig &config, QByteArray *data);
+    static void removeAutosave(GameType type);
+};
+
+// Okresowe snapshoty aktywnych pokoi hostow (--snapshot-dir albo GRY_SNAPSHOT_DIR).
+// Serializacja w watku GUI to kilkadziesiat bajtow na pokoj; zapis plikow idzie do osobnego
+// watku, wiec petla zdarzen stoi tylko na czas skopiowania stanu. Jeden obiekt na proces (main).
+class GRY_WSPOLNE_EXPORT GameSnapshots : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int IntervalMs = 30000;
+
+    explicit GameSnapshots(QObject *parent = nullptr);
+    ~GameSnapshots();
+
+    static GameSnapshots *instance();
+
+    void start(const QString &directory, int intervalMs = IntervalMs);
+    void stop();
+    bool isActive() const;
+
+    // Dostawca zwraca spakowany plik (GameSave::pack) albo pusty bufor, gdy nie ma czego zapisac;
+    // nazwa jest nazwa pliku w katalogu snapshotow.
+    int add(const QString &name, std::function<QByteArray()> snapshot);
+    void remove(int id);
+
+    void snapshotNow();
+
+private:
+    struct Room
+    {
+        QString name;
+        std::function<QByteArray()> snapshot;
+    };
+
+    QString dir;
+    QTimer timer;
+    QHash<int, Room> rooms;
+    int nextId;
+    std::atomic<bool> writing;
+    QThreadPool writer;
+};
+
+#endif
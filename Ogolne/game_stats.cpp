@@ -0,0 +1,330 @@
+#include "game_stats.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+static const char LOG_MAGIC[4] = { 'G', 'S', 'T', 'L' };
+static const char INDEX_MAGIC[4] = { 'G', 'S', 'T', 'I' };
+static const quint16 LOG_VERSION = 1;
+static const quint32 INDEX_VERSION = 1;
+static const int LOG_HEADER_SIZE = 8;
+static const int RECORD_HEADER_SIZE = 4;
+static const int RECORD_FIXED_SIZE = 12;
+static const int INDEX_HEADER_SIZE = 32;
+static const int ENTRY_SIZE = 128;
+
+static GameStats *currentStats = nullptr;
+
+GameStats::GameStats()
+    : coveredLength(0),
+    dirty(false)
+{
+    currentStats = this;
+}
+
+GameStats::~GameStats()
+{
+    close();
+    if (currentStats == this) currentStats = nullptr;
+}
+
+GameStats *GameStats::instance()
+{
+    return currentStats;
+}
+
+QString GameStats::directory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/statystyki";
+}
+
+bool GameStats::open(const QString &dir)
+{
+    close();
+    QDir().mkpath(dir);
+
+    log.setFileName(dir + "/wyniki.glog");
+    indexPath = dir + "/wyniki.gidx";
+    if (!log.open(QIODevice::ReadWrite)) return false;
+
+    if (log.size() == 0) {
+        QByteArray header;
+        QDataStream out(&header, QIODevice::WriteOnly);
+        out.setByteOrder(QDataStream::LittleEndian);
+        out.writeRawData(LOG_MAGIC, 4);
+        out << LOG_VERSION << (quint16)0;
+        log.write(header);
+        log.flush();
+    }
+
+    char header[LOG_HEADER_SIZE];
+    if (log.read(header, LOG_HEADER_SIZE) != LOG_HEADER_SIZE || std::memcmp(header, LOG_MAGIC, 4) != 0
+        || qFromLittleEndian<quint16>(header + 4) != LOG_VERSION) {
+        qWarning("Statystyki: nieznany format %s", qPrintable(log.fileName()));
+        log.close();
+        return false;
+    }
+
+    // Indeks nie pasujacy do dziennika (inna wersja, dziennik krotszy) budujemy od zera.
+    if (!loadIndex()) {
+        players.clear();
+        byName.clear();
+        coveredLength = LOG_HEADER_SIZE;
+    }
+
+    const qint64 end = replayLog(coveredLength);
+    if (end != coveredLength) {
+        coveredLength = end;
+        dirty = true;
+        saveIndex();
+    }
+    return true;
+}
+
+void GameStats::close()
+{
+    if (!log.isOpen()) return;
+    if (dirty) saveIndex();
+    log.close();
+    players.clear();
+    byName.clear();
+    coveredLength = 0;
+}
+
+bool GameStats::isOpen() const
+{
+    return log.isOpen();
+}
+
+bool GameStats::record(const Result &result)
+{
+    if (!log.isOpen()) return false;
+
+    Result r = result;
+    r.player = r.player.left(MaxNameLength);
+    r.score = qBound(0, r.score, 0xFFFF);
+    const QByteArray name = r.player.toUtf8();
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << (qint64)QDateTime::currentMSecsSinceEpoch() << (quint8)r.type << (quint8)(r.won ? 1 : 0) << (quint16)r.score;
+    out.writeRawData(name.constData(), name.size());
+
+    char header[RECORD_HEADER_SIZE];
+    qToLittleEndian<quint16>((quint16)payload.size(), header);
+    qToLittleEndian<quint16>((quint16)qChecksum(payload), header + 2);
+
+    // Jeden write na rekord i flush - po awarii najwyzej ostatni rekord jest urwany.
+    log.seek(coveredLength);
+    if (log.write(QByteArray(header, RECORD_HEADER_SIZE) + payload) != RECORD_HEADER_SIZE + payload.size())
+        return false;
+    log.flush();
+
+    apply(r);
+    coveredLength = log.pos();
+    dirty = true;
+    return true;
+}
+
+int GameStats::playerCount() const
+{
+    return players.size();
+}
+
+const GameStats::PlayerStats &GameStats::player(int index) const
+{
+    return players[index];
+}
+
+int GameStats::findPlayer(const QString &name) const
+{
+    return byName.value(name.left(MaxNameLength), -1);
+}
+
+QVector<const GameStats::PlayerStats *> GameStats::leaderboard(GameType type, int limit) const
+{
+    const int t = (int)type;
+    QVector<const PlayerStats *> top;
+    for (const PlayerStats &p : players) {
+        if (p.games[t] > 0) top.push_back(&p);
+    }
+
+    auto better = [t](const PlayerStats *a, const PlayerStats *b) {
+        if (a->wins[t] != b->wins[t]) return a->wins[t] > b->wins[t];
+        if (a->games[t] != b->games[t]) return a->games[t] < b->games[t];
+        return a->name < b->name;
+    };
+    const int n = std::min<int>(limit, top.size());
+    std::partial_sort(top.begin(), top.begin() + n, top.end(), better);
+    top.resize(n);
+    return top;
+}
+
+void GameStats::apply(const Result &r)
+{
+    int index = byName.value(r.player, -1);
+    if (index < 0) {
+        index = players.size();
+        players.push_back(PlayerStats());
+        players.last().name = r.player;
+        byName.insert(r.player, index);
+    }
+
+    PlayerStats &p = players[index];
+    const int t = (int)r.type;
+    p.games[t]++;
+    if (r.won) p.wins[t]++;
+
+    if (r.type == GameType::Kosci) {
+        p.bestScore = std::max(p.bestScore, r.score);
+        p.scoreSum += r.score;
+        p.scoreBuckets[std::min(r.score / ScoreBucketWidth, ScoreBuckets - 1)]++;
+    } else if (r.type == GameType::Chinczyk && r.score >= 1 && r.score <= MaxPlaces) {
+        p.places[r.score - 1]++;
+    }
+}
+
+qint64 GameStats::replayLog(qint64 from)
+{
+    log.seek(from);
+    const QByteArray tail = log.readAll();
+    const char *data = tail.constData();
+
+    qint64 pos = 0;
+    while (pos + RECORD_HEADER_SIZE <= tail.size()) {
+        const int length = qFromLittleEndian<quint16>(data + pos);
+        const quint16 crc = qFromLittleEndian<quint16>(data + pos + 2);
+        if (length < RECORD_FIXED_SIZE || pos + RECORD_HEADER_SIZE + length > tail.size()) break;
+
+        const char *payload = data + pos + RECORD_HEADER_SIZE;
+        if ((quint16)qChecksum(QByteArrayView(payload, length)) != crc) break;
+
+        const quint8 type = (quint8)payload[8];
+        if (type >= GameCount) break;
+
+        Result r;
+        r.type = (GameType)type;
+        r.won = payload[9] != 0;
+        r.score = qFromLittleEndian<quint16>(payload + 10);
+        r.player = QString::fromUtf8(payload + RECORD_FIXED_SIZE, length - RECORD_FIXED_SIZE);
+        apply(r);
+
+        pos += RECORD_HEADER_SIZE + length;
+    }
+
+    const qint64 end = from + pos;
+    if (end < log.size()) {
+        qWarning("Statystyki: odcieto %lld B uszkodzonego konca dziennika", log.size() - end);
+        log.resize(end);
+    }
+    return end;
+}
+
+bool GameStats::loadIndex()
+{
+    QFile file(indexPath);
+    if (!file.open(QIODevice::ReadOnly) || file.size() < INDEX_HEADER_SIZE) return false;
+
+    const qint64 size = file.size();
+    const uchar *data = file.map(0, size);
+    if (!data) return false;
+
+    const quint64 covered = qFromLittleEndian<quint64>(data + 8);
+    const quint32 count = qFromLittleEndian<quint32>(data + 16);
+    const quint32 entrySize = qFromLittleEndian<quint32>(data + 20);
+    const quint32 poolOffset = qFromLittleEndian<quint32>(data + 24);
+    const quint32 poolBytes = qFromLittleEndian<quint32>(data + 28);
+
+    bool valid = std::memcmp(data, INDEX_MAGIC, 4) == 0
+        && qFromLittleEndian<quint32>(data + 4) == INDEX_VERSION
+        && entrySize == ENTRY_SIZE
+        && covered >= (quint64)LOG_HEADER_SIZE && covered <= (quint64)log.size()
+        && (quint64)INDEX_HEADER_SIZE + (quint64)count * ENTRY_SIZE <= poolOffset
+        && (quint64)poolOffset + poolBytes <= (quint64)size;
+
+    players.clear();
+    byName.clear();
+    if (valid) {
+        players.resize(count);
+        const char *pool = reinterpret_cast<const char *>(data + poolOffset);
+        for (quint32 i = 0; i < count && valid; ++i) {
+            const uchar *e = data + INDEX_HEADER_SIZE + i * ENTRY_SIZE;
+            const quint32 nameOffset = qFromLittleEndian<quint32>(e);
+            const quint32 nameBytes = qFromLittleEndian<quint32>(e + 4);
+            if ((quint64)nameOffset + nameBytes > poolBytes) {
+                valid = false;
+                break;
+            }
+
+            PlayerStats &p = players[i];
+            p.name = QString::fromUtf8(pool + nameOffset, nameBytes);
+            for (int g = 0; g < GameCount; ++g) {
+                p.games[g] = qFromLittleEndian<quint32>(e + 8 + 4 * g);
+                p.wins[g] = qFromLittleEndian<quint32>(e + 20 + 4 * g);
+            }
+            p.bestScore = qFromLittleEndian<quint32>(e + 32);
+            p.scoreSum = qFromLittleEndian<quint64>(e + 40);
+            for (int b = 0; b < ScoreBuckets; ++b)
+                p.scoreBuckets[b] = qFromLittleEndian<quint32>(e + 48 + 4 * b);
+            for (int m = 0; m < MaxPlaces; ++m)
+                p.places[m] = qFromLittleEndian<quint32>(e + 112 + 4 * m);
+            byName.insert(p.name, i);
+        }
+    }
+
+    file.unmap(const_cast<uchar *>(data));
+    if (!valid) return false;
+
+    coveredLength = covered;
+    dirty = false;
+    return true;
+}
+
+bool GameStats::saveIndex()
+{
+    QByteArray pool;
+    QByteArray entries(players.size() * ENTRY_SIZE, 0);
+    for (int i = 0; i < players.size(); ++i) {
+        const PlayerStats &p = players[i];
+        const QByteArray name = p.name.toUtf8();
+        uchar *e = reinterpret_cast<uchar *>(entries.data()) + i * ENTRY_SIZE;
+
+        qToLittleEndian<quint32>((quint32)pool.size(), e);
+        qToLittleEndian<quint32>((quint32)name.size(), e + 4);
+        pool.append(name);
+        for (int g = 0; g < GameCount; ++g) {
+            qToLittleEndian<quint32>((quint32)p.games[g], e + 8 + 4 * g);
+            qToLittleEndian<quint32>((quint32)p.wins[g], e + 20 + 4 * g);
+        }
+        qToLittleEndian<quint32>((quint32)p.bestScore, e + 32);
+        qToLittleEndian<quint64>((quint64)p.scoreSum, e + 40);
+        for (int b = 0; b < ScoreBuckets; ++b)
+            qToLittleEndian<quint32>((quint32)p.scoreBuckets[b], e + 48 + 4 * b);
+        for (int m = 0; m < MaxPlaces; ++m)
+            qToLittleEndian<quint32>((quint32)p.places[m], e + 112 + 4 * m);
+    }
+
+    QByteArray header;
+    QDataStream out(&header, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.writeRawData(INDEX_MAGIC, 4);
+    out << INDEX_VERSION << (quint64)coveredLength << (quint32)players.size() << (quint32)ENTRY_SIZE
+        << (quint32)(INDEX_HEADER_SIZE + entries.size()) << (quint32)pool.size();
+
+    // Indeks zapisujemy atomowo; po awarii zostaje stary, a brakujacy ogon dziennika doczyta open().
+    QSaveFile file(indexPath);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(header);
+    file.write(entries);
+    file.write(pool);
+    if (!file.commit()) return false;
+
+    dirty = false;
+    return true;
+}
@@ -0,0 +1,88 @@
+#ifndef GAME_STATS_H
+#define GAME_STATS_H
+
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include "game_config.h"
+#include "gry_export.h"
+
+// Lokalne statystyki graczy: dziennik wynikow dopisywany na koncu (.glog) i indeks (.gidx)
+// z licznikami zagregowanymi per gracz. Indeks jest mapowany przy otwarciu, wiec start kosztuje
+// tyle, ilu jest graczy, a nie ile rozegrano gier. Zrodlem prawdy jest dziennik: indeks pamieta,
+// ile jego bajtow obejmuje, i przy otwarciu doczytywany jest tylko ogon spoza indeksu.
+//
+// Dziennik (little-endian): "GSTL" | u16 wersja | u16 0, potem rekordy
+//   u16 dlugosc danych | u16 CRC-16 danych | i64 czas ms | u8 gra | u8 wygrana | u16 wynik | nazwa UTF-8
+// Indeks: naglowek 32 B ("GSTI" | u32 wersja | u64 objety dziennik | u32 graczy | u32 rozmiar wpisu
+//   | u32 offset puli | u32 bajty puli), wpisy po 128 B, pula nazw UTF-8.
+// Urwany lub uszkodzony ostatni rekord (awaria w trakcie dopisywania) jest odcinany przy otwarciu.
+class GRY_WSPOLNE_EXPORT GameStats
+{
+public:
+    static constexpr int GameCount = 3;
+    static constexpr int MaxPlaces = 4;
+    static constexpr int ScoreBuckets = 16;
+    static constexpr int ScoreBucketWidth = 25;
+    static constexpr int MaxNameLength = 32;
+
+    // Wynik jednego gracza w jednej grze. score: Kosci - suma punktow, Chinczyk - miejsce (1-4),
+    // Wisielec - liczba bledow.
+    struct Result
+    {
+        GameType type;
+        QString player;
+        bool won;
+        int score;
+    };
+
+    struct PlayerStats
+    {
+        QString name;
+        int games[GameCount] = {};
+        int wins[GameCount] = {};
+        int bestScore = 0;
+        qint64 scoreSum = 0;
+        int scoreBuckets[ScoreBuckets] = {};    // rozklad wynikow Kosci co ScoreBucketWidth pkt
+        int places[MaxPlaces] = {};             // miejsca w Chinczyku
+    };
+
+    GameStats();
+    ~GameStats();
+
+    GameStats(const GameStats &) = delete;
+    GameStats &operator=(const GameStats &) = delete;
+
+    // Jeden obiekt na proces (main); wtyczki gier dopisuja wyniki przez instance().
+    static GameStats *instance();
+    static QString directory();
+
+    bool open(const QString &directory = GameStats::directory());
+    void close();
+    bool isOpen() const;
+
+    bool record(const Result &result);
+
+    int playerCount() const;
+    const PlayerStats &player(int index) const;
+    int findPlayer(const QString &name) const;
+
+    // Najwiecej wygranych w danej grze, przy remisie mniej rozegranych.
+    QVector<const PlayerStats *> leaderboard(GameType type, int limit) const;
+
+private:
+    bool loadIndex();
+    bool saveIndex();
+    qint64 replayLog(qint64 from);
+    void apply(const Result &result);
+
+    QFile log;
+    QString indexPath;
+    qint64 coveredLength;
+    bool dirty;
+    QVector<PlayerStats> players;
+    QHash<QString, int> byName;
+};
+
+#endif
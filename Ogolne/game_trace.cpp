@@ -0,0 +1,176 @@
+#include "game_trace.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QCoreApplication>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct TraceEvent
+{
+    const char *name;
+    const char *category;
+    qint64 startNs;
+    qint64 durationNs;
+};
+
+// Jeden pisarz (watek wlasciciel), czytelnik widzi tylko wpisy opublikowane przez size (release).
+struct ThreadBuffer
+{
+    static constexpr size_t Capacity = 1 << 16;
+
+    ThreadBuffer(int id) : tid(id), events(new TraceEvent[Capacity]) {}
+
+    int tid;
+    std::unique_ptr<TraceEvent[]> events;
+    std::atomic<size_t> size{ 0 };
+    std::atomic<quint64> dropped{ 0 };
+    std::atomic<const char *> current{ nullptr };
+};
+
+struct TraceState
+{
+    QMutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::atomic<qint64> originNs{ 0 };
+};
+
+TraceState &state()
+{
+    static TraceState s;
+    return s;
+}
+
+ThreadBuffer &localBuffer()
+{
+    // Bufor zyje do konca procesu, wiec wskaznik thread_local nie moze zawisnac.
+    thread_local ThreadBuffer *buffer = nullptr;
+    if (!buffer) {
+        TraceState &s = state();
+        QMutexLocker lock(&s.mutex);
+        s.buffers.emplace_back(new ThreadBuffer((int)s.buffers.size() + 1));
+        buffer = s.buffers.back().get();
+    }
+    return *buffer;
+}
+
+QByteArray escaped(const char *text)
+{
+    QByteArray out(text);
+    out.replace('\\', "\\\\").replace('"', "\\\"");
+    return out;
+}
+
+}
+
+std::atomic<int> GameTrace::s_flags{ 0 };
+
+qint64 GameTrace::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void GameTrace::start()
+{
+    TraceState &s = state();
+    {
+        QMutexLocker lock(&s.mutex);
+        for (auto &b : s.buffers) {
+            b->size.store(0, std::memory_order_relaxed);
+            b->dropped.store(0, std::memory_order_relaxed);
+        }
+    }
+    s.originNs.store(now(), std::memory_order_relaxed);
+    s_flags.fetch_or(Recording, std::memory_order_release);
+}
+
+void GameTrace::setAttribution(bool on)
+{
+    if (on) s_flags.fetch_or(Attribution, std::memory_order_release);
+    else s_flags.fetch_and(~Attribution, std::memory_order_release);
+}
+
+const char *GameTrace::enter(const char *name)
+{
+    return localBuffer().current.exchange(name, std::memory_order_relaxed);
+}
+
+void GameTrace::leave(const char *parent)
+{
+    localBuffer().current.store(parent, std::memory_order_relaxed);
+}
+
+const void *GameTrace::currentThread()
+{
+    return &localBuffer();
+}
+
+const char *GameTrace::activeSpan(const void *thread)
+{
+    return static_cast<const ThreadBuffer *>(thread)->current.load(std::memory_order_relaxed);
+}
+
+void GameTrace::complete(const char *name, const char *category, qint64 startNs, qint64 endNs)
+{
+    ThreadBuffer &b = localBuffer();
+    size_t i = b.size.load(std::memory_order_relaxed);
+    if (i >= ThreadBuffer::Capacity) {
+        b.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    b.events[i] = TraceEvent{ name, category, startNs, endNs - startNs };
+    b.size.store(i + 1, std::memory_order_release);
+}
+
+bool GameTrace::stop(const QString &path)
+{
+    s_flags.fetch_and(~Recording, std::memory_order_release);
+
+    TraceState &s = state();
+    const qint64 origin = s.originNs.load(std::memory_order_relaxed);
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    QByteArray out;
+    out.reserve(1 << 20);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    bool first = true;
+    auto append = [&](const QByteArray &line) {
+        if (!first) out += ",\n";
+        out += line;
+        first = false;
+    };
+
+    QMutexLocker lock(&s.mutex);
+    for (const auto &b : s.buffers) {
+        const size_t n = b->size.load(std::memory_order_acquire);
+        if (n == 0) continue;
+
+        append("{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" + QByteArray::number(pid)
+               + ",\"tid\":" + QByteArray::number(b->tid)
+               + ",\"args\":{\"name\":\"watek " + QByteArray::number(b->tid) + "\"}}");
+
+        for (size_t i = 0; i < n; ++i) {
+            const TraceEvent &e = b->events[i];
+            append("{\"ph\":\"X\",\"name\":\"" + escaped(e.name) + "\",\"cat\":\"" + escaped(e.category)
+                   + "\",\"ts\":" + QByteArray::number((e.startNs - origin) / 1000.0, 'f', 3)
+                   + ",\"dur\":" + QByteArray::number(e.durationNs / 1000.0, 'f', 3)
+                   + ",\"pid\":" + QByteArray::number(pid) + ",\"tid\":" + QByteArray::number(b->tid) + "}");
+        }
+
+        const quint64 dropped = b->dropped.load(std::memory_order_relaxed);
+        if (dropped)
+            append("{\"ph\":\"i\",\"s\":\"t\",\"name\":\"dropped " + QByteArray::number(dropped)
+                   + "\",\"ts\":0,\"pid\":" + QByteArray::number(pid) + ",\"tid\":" + QByteArray::number(b->tid) + "}");
+    }
+    out += "\n]}\n";
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(out);
+    return file.commit();
+}
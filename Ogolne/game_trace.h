@@ -0,0 +1,70 @@
+#ifndef GAME_TRACE_H
+#define GAME_TRACE_H
+
+#include <QString>
+#include <atomic>
+#include "gry_export.h"
+
+// Opcjonalne nagrywanie przebiegu w formacie Chrome trace (chrome://tracing, ui.perfetto.dev).
+// Kazdy watek pisze do wlasnego bufora o stalej pojemnosci bez blokad; zapis do pliku scala bufory.
+// Niezaleznie od nagrywania watek moze publikowac nazwe otwartego spanu (atrybucja dla watchdoga).
+// Gdy oba tryby sa wylaczone, TraceSpan kosztuje jedno sprawdzenie flagi.
+class GRY_WSPOLNE_EXPORT GameTrace
+{
+public:
+    static bool enabled() { return s_flags.load(std::memory_order_relaxed) != 0; }
+    static bool recording() { return (s_flags.load(std::memory_order_relaxed) & Recording) != 0; }
+
+    static void start();
+    static bool stop(const QString &path);
+    static void setAttribution(bool on);
+
+    static qint64 now();
+    static void complete(const char *name, const char *category, qint64 startNs, qint64 endNs);
+
+    static const char *enter(const char *name);
+    static void leave(const char *parent);
+
+    // Uchwyt watku wywolujacego; activeSpan() mozna czytac z dowolnego watku.
+    static const void *currentThread();
+    static const char *activeSpan(const void *thread);
+
+private:
+    enum Flag { Recording = 0x1, Attribution = 0x2 };
+    static std::atomic<int> s_flags;
+};
+
+class TraceSpan
+{
+public:
+    TraceSpan(const char *name, const char *category)
+        : m_name(GameTrace::enabled() ? name : nullptr), m_category(category), m_parent(nullptr), m_start(0)
+    {
+        if (!m_name) return;
+        m_parent = GameTrace::enter(m_name);
+        m_start = GameTrace::now();
+    }
+
+    ~TraceSpan()
+    {
+        if (!m_name) return;
+        GameTrace::leave(m_parent);
+        if (GameTrace::recording()) GameTrace::complete(m_name, m_category, m_start, GameTrace::now());
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *m_name;
+    const char *m_category;
+    const char *m_parent;
+    qint64 m_start;
+};
+
+#define GAME_TRACE_CONCAT2(a, b) a##b
+#define GAME_TRACE_CONCAT(a, b) GAME_TRACE_CONCAT2(a, b)
+// Nazwa i kategoria musza byc literalami - bufor trzyma tylko wskazniki.
+#define GAME_TRACE(name, category) TraceSpan GAME_TRACE_CONCAT(gameTraceSpan_, __LINE__)(name, category)
+
+#endif
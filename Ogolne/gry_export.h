@@ -0,0 +1,20 @@
+#ifndef GRY_EXPORT_H
+#define GRY_EXPORT_H
+
+#include <QtGlobal>
+
+// Biblioteki wspolne sa wspoldzielone (SHARED), zeby launcher i wtyczki gier
+// widzialy ten sam rejestr metryk, ten sam stan sledzenia i ten sam watchdog.
+#if defined(GRY_WSPOLNE_BUILD)
+#  define GRY_WSPOLNE_EXPORT Q_DECL_EXPORT
+#else
+#  define GRY_WSPOLNE_EXPORT Q_DECL_IMPORT
+#endif
+
+#if defined(GRY_METRYKI_BUILD)
+#  define GRY_METRYKI_EXPORT Q_DECL_EXPORT
+#else
+#  define GRY_METRYKI_EXPORT Q_DECL_IMPORT
+#endif
+
+#endif
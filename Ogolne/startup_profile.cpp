@@ -0,0 +1,126 @@
+#include "startup_profile.h"
+#include <QEvent>
+#include <QObject>
+#include <cstring>
+#include <vector>
+
+bool StartupProfile::s_enabled = false;
+
+namespace {
+
+struct Stage
+{
+    const char *name;
+    qint64 startNs;
+    qint64 endNs;
+};
+
+struct Section
+{
+    QString name;
+    qint64 startNs = 0;
+    qint64 lastNs = 0;
+    bool open = false;
+    std::vector<Stage> stages;
+};
+
+Section &current()
+{
+    static Section s;
+    return s;
+}
+
+void report(const Section &s, qint64 frameNs)
+{
+    auto ms = [](qint64 ns) { return ns / 1e6; };
+
+    qInfo("[profil startu] %s: pierwsza klatka po %.1f ms", qPrintable(s.name), ms(frameNs - s.startNs));
+    qInfo("  %9s %9s  etap", "od [ms]", "czas [ms]");
+    for (const Stage &st : s.stages)
+        qInfo("  %9.1f %9.1f  %s", ms(st.startNs - s.startNs), ms(st.endNs - st.startNs), st.name);
+}
+
+// Filtr sam obsluguje pierwsze UpdateRequest, zeby czas obejmowal malowanie, i znika.
+class FirstFrameFilter : public QObject
+{
+public:
+    FirstFrameFilter(QObject *window, std::function<void(qint64)> done)
+        : QObject(window), window(window), done(std::move(done))
+    {
+        window->installEventFilter(this);
+    }
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (watched != window || event->type() != QEvent::UpdateRequest)
+            return QObject::eventFilter(watched, event);
+
+        window->removeEventFilter(this);
+        watched->event(event);
+        done(GameTrace::now());
+        deleteLater();
+        return true;
+    }
+
+private:
+    QObject *window;
+    std::function<void(qint64)> done;
+};
+
+}
+
+void StartupProfile::begin(int argc, char **argv)
+{
+    s_enabled = qEnvironmentVariableIsSet("GRY_PROFILE_STARTUP");
+    for (int i = 1; i < argc && !s_enabled; ++i)
+        s_enabled = std::strcmp(argv[i], "--profile-startup") == 0;
+
+    if (s_enabled) section("start programu");
+}
+
+void StartupProfile::section(const QString &name)
+{
+    if (!s_enabled) return;
+
+    Section &s = current();
+    s.name = name;
+    s.startNs = s.lastNs = GameTrace::now();
+    s.open = true;
+    s.stages.clear();
+}
+
+void StartupProfile::stage(const char *name, qint64 startNs, qint64 endNs)
+{
+    if (GameTrace::recording()) GameTrace::complete(name, "startup", startNs, endNs);
+
+    Section &s = current();
+    if (!s_enabled || !s.open) return;
+    s.stages.push_back({ name, startNs, endNs });
+    s.lastNs = endNs;
+}
+
+void StartupProfile::mark(const char *name)
+{
+    if (!s_enabled) return;
+    stage(name, current().lastNs, GameTrace::now());
+}
+
+void StartupProfile::finish(qint64 frameNs)
+{
+    Section &s = current();
+    if (!s_enabled || !s.open) return;
+    s.open = false;
+    report(s, frameNs);
+}
+
+void StartupProfile::finishOnFirstFrame(QObject *window)
+{
+    if (!s_enabled) return;
+    onFirstFrame(window, &StartupProfile::finish);
+}
+
+void StartupProfile::onFirstFrame(QObject *window, std::function<void(qint64)> done)
+{
+    new FirstFrameFilter(window, std::move(done));
+}
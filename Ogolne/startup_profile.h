@@ -0,0 +1,52 @@
+#ifndef STARTUP_PROFILE_H
+#define STARTUP_PROFILE_H
+
+#include <QString>
+#include <functional>
+#include "gry_export.h"
+#include "game_trace.h"
+
+class QObject;
+
+// Profil zimnego startu: --profile-startup albo GRY_PROFILE_STARTUP=1.
+// Etapy naleza do sekcji (start programu, kazde uruchomienie gry). Sekcja konczy sie pierwsza
+// klatka okna i wtedy jej rozbicie trafia na stderr. Tylko watek GUI.
+class GRY_WSPOLNE_EXPORT StartupProfile
+{
+public:
+    // Pierwsza instrukcja main - przed QApplication, wiec flage czytamy z argv.
+    static void begin(int argc, char **argv);
+    static bool enabled() { return s_enabled; }
+
+    static void section(const QString &name);
+    static void stage(const char *name, qint64 startNs, qint64 endNs);
+    // Etap od konca poprzedniego do teraz - dla kolejnych krokow w main.
+    static void mark(const char *name);
+    // Zamyka sekcje i wypisuje raport; finishOnFirstFrame robi to po pierwszej klatce okna.
+    static void finish(qint64 frameNs);
+    static void finishOnFirstFrame(QObject *window);
+
+    // done(czas w ns) zaraz po obsluzeniu pierwszego UpdateRequest okna (malowanie jest synchroniczne).
+    static void onFirstFrame(QObject *window, std::function<void(qint64)> done);
+
+private:
+    static bool s_enabled;
+};
+
+// Nazwa musi byc literalem, jak w GAME_TRACE.
+class StartupStage
+{
+public:
+    explicit StartupStage(const char *name)
+        : m_name(StartupProfile::enabled() ? name : nullptr), m_start(m_name ? GameTrace::now() : 0) {}
+    ~StartupStage() { if (m_name) StartupProfile::stage(m_name, m_start, GameTrace::now()); }
+
+    StartupStage(const StartupStage &) = delete;
+    StartupStage &operator=(const StartupStage &) = delete;
+
+private:
+    const char *m_name;
+    qint64 m_start;
+};
+
+#endif
@@ -0,0 +1,374 @@
+#include <QApplication>
+#include <QtTest>
+#include <QTcpServer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QXmlStreamReader>
+#include <QTemporaryDir>
+#include <QSaveFile>
+#include <QSysInfo>
+#include <QDateTime>
+#include <functional>
+
+#include "gra.h"
+#include "boardscene.h"
+#include "chinczyk_network.h"
+#include "kosci_logic.h"
+#include "kosci_network.h"
+#include "game_rng.h"
+
+// Benchmarki goracych sciezek: zasady, protokol i rysowanie.
+// Uruchomienie: benchmarks [--json wyniki.json] [opcje Qt Test, np. -iterations 1000 nazwaFunkcji]
+
+static const int LICZBA_STANOW = 64;
+static const int ROZMIAR_SERII = 512;
+
+static bool czekaj(const std::function<bool()>& warunek, int limitMs = 5000)
+{
+    QElapsedTimer t;
+    t.start();
+    while (!warunek())
+    {
+        if (t.elapsed() > limitMs)
+            return false;
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    }
+    return true;
+}
+
+static quint16 wolnyPort()
+{
+    QTcpServer s;
+    s.listen(QHostAddress::LocalHost, 0);
+    quint16 port = s.serverPort();
+    s.close();
+    return port;
+}
+
+class BenchmarkiGier : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void kosciObliczPunkty();
+
+    void ludoMozliwePionki();
+    void ludoWykonajRuch();
+    void ludoStanJson_data();
+    void ludoStanJson();
+    void ludoOdswiezScene();
+
+    void ludoSerwerOdbiera();
+    void ludoKlientOdbiera();
+    void kosciKlientOdbiera();
+
+private:
+    // Stany w polowie rozgrywki, zaraz po rzucie, z co najmniej jednym dozwolonym ruchem.
+    QVector<QByteArray> m_stany;
+};
+
+void BenchmarkiGier::initTestCase()
+{
+    GameRng rng(0x5EEDull);
+    Gra gra;
+    gra.ustawOpoznieniePominiecia(0);
+
+    while (m_stany.size() < LICZBA_STANOW)
+    {
+        gra.nowaGra(4, ((quint64)rng.next() << 32) | rng.next() | 1);
+
+        const int kroki = rng.bounded(40, 160);
+        for (int k = 0; k < kroki; ++k)
+        {
+            if (gra.czyOczekujeNaDecyzje())
+            {
+                if (!gra.moznaKontynuowacPoWygranej()) break;
+                gra.kontynuujPoWygranej();
+            }
+            if (!gra.czyRzucono())
+                gra.rzutKostka();
+
+            auto mozliwe = gra.mozliwePionki();
+            if (!mozliwe.isEmpty())
+                gra.wykonajRuch(mozliwe[rng.bounded(0, mozliwe.size())]);
+        }
+
+        if (gra.czyOczekujeNaDecyzje()) continue;
+        if (!gra.czyRzucono()) gra.rzutKostka();
+        if (gra.mozliwePionki().isEmpty()) continue;
+
+        m_stany.push_back(gra.stanBinarny());
+    }
+}
+
+void BenchmarkiGier::kosciObliczPunkty()
+{
+    KosciLogic logic;
+    int suma = 0;
+
+    QBENCHMARK
+    {
+        std::array<int, 5> d;
+        for (int kod = 0; kod < 6 * 6 * 6 * 6 * 6; ++kod)
+        {
+            int x = kod;
+            for (int i = 0; i < 5; ++i) { d[i] = x % 6 + 1; x /= 6; }
+            for (int k = 0; k <= 12; ++k)
+                suma += logic.obliczPunkty((Kategoria)k, d);
+        }
+    }
+    QVERIFY(suma > 0);
+}
+
+void BenchmarkiGier::ludoMozliwePionki()
+{
+    QVector<Gra*> gry;
+    for (const QByteArray& stan : m_stany)
+    {
+        Gra* g = new Gra(this);
+        QVERIFY(g->ustawStanBinarny(stan));
+        gry.push_back(g);
+    }
+
+    int ruchy = 0;
+    QBENCHMARK
+    {
+        for (Gra* g : gry)
+            ruchy += g->mozliwePionki().size();
+    }
+    QVERIFY(ruchy > 0);
+    qDeleteAll(gry);
+}
+
+void BenchmarkiGier::ludoWykonajRuch()
+{
+    // Ruch zmienia stan, wiec kazda iteracja zaczyna od przywrocenia migawki.
+    Gra gra;
+    gra.ustawOpoznieniePominiecia(0);
+
+    QBENCHMARK
+    {
+        for (const QByteArray& stan : m_stany)
+        {
+            gra.ustawStanBinarny(stan);
+            auto mozliwe = gra.mozliwePionki();
+            gra.wykonajRuch(mozliwe.last());
+        }
+    }
+}
+
+void BenchmarkiGier::ludoStanJson_data()
+{
+    QTest::addColumn<bool>("przezTekst");
+    QTest::newRow("obiekt") << false;
+    QTest::newRow("tekst") << true;
+}
+
+void BenchmarkiGier::ludoStanJson()
+{
+    QFETCH(bool, przezTekst);
+
+    Gra zrodlo, cel;
+
+    QBENCHMARK
+    {
+        for (const QByteArray& stan : m_stany)
+        {
+            zrodlo.ustawStanBinarny(stan);
+            QJsonObject j = zrodlo.stanJson();
+            if (przezTekst)
+                j = QJsonDocument::fromJson(QJsonDocument(j).toJson(QJsonDocument::Compact)).object();
+            cel.ustawStanJson(j);
+        }
+    }
+    QCOMPARE(cel.gracze().size(), zrodlo.gracze().size());
+}
+
+void BenchmarkiGier::ludoOdswiezScene()
+{
+    Gra gra;
+    BoardScene scena(&gra);
+    scena.ustawAnimacje(false);
+
+    int i = 0;
+    QBENCHMARK
+    {
+        gra.ustawStanBinarny(m_stany[i++ % m_stany.size()]);
+        scena.odswiez();
+    }
+}
+
+void BenchmarkiGier::ludoSerwerOdbiera()
+{
+    const quint16 port = wolnyPort();
+    ChinczykSerwer serwer;
+    ChinczykKlient klient;
+    QVERIFY(serwer.start(port, 4, "Host"));
+
+    bool dolaczyl = false;
+    int odebrane = 0;
+    connect(&serwer, &ChinczykSerwer::klientDolaczyl, this, [&](int){ dolaczyl = true; });
+    connect(&serwer, &ChinczykSerwer::wiadomoscOdebrana, this, [&](int, const QJsonObject&){ odebrane++; });
+
+    klient.polacz("127.0.0.1", port, "Bench");
+    QVERIFY(czekaj([&]{ return dolaczyl; }));
+
+    QJsonObject msg;
+    msg["t"] = "CH_MOVE";
+    msg["id"] = 2;
+
+    QBENCHMARK
+    {
+        odebrane = 0;
+        for (int i = 0; i < ROZMIAR_SERII; ++i)
+            klient.wyslij(msg);
+        QVERIFY(czekaj([&]{ return odebrane >= ROZMIAR_SERII; }));
+    }
+}
+
+void BenchmarkiGier::ludoKlientOdbiera()
+{
+    const quint16 port = wolnyPort();
+    ChinczykSerwer serwer;
+    ChinczykKlient klient;
+    QVERIFY(serwer.start(port, 4, "Host"));
+
+    bool dolaczyl = false;
+    int odebrane = 0;
+    connect(&serwer, &ChinczykSerwer::klientDolaczyl, this, [&](int){ dolaczyl = true; });
+
+    klient.polacz("127.0.0.1", port, "Bench");
+    QVERIFY(czekaj([&]{ return dolaczyl; }));
+    connect(&klient, &ChinczykKlient::wiadomoscOdebrana, this, [&](const QJsonObject& m){
+        if (m.value("t").toString() == "CH_STATE") odebrane++;
+    });
+
+    // Pelny stan gry - najwieksza wiadomosc wysylana w trakcie rozgrywki.
+    Gra gra;
+    gra.ustawStanBinarny(m_stany.first());
+    QJsonObject msg;
+    msg["t"] = "CH_STATE";
+    msg["state"] = gra.stanJson();
+
+    QBENCHMARK
+    {
+        odebrane = 0;
+        for (int i = 0; i < ROZMIAR_SERII; ++i)
+            serwer.wyslijDoWszystkich(msg);
+        QVERIFY(czekaj([&]{ return odebrane >= ROZMIAR_SERII; }));
+    }
+}
+
+void BenchmarkiGier::kosciKlientOdbiera()
+{
+    const quint16 port = wolnyPort();
+    SiecManager host, klient;
+    QVERIFY(host.startSerwer(port));
+
+    bool polaczony = false;
+    int odebrane = 0;
+    connect(&host, &SiecManager::log, this, [&](const QString&){ polaczony = true; });
+    connect(&klient, &SiecManager::wiadomoscOdebrana, this, [&](const QJsonObject&){ odebrane++; });
+
+    klient.startKlient("127.0.0.1", port);
+    QVERIFY(czekaj([&]{ return polaczony; }));
+
+    QJsonObject dane;
+    dane["k"] = QJsonArray{ 1, 3, 3, 5, 6 };
+    dane["b"] = QJsonArray{ false, true, true, false, false };
+    dane["r"] = 2;
+    QJsonObject msg;
+    msg["t"] = "STAN";
+    msg["d"] = dane;
+
+    QBENCHMARK
+    {
+        odebrane = 0;
+        for (int i = 0; i < ROZMIAR_SERII; ++i)
+            host.wyslijDoKlienta(msg);
+        QVERIFY(czekaj([&]{ return odebrane >= ROZMIAR_SERII; }));
+    }
+}
+
+// Qt Test nie ma wyjscia JSON - wyniki czytamy z logu XML i zapisujemy jako plaska liste.
+static bool zapiszJson(const QString& sciezkaXml, const QString& sciezkaJson)
+{
+    QFile xml(sciezkaXml);
+    if (!xml.open(QIODevice::ReadOnly))
+        return false;
+
+    QJsonArray wyniki;
+    QString funkcja;
+    QXmlStreamReader r(&xml);
+    while (!r.atEnd())
+    {
+        if (!r.readNextStartElement())
+            continue;
+
+        if (r.name() == QLatin1String("TestFunction"))
+        {
+            funkcja = r.attributes().value("name").toString();
+        }
+        else if (r.name() == QLatin1String("BenchmarkResult"))
+        {
+            const QXmlStreamAttributes a = r.attributes();
+            QJsonObject w;
+            w["name"] = funkcja;
+            w["tag"] = a.value("tag").toString();
+            w["metric"] = a.value("metric").toString();
+            w["value"] = a.value("value").toDouble();
+            w["iterations"] = a.value("iterations").toInt();
+            wyniki.append(w);
+        }
+    }
+
+    QJsonObject korzen;
+    korzen["suite"] = "benchmarks";
+    korzen["qt"] = QString(qVersion());
+    korzen["cpu"] = QSysInfo::currentCpuArchitecture();
+    korzen["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    korzen["results"] = wyniki;
+
+    QSaveFile out(sciezkaJson);
+    if (!out.open(QIODevice::WriteOnly))
+        return false;
+    out.write(QJsonDocument(korzen).toJson(QJsonDocument::Indented));
+    return out.commit();
+}
+
+int main(int argc, char** argv)
+{
+    // BoardScene potrzebuje QApplication, ale nie ekranu.
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+
+    QStringList args = app.arguments();
+    QString sciezkaJson;
+    int i = args.indexOf("--json");
+    if (i > 0 && i + 1 < args.size())
+    {
+        sciezkaJson = args[i + 1];
+        args.remove(i, 2);
+    }
+
+    QTemporaryDir tmp;
+    const QString sciezkaXml = tmp.filePath("wyniki.xml");
+    if (!sciezkaJson.isEmpty())
+        args << "-o" << "-,txt" << "-o" << (sciezkaXml + ",xml");
+
+    BenchmarkiGier benchmarki;
+    int wynik = QTest::qExec(&benchmarki, args);
+
+    if (!sciezkaJson.isEmpty() && !zapiszJson(sciezkaXml, sciezkaJson))
+    {
+        qWarning("Nie mozna zapisac %s", qPrintable(sciezkaJson));
+        return wynik ? wynik : 1;
+    }
+    return wynik;
+}
+
+#include "benchmarki.moc"
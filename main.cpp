@@ -1,50 +1,109 @@
-#include <QApplication>
-#include "launcher.h"
-#include "wisielec_window.h"
-#include "kosci_window.h"
-#include "chinczyk_window.h"
-
-int main(int argc, char *argv[])
-{
-    QApplication app(argc, argv);
-
-    Launcher launcher;
-    QMainWindow *currentGame = nullptr;
-
-    QObject::connect(&launcher, &Launcher::launchGame, [&](const GameLaunchConfig &config){
-        if(currentGame) currentGame->deleteLater();
-
-        if(config.gameType == GameType::Wisielec) {
-            auto *w = new WisielecWindow(config);
-            QObject::connect(w, &WisielecWindow::gameClosed, [&](){
-                if(currentGame) { currentGame->close(); currentGame->deleteLater(); currentGame = nullptr; }
-                launcher.show();
-            });
-            currentGame = w;
-        }
-        else if(config.gameType == GameType::Kosci) {
-            auto *k = new KosciWindow(config);
-            QObject::connect(k, &KosciWindow::gameClosed, [&](){
-                if(currentGame) { currentGame->close(); currentGame->deleteLater(); currentGame = nullptr; }
-                launcher.show();
-            });
-            currentGame = k;
-        }
-        else if(config.gameType == GameType::Chinczyk) {
-            auto *c = new ChinczykWindow(config);
-            QObject::connect(c, &ChinczykWindow::gameClosed, [&](){
-                if(currentGame) { currentGame->close(); currentGame->deleteLater(); currentGame = nullptr; }
-                launcher.show();
-            });
-            currentGame = c;
-        }
-
-        if(currentGame) {
-            launcher.hide();
-            currentGame->show();
-        }
-    });
-
-    launcher.show();
-    return app.exec();
-}
+#include <QApplication>
+#include <QMainWindow>
+#include <QMessageBox>
+#include "launcher.h"
+#include "game_modules.h"
+#include "game_metrics.h"
+#include "game_trace.h"
+#include "event_loop_watchdog.h"
+#include "frame_overlay.h"
+#include "startup_profile.h"
+#include "game_save.h"
+#include "game_stats.h"
+
+int main(int argc, char *argv[])
+{
+    // Profil zimnego startu: --profile-startup albo GRY_PROFILE_STARTUP=1; raport po pierwszej klatce.
+    StartupProfile::begin(argc, argv);
+    StartupProfile::mark("main");
+
+    QApplication app(argc, argv);
+    StartupProfile::mark("QApplication");
+
+    // Metryki hosta tylko na zadanie: --metrics-port 9464 albo GRY_METRICS_PORT=9464.
+    quint16 metricsPort = (quint16)qEnvironmentVariableIntValue("GRY_METRICS_PORT");
+    const QStringList args = app.arguments();
+    int portArg = args.indexOf("--metrics-port");
+    if(portArg > 0 && portArg + 1 < args.size()) metricsPort = (quint16)args[portArg + 1].toUInt();
+
+    // Nagrywanie przebiegu: --trace przebieg.json albo GRY_TRACE=przebieg.json; zapis przy wyjsciu.
+    QString tracePath = qEnvironmentVariable("GRY_TRACE");
+    int traceArg = args.indexOf("--trace");
+    if(traceArg > 0 && traceArg + 1 < args.size()) tracePath = args[traceArg + 1];
+    if(!tracePath.isEmpty())
+    {
+        GameTrace::start();
+        QObject::connect(&app, &QCoreApplication::aboutToQuit, [tracePath](){
+            if(!GameTrace::stop(tracePath)) qWarning("Nie mozna zapisac %s", qPrintable(tracePath));
+        });
+    }
+
+    MetricsServer metrics;
+    if(metricsPort != 0 && !metrics.start(metricsPort))
+        qWarning("Nie mozna uruchomic endpointu metryk na porcie %u", metricsPort);
+    StartupProfile::mark("argumenty, trace, metryki");
+
+    // Watchdog petli zdarzen na zadanie: --watchdog albo GRY_WATCHDOG=1. Wlacza atrybucje spanow,
+    // wiec bez niego wylaczony GAME_TRACE kosztuje jedno rozgalezienie, a launcher nie budzi timera.
+    // Nakladka z czasami klatek od startu z --overlay, w oknie F12.
+    EventLoopWatchdog watchdog;
+    if(args.contains("--watchdog") || qEnvironmentVariableIsSet("GRY_WATCHDOG"))
+    {
+        watchdog.start();
+        StartupProfile::mark("EventLoopWatchdog::start");
+    }
+    const bool overlayVisible = args.contains("--overlay") || qEnvironmentVariableIsSet("GRY_OVERLAY");
+
+    // Snapshoty pokoi hostow co 30 s: --snapshot-dir DIR albo GRY_SNAPSHOT_DIR=DIR. Obiekt zyje dluzej
+    // niz okna gier, ktore rejestruja w nim swoje pokoje.
+    GameSnapshots snapshots;
+    QString snapshotDir = qEnvironmentVariable("GRY_SNAPSHOT_DIR");
+    int snapshotArg = args.indexOf("--snapshot-dir");
+    if(snapshotArg > 0 && snapshotArg + 1 < args.size()) snapshotDir = args[snapshotArg + 1];
+    if(!snapshotDir.isEmpty()) snapshots.start(snapshotDir);
+
+    // Historia wynikow dla rankingu w launcherze; przy otwarciu czytany jest indeks, nie caly dziennik.
+    GameStats stats;
+    if(!stats.open()) qWarning("Nie mozna otworzyc statystyk w %s", qPrintable(GameStats::directory()));
+    StartupProfile::mark("GameStats::open");
+
+    // Gry sa wtyczkami w katalogu "gry": na starcie czytamy tylko metadane, biblioteka laduje sie przy "GRAJ".
+    GameModules modules;
+    Launcher launcher(modules.discover());
+    QMainWindow *currentGame = nullptr;
+
+    // Launcher wraca dopiero w kolejnej iteracji po zamknieciu okna gry (gameClosed jest kolejkowany),
+    // wiec przez chwile nie ma zadnego widocznego okna - aplikacje konczy tylko zamkniecie launchera.
+    app.setQuitOnLastWindowClosed(false);
+    QObject::connect(&launcher, &Launcher::closed, &app, &QCoreApplication::quit);
+
+    QObject::connect(&modules, &GameModules::gameClosed, [&](QMainWindow *w){
+        if(w != currentGame) return;
+        modules.releaseWindow(w);
+        currentGame = nullptr;
+        launcher.show();
+    });
+
+    QObject::connect(&launcher, &Launcher::launchGame, [&](const GameLaunchConfig &config){
+        if(currentGame) modules.releaseWindow(currentGame);
+        currentGame = nullptr;
+
+        // Kazda gra ma jedno okno w puli: pierwszy start je buduje, kolejne tylko resetuja.
+        bool created = false;
+        QString error;
+        QMainWindow *w = modules.acquireWindow(config, &created, &error);
+        if(!w) {
+            QMessageBox::critical(&launcher, "Błąd", "Nie można załadować gry: " + error);
+            return;
+        }
+
+        if(created) FrameOverlay::attach(w, overlayVisible);
+        currentGame = w;
+        launcher.hide();
+        currentGame->show();
+    });
+
+    StartupProfile::finishOnFirstFrame(&launcher);
+    launcher.show();
+    return app.exec();
+}